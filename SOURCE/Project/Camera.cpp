@@ -144,6 +144,11 @@ glm::vec3 Camera::getOrigin()
     return m_Origin;
 }
 
+float Camera::getFovAngle() const
+{
+    return m_FovAngle;
+}
+
 glm::vec3 Camera::getLightDirection() const {
     return m_LightDirection;
 }
\ No newline at end of file
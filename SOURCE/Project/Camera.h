@@ -23,6 +23,7 @@ public:
 
     float getElapsedSec();
     glm::vec3 getOrigin();
+    float getFovAngle() const;
 
     glm::vec3 getLightDirection() const;
 private:
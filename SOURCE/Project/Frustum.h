@@ -0,0 +1,33 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Clip planes of a view-projection matrix (Gribb-Hartmann), normalized with normals pointing inwards.
+struct Frustum {
+    glm::vec4 planes[6]{};
+
+    static Frustum fromViewProjection(const glm::mat4& viewProjection) {
+        glm::mat4 rows = glm::transpose(viewProjection);
+
+        Frustum frustum{};
+        frustum.planes[0] = rows[3] + rows[0];
+        frustum.planes[1] = rows[3] - rows[0];
+        frustum.planes[2] = rows[3] + rows[1];
+        frustum.planes[3] = rows[3] - rows[1];
+        frustum.planes[4] = rows[3] + rows[2];
+        frustum.planes[5] = rows[3] - rows[2];
+
+        for (glm::vec4& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
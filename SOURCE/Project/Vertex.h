@@ -4,6 +4,7 @@
 #include <array>
 #include "vulkan/vulkan.h"
 #include <functional>
+#include <cstdint>
 
 struct Vertex2D {
     glm::vec2 pos;
@@ -87,11 +88,19 @@ struct Vertex3D_PBR {
 
     struct Hash {
         size_t operator()(const Vertex3D_PBR& vertex) const {
-            size_t h1 = std::hash<float>()(vertex.pos.x) ^ std::hash<float>()(vertex.pos.y) ^ std::hash<float>()(vertex.pos.z);
-            size_t h2 = std::hash<float>()(vertex.texCoord.x) ^ std::hash<float>()(vertex.texCoord.y);
-            size_t h3 = std::hash<float>()(vertex.normal.x) ^ std::hash<float>()(vertex.normal.y) ^ std::hash<float>()(vertex.normal.z);
-            size_t h4 = std::hash<float>()(vertex.tangent.x) ^ std::hash<float>()(vertex.tangent.y) ^ std::hash<float>()(vertex.tangent.z);
-            return h1 ^ h2 ^ h3 ^ h4;
+            // Order-dependent combine; a plain XOR hashes swapped components identically.
+            size_t seed = 0;
+            const float components[] = {
+                vertex.pos.x, vertex.pos.y, vertex.pos.z,
+                vertex.color.x, vertex.color.y, vertex.color.z,
+                vertex.texCoord.x, vertex.texCoord.y,
+                vertex.normal.x, vertex.normal.y, vertex.normal.z,
+                vertex.tangent.x, vertex.tangent.y, vertex.tangent.z
+            };
+            for (float component : components) {
+                seed ^= std::hash<float>()(component) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+            return seed;
         }
     };
 
@@ -133,4 +142,50 @@ struct Vertex3D_PBR {
 
         return attributeDescriptions;
     }
-};
\ No newline at end of file
+};
+
+// GPU-side layout of Vertex3D_PBR, 20 bytes instead of 56. Positions are 16-bit UNORM within the
+// mesh bounds and are expanded with the per-mesh scale and bias from PushConstantsPBR; normal and
+// tangent are octahedral-encoded 16-bit SNORM pairs and texture coordinates are half floats. Only
+// the red channel of the vertex color is stored, in pos[3]: mesh processing bakes ambient
+// occlusion into the color, and the shader scales the ambient term by it.
+struct Vertex3D_PBR_Compact {
+    uint16_t pos[4];
+    uint16_t texCoord[2];
+    uint16_t normal[2];
+    uint16_t tangent[2];
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(Vertex3D_PBR_Compact);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+        attributeDescriptions[0].offset = offsetof(Vertex3D_PBR_Compact, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 2;
+        attributeDescriptions[1].format = VK_FORMAT_R16G16_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(Vertex3D_PBR_Compact, texCoord);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 3;
+        attributeDescriptions[2].format = VK_FORMAT_R16G16_SNORM;
+        attributeDescriptions[2].offset = offsetof(Vertex3D_PBR_Compact, normal);
+
+        attributeDescriptions[3].binding = 0;
+        attributeDescriptions[3].location = 4;
+        attributeDescriptions[3].format = VK_FORMAT_R16G16_SNORM;
+        attributeDescriptions[3].offset = offsetof(Vertex3D_PBR_Compact, tangent);
+
+        return attributeDescriptions;
+    }
+};
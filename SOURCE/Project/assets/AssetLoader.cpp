@@ -0,0 +1,224 @@
+#include "AssetLoader.h"
+#include <texture/CookedTexture.h>
+#include <io/AssetPack.h>
+#include <io/BatchFileReader.h>
+#include <filesystem>
+#include <atomic>
+#include <algorithm>
+#include <iostream>
+
+std::string AssetLoader::getReadPath(const std::string& sourcePath, const std::string& cookedPath) {
+    std::error_code error;
+    return std::filesystem::exists(cookedPath, error) ? cookedPath : sourcePath;
+}
+
+std::shared_future<std::shared_ptr<const TextureImage>> AssetLoader::loadImage(const std::string& path, TextureRole role) {
+    bool blockCompression = m_BlockCompression;
+    std::string key = path + '#' + TextureFormats::getRoleName(role) + (blockCompression ? "#bc" : "");
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_Images.find(key);
+    if (it != m_Images.end()) {
+        return it->second;
+    }
+
+    auto pStats = std::make_shared<TextureLoadStats>();
+    auto future = schedule<std::shared_ptr<const TextureImage>>(getReadPath(path, CookedTexture::getCookedPath(path, role)), [path, role, blockCompression, pStats]() -> std::shared_ptr<const TextureImage> {
+        auto image = std::make_shared<TextureImage>();
+        if (!TextureImage::loadFromFile(path, role, blockCompression, *image, pStats.get())) {
+            std::cerr << "Failed to load texture image: " << path << std::endl;
+            return nullptr;
+        }
+        return image;
+    });
+
+    m_Images.emplace(key, future);
+    m_ImageRequests.push_back({ path, role, pStats, future });
+    return future;
+}
+
+std::shared_future<std::shared_ptr<const PackedMesh>> AssetLoader::loadObj(const std::string& objPath, const MeshProcessingOptions& options) {
+    std::string key = objPath + '#' + std::to_string(options.getKey());
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_Meshes.find(key);
+    if (it != m_Meshes.end()) {
+        return it->second;
+    }
+
+    auto future = schedule<std::shared_ptr<const PackedMesh>>(getReadPath(objPath, MeshCache::getCachePath(objPath, options.getKey())), [objPath, options]() -> std::shared_ptr<const PackedMesh> {
+        CachedMesh meshData;
+        auto mesh = std::make_shared<PackedMesh>();
+        if (!MeshCache::loadObj(objPath, meshData, options, MeshGeometryAccess::UploadOnly) || !PackedMesh::pack(meshData, *mesh)) {
+            std::cerr << "Failed to load mesh: " << objPath << std::endl;
+            return nullptr;
+        }
+        return mesh;
+    });
+
+    m_Meshes.emplace(key, future);
+    return future;
+}
+
+AssetLoader::~AssetLoader() {
+    if (m_IoThread.joinable()) {
+        m_IoThread.join();
+    }
+}
+
+void AssetLoader::beginBatch() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Batching = true;
+}
+
+void AssetLoader::submitBatch() {
+    std::vector<std::string> readPaths;
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Batching = false;
+        readPaths.swap(m_BatchReadPaths);
+        tasks.swap(m_BatchTasks);
+    }
+    if (tasks.empty()) {
+        return;
+    }
+
+    auto reader = std::make_unique<BatchFileReader>(m_BufferPool);
+    if (reader->getBackend() != BatchFileReader::Backend::IoUring) {
+        for (auto& task : tasks) {
+            m_ThreadPool.enqueue(std::move(task));
+        }
+        return;
+    }
+
+    // Requests whose file is in the mounted pack or already in the page cache start right away and
+    // map it, which beats copying it through the ring. The rest wait for their file; two requests
+    // may share one.
+    const AssetPack& assetPack = AssetPack::getShared();
+    size_t residentCount = 0;
+    std::vector<std::string> batchPaths;
+    std::vector<std::vector<std::function<void()>>> batchTasks;
+    std::unordered_map<std::string, size_t> pathIndices;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const char* data = nullptr;
+        size_t size = 0;
+        if (assetPack.find(readPaths[i], data, size)) {
+            m_ThreadPool.enqueue(std::move(tasks[i]));
+            continue;
+        }
+
+        if (pathIndices.count(readPaths[i]) == 0 && BatchFileReader::isResident(readPaths[i])) {
+            ++residentCount;
+            m_ThreadPool.enqueue(std::move(tasks[i]));
+            continue;
+        }
+
+        auto inserted = pathIndices.emplace(readPaths[i], batchPaths.size());
+        if (inserted.second) {
+            batchPaths.push_back(readPaths[i]);
+            batchTasks.emplace_back();
+        }
+        batchTasks[inserted.first->second].push_back(std::move(tasks[i]));
+    }
+
+    if (batchPaths.empty()) {
+        std::cout << "All " << residentCount << " loose asset files were cached, skipped the " << BatchFileReader::getBackendName(reader->getBackend()) << " batch" << std::endl;
+        return;
+    }
+
+    if (m_IoThread.joinable()) {
+        m_IoThread.join();
+    }
+
+    ThreadPool* pThreadPool = &m_ThreadPool;
+    m_IoThread = std::thread([pThreadPool, residentCount, reader = std::move(reader), batchPaths = std::move(batchPaths), batchTasks = std::move(batchTasks)]() mutable {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        size_t byteCount = 0;
+
+        reader->readAll(batchPaths, [&](size_t pathIndex, std::shared_ptr<FileBuffer> buffer) {
+            // A file that failed to read is simply not preloaded; its requests read it themselves.
+            if (!buffer) {
+                for (auto& task : batchTasks[pathIndex]) {
+                    pThreadPool->enqueue(std::move(task));
+                }
+                return;
+            }
+
+            // Every request for the file opens the same buffer; the last one to finish releases it,
+            // whether or not it opened it.
+            byteCount += buffer->getSize();
+            const FileBuffer* pBuffer = buffer.get();
+            AssetFile::preload(batchPaths[pathIndex], std::move(buffer));
+            auto pRemaining = std::make_shared<std::atomic<size_t>>(batchTasks[pathIndex].size());
+            for (auto& task : batchTasks[pathIndex]) {
+                pThreadPool->enqueue([task = std::move(task), pRemaining, path = batchPaths[pathIndex], pBuffer]() {
+                    task();
+                    if (--*pRemaining == 0) {
+                        AssetFile::releasePreloaded(path, pBuffer);
+                    }
+                });
+            }
+        });
+
+        std::cout << "Read " << batchPaths.size() << " asset files (" << byteCount / (1024.0 * 1024.0) << " MiB) in one "
+            << BatchFileReader::getBackendName(reader->getBackend()) << " batch in "
+            << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count() << " ms, "
+            << residentCount << " cached files mapped directly" << std::endl;
+    });
+}
+
+void AssetLoader::printImageStatistics() const {
+    std::vector<ImageRequest> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const ImageRequest& request : m_ImageRequests) {
+            if (isReady(request.image)) {
+                finished.push_back(request);
+            }
+        }
+    }
+    if (finished.empty()) {
+        return;
+    }
+
+    auto getMilliseconds = [](const ImageRequest& request) { return request.pStats->decodeMilliseconds + request.pStats->encodeMilliseconds; };
+    std::sort(finished.begin(), finished.end(), [&](const ImageRequest& a, const ImageRequest& b) { return getMilliseconds(a) > getMilliseconds(b); });
+
+    double decodeMilliseconds = 0.0;
+    double encodeMilliseconds = 0.0;
+    size_t cookedCount = 0;
+    for (const ImageRequest& request : finished) {
+        decodeMilliseconds += request.pStats->decodeMilliseconds;
+        encodeMilliseconds += request.pStats->encodeMilliseconds;
+        cookedCount += request.pStats->cooked ? 1 : 0;
+    }
+    std::cout << "Images: " << finished.size() << " finished (" << cookedCount << " from cooked files), " << decodeMilliseconds << " ms reading and decoding, "
+        << encodeMilliseconds << " ms compressing, spread over " << m_ThreadPool.getThreadCount() << " worker threads" << std::endl;
+
+    for (const ImageRequest& request : finished) {
+        auto image = request.image.get();
+        std::cout << "  " << getMilliseconds(request) << " ms " << request.path << " (" << TextureFormats::getRoleName(request.role) << ", "
+            << (request.pStats->cooked ? "cooked" : "decoded");
+        if (request.pStats->encodeMilliseconds > 0.0) {
+            std::cout << " in " << request.pStats->decodeMilliseconds << " ms, compressed in " << request.pStats->encodeMilliseconds << " ms";
+        }
+        if (image) {
+            std::cout << ", " << image->width << "x" << image->height << ", " << image->getSizeInBytes() / 1024.0 << " KiB";
+        }
+        else {
+            std::cout << ", failed";
+        }
+        std::cout << ")" << std::endl;
+    }
+}
+
+void AssetLoader::clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Images.clear();
+    m_ImageRequests.clear();
+    m_Meshes.clear();
+    AssetFile::clearPreloaded();
+}
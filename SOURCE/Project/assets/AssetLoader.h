@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <threading/ThreadPool.h>
+#include <texture/TextureImage.h>
+#include <meshes/MeshCache.h>
+#include <meshes/PackedMesh.h>
+#include <io/FileBufferPool.h>
+
+// Runs file reading, image decoding, OBJ parsing and vertex packing on a thread pool and hands back futures. Only
+// the CPU side happens here; creating GPU resources from the results is left to the render thread.
+// Requests for an asset that is already loading or loaded share the same future.
+class AssetLoader {
+public:
+    explicit AssetLoader(ThreadPool& threadPool = ThreadPool::getShared()) : m_ThreadPool(threadPool) {}
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Images are block-compressed for their role unless this is turned off, e.g. because the device
+    // cannot sample BC formats. Only affects requests made afterwards.
+    void setBlockCompression(bool blockCompression) { m_BlockCompression = blockCompression; }
+    bool getBlockCompression() const { return m_BlockCompression; }
+
+    // Resolves to nullptr if the file cannot be loaded. Meshes are decoded, quantized and narrowed
+    // on the worker, so the render thread only has to copy the packed bytes into staging.
+    std::shared_future<std::shared_ptr<const TextureImage>> loadImage(const std::string& path, TextureRole role = TextureRole::Color);
+    std::shared_future<std::shared_ptr<const PackedMesh>> loadObj(const std::string& objPath, const MeshProcessingOptions& options = {});
+
+    // Requests made between beginBatch() and submitBatch() are held back. With io_uring available,
+    // submitBatch() then puts every file they need in flight at once from a separate I/O thread and
+    // starts each request on the thread pool as soon as its file has landed. Files already in the
+    // page cache skip the batch, since mapping them is faster than copying them. Without io_uring
+    // the requests just start as usual and read their files themselves.
+    void beginBatch();
+    void submitBatch();
+
+    // Prints how long each finished image took to read or decode, and to compress on first load,
+    // slowest first, so the images worth cooking or shrinking stand out.
+    void printImageStatistics() const;
+
+    // Forgets finished requests so their CPU data is freed once the caller drops its futures.
+    void clear();
+
+    template <typename Result>
+    static bool isReady(const std::shared_future<Result>& future) {
+        return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+private:
+    // Written by the worker before it resolves image, so it can be read once image is ready.
+    struct ImageRequest {
+        std::string path;
+        TextureRole role = TextureRole::Color;
+        std::shared_ptr<TextureLoadStats> pStats;
+        std::shared_future<std::shared_ptr<const TextureImage>> image;
+    };
+
+    template <typename Result, typename Function>
+    std::shared_future<Result> schedule(const std::string& readPath, Function&& function);
+
+    // The file a request will read first: the cooked artifact if there is one, else the source.
+    static std::string getReadPath(const std::string& sourcePath, const std::string& cookedPath);
+
+    ThreadPool& m_ThreadPool;
+    FileBufferPool m_BufferPool;
+    std::thread m_IoThread;
+
+    bool m_BlockCompression = true;
+    bool m_Batching = false;
+    std::vector<std::string> m_BatchReadPaths;
+    std::vector<std::function<void()>> m_BatchTasks;
+
+    mutable std::mutex m_Mutex;
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<const TextureImage>>> m_Images;
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<const PackedMesh>>> m_Meshes;
+    std::vector<ImageRequest> m_ImageRequests;
+};
+
+template <typename Result, typename Function>
+std::shared_future<Result> AssetLoader::schedule(const std::string& readPath, Function&& function) {
+    if (!m_Batching) {
+        return m_ThreadPool.enqueue(std::forward<Function>(function)).share();
+    }
+
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    m_BatchReadPaths.push_back(readPath);
+    m_BatchTasks.push_back([task]() { (*task)(); });
+    return task->get_future().share();
+}
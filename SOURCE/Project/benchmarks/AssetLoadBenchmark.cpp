@@ -0,0 +1,120 @@
+#include <cooker/AssetCooker.h>
+#include <assets/AssetLoader.h>
+#include <texture/CookedTexture.h>
+#include <io/BatchFileReader.h>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// AssetLoadBenchmark [--runs <count>] [directory]
+// Cooks the assets under directory (default "models") if needed, then loads all of them through
+// the AssetLoader the way Scene3D_PBR does: once with every request reading its own file, once
+// with the reads submitted as one batch. Each run starts with the files dropped from the page
+// cache, so the numbers include the storage device.
+namespace {
+    // Drops the file's clean pages from the page cache. Needs no privileges, unlike
+    // /proc/sys/vm/drop_caches, but only works where posix_fadvise does.
+    bool evictFromPageCache(const std::string& path) {
+#ifndef _WIN32
+        int fileDescriptor = open(path.c_str(), O_RDONLY);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+        bool evicted = posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(fileDescriptor);
+        return evicted;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    double loadAll(const std::vector<AssetCooker::CookJob>& jobs, bool batched) {
+        AssetLoader loader;
+        std::vector<std::shared_future<std::shared_ptr<const TextureImage>>> images;
+        std::vector<std::shared_future<std::shared_ptr<const PackedMesh>>> meshes;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        if (batched) {
+            loader.beginBatch();
+        }
+        for (const AssetCooker::CookJob& job : jobs) {
+            if (job.type == AssetCooker::AssetType::Mesh) {
+                meshes.push_back(loader.loadObj(job.path, job.meshOptions));
+            }
+            else {
+                images.push_back(loader.loadImage(job.path, job.textureRole));
+            }
+        }
+        if (batched) {
+            loader.submitBatch();
+        }
+
+        for (auto& image : images) {
+            image.wait();
+        }
+        for (auto& mesh : meshes) {
+            mesh.wait();
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        loader.clear();
+        return milliseconds;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string rootDirectory = "models";
+    int runCount = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--runs" && i + 1 < argc) {
+            runCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            rootDirectory = argv[i];
+        }
+    }
+
+    AssetCooker cooker(rootDirectory);
+    std::vector<AssetCooker::CookJob> jobs;
+    if (!cooker.run() || !cooker.collectJobs(jobs)) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> files;
+    for (const AssetCooker::CookJob& job : jobs) {
+        files.push_back(job.path);
+        files.push_back(job.type == AssetCooker::AssetType::Mesh ? MeshCache::getCachePath(job.path, job.meshOptions.getKey()) : CookedTexture::getCookedPath(job.path, job.textureRole));
+    }
+
+    FileBufferPool probePool;
+    BatchFileReader probeReader(probePool);
+    std::cout << "Batched reads use " << BatchFileReader::getBackendName(probeReader.getBackend()) << std::endl;
+
+    for (bool cold : { true, false }) {
+        for (bool batched : { false, true }) {
+            std::vector<double> times;
+            bool evicted = true;
+            for (int run = 0; run < runCount; ++run) {
+                if (cold) {
+                    for (const std::string& file : files) {
+                        evicted = evictFromPageCache(file) && evicted;
+                    }
+                }
+                times.push_back(loadAll(jobs, batched));
+            }
+            std::sort(times.begin(), times.end());
+
+            std::cout << (cold ? "Cold" : "Warm") << " page cache, " << (batched ? "one batch" : "per-request reads") << ": median "
+                << times[times.size() / 2] << " ms, best " << times.front() << " ms over " << runCount << " runs of " << jobs.size() << " assets"
+                << (cold && !evicted ? " (could not evict the page cache)" : "") << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+#include <loadObjFile.h>
+#include <meshes/GltfLoader.h>
+#include <meshes/TangentGenerator.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+
+// GltfBenchmark [--runs <count>] [directory or .obj files...]
+// Converts every OBJ given (default: the .obj files under "models") into a GLB in a scratch
+// directory under the system temporary directory, removed again on exit, with the vertices in one interleaved buffer view and 32-bit indices in another, then loads both
+// files the way a mesh is first built: loadObjFile plus tangent generation, and loadGlbFile, which
+// generates the tangents the GLB leaves out. Reports the median time of each and exits with a
+// failure unless both produce bit-identical vertices and indices.
+namespace {
+    constexpr uint32_t glbMagic = 0x46546C67;
+    constexpr uint32_t jsonChunkType = 0x4E4F534A;
+    constexpr uint32_t binaryChunkType = 0x004E4942;
+
+    void writeUint32(std::ofstream& file, uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool writeGlb(const std::string& path, const std::string& meshName, const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices) {
+        size_t vertexBytes = vertices.size() * sizeof(Vertex3D_PBR);
+        size_t indexBytes = indices.size() * sizeof(uint32_t);
+
+        glm::vec3 boundsMin(0.0f);
+        glm::vec3 boundsMax(0.0f);
+        if (!vertices.empty()) {
+            boundsMin = boundsMax = vertices[0].pos;
+            for (const Vertex3D_PBR& vertex : vertices) {
+                boundsMin = glm::min(boundsMin, vertex.pos);
+                boundsMax = glm::max(boundsMax, vertex.pos);
+            }
+        }
+
+        std::ostringstream json;
+        json.precision(9);
+        json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"GltfBenchmark\"},"
+            << "\"buffers\":[{\"byteLength\":" << vertexBytes + indexBytes << "}],"
+            << "\"bufferViews\":["
+            << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << vertexBytes << ",\"byteStride\":" << sizeof(Vertex3D_PBR) << ",\"target\":34962},"
+            << "{\"buffer\":0,\"byteOffset\":" << vertexBytes << ",\"byteLength\":" << indexBytes << ",\"target\":34963}],"
+            << "\"accessors\":["
+            << "{\"bufferView\":0,\"byteOffset\":" << offsetof(Vertex3D_PBR, pos) << ",\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC3\","
+            << "\"min\":[" << boundsMin.x << "," << boundsMin.y << "," << boundsMin.z << "],\"max\":[" << boundsMax.x << "," << boundsMax.y << "," << boundsMax.z << "]},"
+            << "{\"bufferView\":0,\"byteOffset\":" << offsetof(Vertex3D_PBR, normal) << ",\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC3\"},"
+            << "{\"bufferView\":0,\"byteOffset\":" << offsetof(Vertex3D_PBR, texCoord) << ",\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC2\"},"
+            << "{\"bufferView\":1,\"componentType\":5125,\"count\":" << indices.size() << ",\"type\":\"SCALAR\"}],"
+            << "\"meshes\":[{\"name\":\"" << meshName << "\",\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}]}";
+
+        // Both chunks are 4-byte aligned: JSON padded with spaces, the binary chunk with zeros.
+        std::string jsonText = json.str();
+        jsonText.append((4 - jsonText.size() % 4) % 4, ' ');
+        size_t binarySize = (vertexBytes + indexBytes + 3) & ~size_t(3);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Could not create " << path << std::endl;
+            return false;
+        }
+        writeUint32(file, glbMagic);
+        writeUint32(file, 2);
+        writeUint32(file, static_cast<uint32_t>(12 + 8 + jsonText.size() + 8 + binarySize));
+        writeUint32(file, static_cast<uint32_t>(jsonText.size()));
+        writeUint32(file, jsonChunkType);
+        file.write(jsonText.data(), jsonText.size());
+        writeUint32(file, static_cast<uint32_t>(binarySize));
+        writeUint32(file, binaryChunkType);
+        file.write(reinterpret_cast<const char*>(vertices.data()), vertexBytes);
+        file.write(reinterpret_cast<const char*>(indices.data()), indexBytes);
+        file.write("\0\0\0", binarySize - vertexBytes - indexBytes);
+        return file.good();
+    }
+
+    template <typename T>
+    bool isBitIdentical(const T& a, const T& b) {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    bool isSameGeometry(const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices,
+        const std::vector<Vertex3D_PBR>& referenceVertices, const std::vector<uint32_t>& referenceIndices) {
+        if (vertices.size() != referenceVertices.size() || indices != referenceIndices) {
+            return false;
+        }
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex3D_PBR& a = vertices[i];
+            const Vertex3D_PBR& b = referenceVertices[i];
+            if (!isBitIdentical(a.pos, b.pos) || !isBitIdentical(a.normal, b.normal) || !isBitIdentical(a.texCoord, b.texCoord) ||
+                !isBitIdentical(a.color, b.color) || !isBitIdentical(a.tangent, b.tangent)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Function>
+    double getMedianMilliseconds(int runCount, Function&& function) {
+        std::vector<double> times;
+        for (int run = 0; run < runCount; ++run) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            function();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    int runCount = 9;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--runs" && i + 1 < argc) {
+            runCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        paths.push_back("models");
+    }
+
+    std::vector<std::string> objPaths;
+    for (const std::string& path : paths) {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                    objPaths.push_back(entry.path().string());
+                }
+            }
+        }
+        else {
+            objPaths.push_back(path);
+        }
+    }
+    std::sort(objPaths.begin(), objPaths.end());
+    if (objPaths.empty()) {
+        std::cerr << "No .obj files found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::error_code error;
+    std::filesystem::path glbDirectory = std::filesystem::temp_directory_path(error) / "GltfBenchmark";
+    if (!error) {
+        std::filesystem::create_directories(glbDirectory, error);
+    }
+    if (error) {
+        std::cerr << "Could not create " << glbDirectory << ": " << error.message() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool matches = true;
+    for (size_t objIndex = 0; objIndex < objPaths.size(); ++objIndex) {
+        const std::string& objPath = objPaths[objIndex];
+        std::vector<Vertex3D_PBR> objVertices;
+        std::vector<uint32_t> objIndices;
+        if (!ObjLoader::loadObjFile(objPath, objVertices, objIndices)) {
+            std::filesystem::remove_all(glbDirectory, error);
+            return EXIT_FAILURE;
+        }
+
+        // The index keeps OBJs with the same name in different directories apart.
+        std::string meshName = std::filesystem::path(objPath).stem().string();
+        std::string glbPath = (glbDirectory / (std::to_string(objIndex) + "_" + meshName + ".glb")).string();
+        if (!writeGlb(glbPath, meshName, objVertices, objIndices)) {
+            std::filesystem::remove_all(glbDirectory, error);
+            return EXIT_FAILURE;
+        }
+        TangentGenerator::generate(objVertices, objIndices);
+
+        GltfLoader::GltfModel model;
+        GltfLoader::GltfLoadStats stats;
+        double objMilliseconds = getMedianMilliseconds(runCount, [&]() {
+            std::vector<Vertex3D_PBR> vertices;
+            std::vector<uint32_t> indices;
+            ObjLoader::loadObjFile(objPath, vertices, indices);
+            TangentGenerator::generate(vertices, indices);
+        });
+        double glbMilliseconds = getMedianMilliseconds(runCount, [&]() { GltfLoader::loadGlbFile(glbPath, model, &stats); });
+
+        bool same = model.primitives.size() == 1 && isSameGeometry(model.primitives[0].vertices, model.primitives[0].indices, objVertices, objIndices);
+        matches = matches && same;
+
+        std::cout << objPath << ": " << objVertices.size() << " vertices, " << objIndices.size() / 3 << " triangles, "
+            << std::filesystem::file_size(objPath) << " bytes as OBJ, " << stats.fileSize << " bytes as GLB" << std::endl;
+        std::cout << "  OBJ " << objMilliseconds << " ms, GLB " << glbMilliseconds << " ms (" << objMilliseconds / glbMilliseconds
+            << "x, accessor copy " << stats.copyMilliseconds << " ms), geometry " << (same ? "identical" : "differs") << std::endl;
+    }
+    std::filesystem::remove_all(glbDirectory, error);
+
+    if (!matches) {
+        std::cerr << "GLB geometry does not match the OBJ it was written from" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
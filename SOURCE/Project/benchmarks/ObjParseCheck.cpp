@@ -0,0 +1,201 @@
+#include <loadObjFile.h>
+#include <io/AssetPack.h>
+#include <filesystem>
+#include <unordered_map>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+// ObjParseCheck [directory or .obj files...]
+// Parses every OBJ given (default: the .obj files under "models") with 1, 2, 3 and one chunk per
+// pool thread, plus one chunk per 4 KiB so that small files get split too, and compares each
+// result with the serial strtof/strtol parse the loader started from. Exits with a failure unless
+// every vertex and index is bit-identical. Tangents are not compared; TangentGenerator fills them.
+namespace {
+    // The original single-threaded loader with tangent accumulation removed.
+    bool parseReference(const char* data, size_t dataSize, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices) {
+        // strtof and strtol need a terminator to stop at the end of the buffer.
+        std::string text(data, dataSize);
+        data = text.c_str();
+        const char* end = data + dataSize;
+
+        std::vector<glm::vec3> tempVertices;
+        std::vector<glm::vec2> tempTexCoords;
+        std::vector<glm::vec3> tempNormals;
+        std::unordered_map<Vertex3D_PBR, uint32_t, Vertex3D_PBR::Hash> uniqueVertices;
+
+        while (data < end) {
+            while (data < end && isspace(*data)) data++;
+
+            if (data >= end) break;
+
+            if (*data == 'v') {
+                if (data[1] == ' ') {
+                    glm::vec3 vertex;
+                    data += 2;
+                    vertex.x = strtof(data, (char**)&data);
+                    vertex.y = strtof(data, (char**)&data);
+                    vertex.z = strtof(data, (char**)&data);
+                    tempVertices.push_back(vertex);
+                }
+                else if (data[1] == 't') {
+                    glm::vec2 texCoord;
+                    data += 3;
+                    texCoord.x = strtof(data, (char**)&data);
+                    texCoord.y = 1.0f - strtof(data, (char**)&data);
+                    tempTexCoords.push_back(texCoord);
+                }
+                else if (data[1] == 'n') {
+                    glm::vec3 normal;
+                    data += 3;
+                    normal.x = strtof(data, (char**)&data);
+                    normal.y = strtof(data, (char**)&data);
+                    normal.z = strtof(data, (char**)&data);
+                    tempNormals.push_back(normal);
+                }
+            }
+            else if (*data == 'f') {
+                data++;
+
+                int vertexIndex[3], texCoordIndex[3], normalIndex[3];
+                for (int i = 0; i < 3; i++) {
+                    vertexIndex[i] = strtol(data, (char**)&data, 10) - 1;
+                    if (*data == '/') {
+                        data++;
+                        texCoordIndex[i] = strtol(data, (char**)&data, 10) - 1;
+                    }
+                    else {
+                        texCoordIndex[i] = -1;
+                    }
+                    if (*data == '/') {
+                        data++;
+                        normalIndex[i] = strtol(data, (char**)&data, 10) - 1;
+                    }
+                    else {
+                        normalIndex[i] = -1;
+                    }
+                }
+
+                for (int i = 0; i < 3; ++i) {
+                    if (vertexIndex[i] < 0 || vertexIndex[i] >= static_cast<int>(tempVertices.size()) ||
+                        texCoordIndex[i] >= static_cast<int>(tempTexCoords.size()) || normalIndex[i] >= static_cast<int>(tempNormals.size())) {
+                        std::cerr << "Index out of range in reference parse" << std::endl;
+                        return false;
+                    }
+
+                    Vertex3D_PBR vertex{};
+                    vertex.pos = tempVertices[vertexIndex[i]];
+                    vertex.normal = normalIndex[i] >= 0 ? tempNormals[normalIndex[i]] : glm::vec3(0.0f);
+                    vertex.texCoord = texCoordIndex[i] >= 0 ? tempTexCoords[texCoordIndex[i]] : glm::vec2(0.0f);
+                    vertex.color = { 1.0f, 1.0f, 1.0f };
+
+                    auto [it, inserted] = uniqueVertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+                    if (inserted) {
+                        vertices.push_back(vertex);
+                    }
+                    indices.push_back(it->second);
+                }
+            }
+
+            while (data < end && *data != '\n') {
+                data++;
+            }
+            data++;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool isBitIdentical(const T& a, const T& b) {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    // Returns the first vertex or index that differs, or -1 if none does.
+    long long findMismatch(const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices,
+        const std::vector<Vertex3D_PBR>& referenceVertices, const std::vector<uint32_t>& referenceIndices) {
+        if (vertices.size() != referenceVertices.size() || indices.size() != referenceIndices.size()) {
+            return 0;
+        }
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex3D_PBR& a = vertices[i];
+            const Vertex3D_PBR& b = referenceVertices[i];
+            if (!isBitIdentical(a.pos, b.pos) || !isBitIdentical(a.normal, b.normal) || !isBitIdentical(a.texCoord, b.texCoord) || !isBitIdentical(a.color, b.color)) {
+                return static_cast<long long>(i);
+            }
+        }
+        if (indices != referenceIndices) {
+            return static_cast<long long>(std::mismatch(indices.begin(), indices.end(), referenceIndices.begin()).first - indices.begin());
+        }
+        return -1;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths(argv + 1, argv + argc);
+    if (paths.empty()) {
+        paths.push_back("models");
+    }
+
+    std::vector<std::string> objPaths;
+    for (const std::string& path : paths) {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                    objPaths.push_back(entry.path().string());
+                }
+            }
+        }
+        else {
+            objPaths.push_back(path);
+        }
+    }
+    std::sort(objPaths.begin(), objPaths.end());
+    if (objPaths.empty()) {
+        std::cerr << "No .obj files found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool matches = true;
+    for (const std::string& objPath : objPaths) {
+        AssetFile file;
+        if (!file.open(objPath)) {
+            std::cerr << "Could not open the file: " << objPath << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::vector<Vertex3D_PBR> referenceVertices;
+        std::vector<uint32_t> referenceIndices;
+        if (!parseReference(file.getData(), file.getSize(), referenceVertices, referenceIndices)) {
+            return EXIT_FAILURE;
+        }
+        std::cout << objPath << ": " << referenceVertices.size() << " vertices, " << referenceIndices.size() << " indices" << std::endl;
+
+        size_t chunkCounts[] = { 1, 2, 3, ThreadPool::getShared().getThreadCount(), std::max<size_t>(1, file.getSize() / 4096) };
+        for (size_t chunkCount : chunkCounts) {
+            std::vector<Vertex3D_PBR> vertices;
+            std::vector<uint32_t> indices;
+            bool parsed = ObjLoader::parseObjChunks(file.getData(), file.getSize(), chunkCount, vertices, indices);
+
+            long long mismatch = parsed ? findMismatch(vertices, indices, referenceVertices, referenceIndices) : 0;
+            matches = matches && mismatch < 0;
+            std::cout << "  " << chunkCount << " chunks: ";
+            if (mismatch < 0) {
+                std::cout << "identical" << std::endl;
+            }
+            else if (!parsed) {
+                std::cout << "parse failed" << std::endl;
+            }
+            else {
+                std::cout << vertices.size() << " vertices, " << indices.size() << " indices, first difference at " << mismatch << std::endl;
+            }
+        }
+    }
+
+    if (!matches) {
+        std::cerr << "Chunked parse does not match the serial reference" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+#include <loadObjFile.h>
+#include <meshes/ObjStreamLoader.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// ObjStreamBenchmark [--size <MiB>] [--ceiling <MiB>] [file]
+// Writes a textured grid OBJ of about the given size to file (default "generated.obj") unless it
+// exists, then loads it three ways, each in a fresh process so the peak resident set size belongs
+// to that load alone: streamObjFile with a sink that drops the blocks, loadObjFile forced to
+// stream and collect the blocks, and loadObjFile parsing the whole mapped file.
+namespace {
+    // Peak resident set size of this process in MiB, or 0 where getrusage is not available.
+    double getPeakResidentMegabytes() {
+#ifndef _WIN32
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0.0;
+        }
+#ifdef __APPLE__
+        return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        return usage.ru_maxrss / 1024.0;
+#endif
+#else
+        return 0.0;
+#endif
+    }
+
+    // About 210 bytes of text per grid vertex: one v, vt and vn line and two faces.
+    bool writeGridObj(const std::string& path, size_t targetBytes) {
+        size_t side = std::max<size_t>(2, static_cast<size_t>(std::sqrt(targetBytes / 210.0)));
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Could not create " << path << std::endl;
+            return false;
+        }
+
+        char line[128];
+        for (size_t y = 0; y < side; ++y) {
+            for (size_t x = 0; x < side; ++x) {
+                float u = static_cast<float>(x) / (side - 1);
+                float v = static_cast<float>(y) / (side - 1);
+                float height = 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f);
+                file.write(line, std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0.000000 1.000000 0.000000\n", u, height, v, u, v));
+            }
+        }
+        for (size_t y = 0; y + 1 < side; ++y) {
+            for (size_t x = 0; x + 1 < side; ++x) {
+                size_t a = y * side + x + 1;
+                size_t b = a + 1;
+                size_t c = a + side;
+                size_t d = c + 1;
+                file.write(line, std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, a, c, c, c, b, b, b));
+                file.write(line, std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", b, b, b, c, c, c, d, d, d));
+            }
+        }
+        return file.good();
+    }
+
+    int runLoad(const std::string& mode, const std::string& path, const ObjLoader::ObjStreamOptions& options) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        bool loaded = false;
+
+        if (mode == "stream") {
+            loaded = ObjLoader::streamObjFile(path, options, [&](const ObjLoader::ObjMeshBlock& block) {
+                vertexCount += block.vertices.size();
+                indexCount += block.indices.size();
+                return true;
+            });
+        }
+        else {
+            ObjLoader::ObjStreamOptions loadOptions = options;
+            loadOptions.streamThreshold = mode == "load-streamed" ? 0 : UINT64_MAX;
+
+            std::vector<Vertex3D_PBR> vertices;
+            std::vector<uint32_t> indices;
+            loaded = ObjLoader::loadObjFile(path, vertices, indices, loadOptions);
+            vertexCount = vertices.size();
+            indexCount = indices.size();
+        }
+        if (!loaded) {
+            return EXIT_FAILURE;
+        }
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        std::cout << mode << ": " << vertexCount << " vertices, " << indexCount / 3 << " triangles in " << milliseconds
+            << " ms, peak RSS " << getPeakResidentMegabytes() << " MiB" << std::endl;
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string path = "generated.obj";
+    std::string childMode;
+    size_t sizeMegabytes = 256;
+    size_t ceilingMegabytes = 64;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--size" && i + 1 < argc) {
+            sizeMegabytes = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--ceiling" && i + 1 < argc) {
+            ceilingMegabytes = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--child" && i + 1 < argc) {
+            childMode = argv[++i];
+        }
+        else {
+            path = argument;
+        }
+    }
+
+    ObjLoader::ObjStreamOptions options{};
+    options.memoryCeiling = ceilingMegabytes * 1024 * 1024;
+    if (!childMode.empty()) {
+        return runLoad(childMode, path, options);
+    }
+
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        std::cout << "Writing " << path << " (about " << sizeMegabytes << " MiB)" << std::endl;
+        if (!writeGridObj(path, sizeMegabytes * 1024 * 1024)) {
+            return EXIT_FAILURE;
+        }
+    }
+    std::cout << path << ": " << std::filesystem::file_size(path, error) / (1024.0 * 1024.0) << " MiB, streaming ceiling " << ceilingMegabytes << " MiB" << std::endl;
+
+    bool succeeded = true;
+    for (const char* mode : { "stream", "load-streamed", "load" }) {
+        std::string command = "\"" + std::string(argv[0]) + "\" --ceiling " + std::to_string(ceilingMegabytes) + " --child " + mode + " \"" + path + "\"";
+        succeeded = std::system(command.c_str()) == 0 && succeeded;
+    }
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
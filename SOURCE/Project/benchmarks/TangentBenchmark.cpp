@@ -0,0 +1,145 @@
+#include <loadObjFile.h>
+#include <meshes/TangentGenerator.h>
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+// TangentBenchmark [--runs <count>] [directory or .obj files...]
+// Times TangentGenerator against a plain serial MikkTSpace evaluation on every OBJ given (default:
+// the .obj files under "models") and checks that both agree. Exits with a failure if any tangent
+// differs from the reference by more than maxAngleError.
+namespace {
+    constexpr float maxAngleError = 1e-3f;
+
+    glm::vec3 projectAndNormalize(const glm::vec3& vector, const glm::vec3& normal) {
+        glm::vec3 projected = vector - normal * glm::dot(normal, vector);
+        float length = glm::length(projected);
+        return length > std::numeric_limits<float>::min() ? projected / length : projected;
+    }
+
+    // One triangle and one corner at a time, written straight from the MikkTSpace description.
+    void generateReference(std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices) {
+        std::vector<glm::vec3> sums(vertices.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const Vertex3D_PBR* corners[3] = { &vertices[indices[i]], &vertices[indices[i + 1]], &vertices[indices[i + 2]] };
+
+            glm::vec3 edge1 = corners[1]->pos - corners[0]->pos;
+            glm::vec3 edge2 = corners[2]->pos - corners[0]->pos;
+            glm::vec2 deltaUV1 = corners[1]->texCoord - corners[0]->texCoord;
+            glm::vec2 deltaUV2 = corners[2]->texCoord - corners[0]->texCoord;
+
+            float area = deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x;
+            glm::vec3 direction = edge1 * deltaUV2.y - edge2 * deltaUV1.y;
+            float length = glm::length(direction);
+            if (!(std::abs(area) > std::numeric_limits<float>::min()) || !(length > std::numeric_limits<float>::min())) {
+                continue;
+            }
+            glm::vec3 faceTangent = direction * ((area < 0.0f ? -1.0f : 1.0f) / length);
+
+            for (int c = 0; c < 3; ++c) {
+                const glm::vec3& normal = corners[c]->normal;
+                glm::vec3 toPrevious = projectAndNormalize(corners[(c + 2) % 3]->pos - corners[c]->pos, normal);
+                glm::vec3 toNext = projectAndNormalize(corners[(c + 1) % 3]->pos - corners[c]->pos, normal);
+                float angle = std::acos(std::clamp(glm::dot(toPrevious, toNext), -1.0f, 1.0f));
+                sums[indices[i + c]] += projectAndNormalize(faceTangent, normal) * angle;
+            }
+        }
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const glm::vec3& n = vertices[i].normal;
+            glm::vec3 t = sums[i] - n * glm::dot(n, sums[i]);
+            if (glm::dot(t, t) < 1e-12f) {
+                t = glm::cross(n, std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+                if (glm::dot(t, t) < 1e-12f) {
+                    t = glm::vec3(1.0f, 0.0f, 0.0f);
+                }
+            }
+            vertices[i].tangent = glm::normalize(t);
+        }
+    }
+
+    template <typename Function>
+    double getMedianMilliseconds(int runCount, Function&& function) {
+        std::vector<double> times;
+        for (int run = 0; run < runCount; ++run) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            function();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    int runCount = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--runs" && i + 1 < argc) {
+            runCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        paths.push_back("models");
+    }
+
+    std::vector<std::string> objPaths;
+    for (const std::string& path : paths) {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                    objPaths.push_back(entry.path().string());
+                }
+            }
+        }
+        else {
+            objPaths.push_back(path);
+        }
+    }
+    std::sort(objPaths.begin(), objPaths.end());
+
+    bool matches = true;
+    for (const std::string& objPath : objPaths) {
+        std::vector<Vertex3D_PBR> vertices;
+        std::vector<uint32_t> indices;
+        if (!ObjLoader::loadObjFile(objPath, vertices, indices)) {
+            return EXIT_FAILURE;
+        }
+
+        std::vector<Vertex3D_PBR> reference = vertices;
+        double referenceMilliseconds = getMedianMilliseconds(runCount, [&]() { generateReference(reference, indices); });
+
+        TangentStats stats{};
+        double milliseconds = getMedianMilliseconds(runCount, [&]() { stats = TangentGenerator::generate(vertices, indices); });
+
+        float maxAngle = 0.0f;
+        size_t mismatchCount = 0;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            // atan2 rather than acos of the dot product, which cannot resolve angles below 3e-4.
+            float angle = std::atan2(glm::length(glm::cross(vertices[i].tangent, reference[i].tangent)), glm::dot(vertices[i].tangent, reference[i].tangent));
+            if (!(angle <= maxAngleError)) {
+                ++mismatchCount;
+            }
+            maxAngle = std::max(maxAngle, angle);
+        }
+        matches = matches && mismatchCount == 0;
+
+        std::cout << objPath << ": " << stats.triangleCount << " triangles (" << stats.degenerateTriangleCount << " degenerate), "
+            << vertices.size() << " vertices" << std::endl;
+        std::cout << "  reference " << referenceMilliseconds << " ms, TangentGenerator " << milliseconds << " ms on " << stats.threadCount
+            << " threads (" << referenceMilliseconds / milliseconds << "x, " << stats.getTrianglesPerSecondPerThread() / 1e6 << " Mtriangles/s per thread)" << std::endl;
+        std::cout << "  max difference " << maxAngle << " rad, " << mismatchCount << " vertices above " << maxAngleError << " rad" << std::endl;
+    }
+
+    if (!matches) {
+        std::cerr << "TangentGenerator does not match the reference" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
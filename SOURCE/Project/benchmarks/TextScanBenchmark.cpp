@@ -0,0 +1,167 @@
+#include <io/TextScan.h>
+#include <io/AssetPack.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+// TextScanBenchmark [--runs <count>] [.obj files...]
+// Reads every number in the given OBJ files (default: models/vehicle.obj and models/sphere.obj)
+// once with strtof/strtol, the way the loader used to, and once with TextScan, and reports the
+// throughput of each in MB/s. Exits with a failure if the two disagree on any value.
+namespace {
+    struct ScanResult {
+        size_t floatCount = 0;
+        size_t intCount = 0;
+        uint64_t checksum = 0;
+    };
+
+    void addToChecksum(ScanResult& result, uint32_t bits) {
+        result.checksum = (result.checksum ^ bits) * 0x100000001b3ull;
+    }
+
+    void addFloat(ScanResult& result, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        addToChecksum(result, bits);
+        ++result.floatCount;
+    }
+
+    void addInt(ScanResult& result, int value) {
+        addToChecksum(result, static_cast<uint32_t>(value));
+        ++result.intCount;
+    }
+
+    // The text has to be null-terminated so strtof and strtol stop at its end.
+    ScanResult scanWithStrto(const std::string& text) {
+        ScanResult result;
+        const char* data = text.c_str();
+        const char* end = data + text.size();
+        while (data < end) {
+            while (data < end && isspace(*data)) data++;
+            if (data >= end) break;
+
+            if (*data == 'v' && data + 1 < end) {
+                int count = data[1] == ' ' || data[1] == 'n' ? 3 : data[1] == 't' ? 2 : 0;
+                data += data[1] == ' ' ? 2 : 3;
+                for (int i = 0; i < count; ++i) {
+                    addFloat(result, strtof(data, (char**)&data));
+                }
+            }
+            else if (*data == 'f') {
+                data++;
+                for (int i = 0; i < 3; ++i) {
+                    addInt(result, strtol(data, (char**)&data, 10));
+                    while (*data == '/') {
+                        data++;
+                        addInt(result, strtol(data, (char**)&data, 10));
+                    }
+                }
+            }
+
+            while (data < end && *data != '\n') data++;
+            data++;
+        }
+        return result;
+    }
+
+    ScanResult scanWithTextScan(const std::string& text) {
+        ScanResult result;
+        const char* data = text.data();
+        const char* end = data + text.size();
+        while (data < end) {
+            while (data < end && TextScan::isSpace(*data)) data++;
+            if (data >= end) break;
+
+            if (*data == 'v' && data + 1 < end) {
+                int count = data[1] == ' ' || data[1] == 'n' ? 3 : data[1] == 't' ? 2 : 0;
+                data = std::min(data + (data[1] == ' ' ? 2 : 3), end);
+                for (int i = 0; i < count; ++i) {
+                    float value;
+                    data = TextScan::parseFloat(data, end, value);
+                    addFloat(result, value);
+                }
+            }
+            else if (*data == 'f') {
+                data++;
+                for (int i = 0; i < 3; ++i) {
+                    int value;
+                    data = TextScan::parseInt(data, end, value);
+                    addInt(result, value);
+                    while (data < end && *data == '/') {
+                        data = TextScan::parseInt(data + 1, end, value);
+                        addInt(result, value);
+                    }
+                }
+            }
+
+            data = TextScan::skipLine(data, end);
+        }
+        return result;
+    }
+
+    template <typename Function>
+    double getMedianMilliseconds(int runCount, Function&& function) {
+        std::vector<double> times;
+        for (int run = 0; run < runCount; ++run) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            function();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    double getMegabytesPerSecond(size_t bytes, double milliseconds) {
+        return milliseconds > 0.0 ? (bytes / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    int runCount = 9;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--runs" && i + 1 < argc) {
+            runCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        paths = { "models/vehicle.obj", "models/sphere.obj" };
+    }
+
+    bool matches = true;
+    for (const std::string& path : paths) {
+        AssetFile file;
+        if (!file.open(path)) {
+            std::cerr << "Could not open the file: " << path << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::string text(file.getData(), file.getSize());
+
+        ScanResult reference;
+        ScanResult result;
+        double referenceMilliseconds = getMedianMilliseconds(runCount, [&]() { reference = scanWithStrto(text); });
+        double milliseconds = getMedianMilliseconds(runCount, [&]() { result = scanWithTextScan(text); });
+
+        bool same = result.floatCount == reference.floatCount && result.intCount == reference.intCount && result.checksum == reference.checksum;
+        matches = matches && same;
+
+        std::cout << path << ": " << text.size() << " bytes, " << reference.floatCount << " floats, " << reference.intCount << " ints" << std::endl;
+        std::cout << "  strtof/strtol " << getMegabytesPerSecond(text.size(), referenceMilliseconds) << " MB/s, TextScan "
+            << getMegabytesPerSecond(text.size(), milliseconds) << " MB/s (" << referenceMilliseconds / milliseconds << "x), values "
+            << (same ? "identical" : "differ") << std::endl;
+    }
+
+    if (!matches) {
+        std::cerr << "TextScan does not match strtof/strtol" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include <texture/TextureContent.h>
+#include <texture/TextureImage.h>
+#include <texture/MipChain.h>
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+// TextureContentCheck [directory or image files...]
+// Decodes every image given (default: the PNG files under "models") for the role its name
+// suggests and checks the TextureContent that TextureCache shares textures by: a copy has to
+// match, while a copy with one byte changed, two words swapped, another format or a mip chain must
+// not. Lists the images whose contents match each other, which TextureCache would upload once.
+// Exits with a failure if any check does not hold.
+namespace {
+    bool expect(bool condition, const std::string& path, const char* what) {
+        if (!condition) {
+            std::cerr << path << ": " << what << std::endl;
+        }
+        return condition;
+    }
+
+    bool checkImage(const std::string& path, const TextureImage& image) {
+        TextureContent content = TextureContent::describe(image);
+        bool passed = expect(TextureContent::describe(TextureImage(image)).matches(content), path, "a copy does not match");
+
+        TextureImage changedByte = image;
+        changedByte.pixels[changedByte.pixels.size() / 2] ^= 1;
+        passed = expect(!TextureContent::describe(changedByte).matches(content), path, "a copy with one byte changed matches") && passed;
+
+        // Summing the words alone would miss this; both hashes depend on where each word is.
+        TextureImage swappedWords = image;
+        if (swappedWords.pixels.size() >= 16 && !std::equal(swappedWords.pixels.begin(), swappedWords.pixels.begin() + 8, swappedWords.pixels.begin() + 8)) {
+            std::swap_ranges(swappedWords.pixels.begin(), swappedWords.pixels.begin() + 8, swappedWords.pixels.begin() + 8);
+            TextureContent swappedContent = TextureContent::describe(swappedWords);
+            passed = expect(swappedContent.hash != content.hash && swappedContent.verificationHash != content.verificationHash, path, "swapping two words keeps a hash") && passed;
+        }
+
+        TextureImage otherFormat = image;
+        otherFormat.format = image.format == TextureFormat::R8G8B8A8Srgb ? TextureFormat::R8G8B8A8Unorm : TextureFormat::R8G8B8A8Srgb;
+        passed = expect(!TextureContent::describe(otherFormat).matches(content), path, "the same bytes in another format match") && passed;
+
+        TextureImage withMips = image;
+        MipChain::build(withMips);
+        if (withMips.getMipLevelCount() != image.getMipLevelCount()) {
+            passed = expect(!TextureContent::describe(withMips).matches(content), path, "the image with its mip chain matches") && passed;
+        }
+        return passed;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        paths.push_back(argv[i]);
+    }
+    if (paths.empty()) {
+        paths.push_back("models");
+    }
+
+    std::vector<std::string> imagePaths;
+    for (const std::string& path : paths) {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".png") {
+                    imagePaths.push_back(entry.path().generic_string());
+                }
+            }
+        }
+        else {
+            imagePaths.push_back(path);
+        }
+    }
+    std::sort(imagePaths.begin(), imagePaths.end());
+    if (imagePaths.empty()) {
+        std::cerr << "No .png files found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool passed = true;
+    std::vector<std::pair<TextureContent, std::vector<std::string>>> contents;
+    for (const std::string& imagePath : imagePaths) {
+        TextureImage image{};
+        if (!TextureImage::decodeFile(imagePath, image, TextureFormats::guessRole(imagePath))) {
+            std::cerr << "Could not decode " << imagePath << std::endl;
+            return EXIT_FAILURE;
+        }
+        passed = checkImage(imagePath, image) && passed;
+
+        TextureContent content = TextureContent::describe(image);
+        auto it = std::find_if(contents.begin(), contents.end(), [&](const auto& entry) { return entry.first.matches(content); });
+        if (it != contents.end()) {
+            it->second.push_back(imagePath);
+        }
+        else {
+            contents.push_back({ content, { imagePath } });
+        }
+    }
+
+    std::cout << imagePaths.size() << " images, " << contents.size() << " distinct contents" << std::endl;
+    for (const auto& entry : contents) {
+        if (entry.second.size() > 1) {
+            std::cout << "  shared by";
+            for (const std::string& imagePath : entry.second) {
+                std::cout << " " << imagePath;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    if (!passed) {
+        std::cerr << "TextureContent does not tell images apart as TextureCache expects" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
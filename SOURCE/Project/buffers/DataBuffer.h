@@ -16,6 +16,8 @@ public:
 
     void upload(VkDeviceSize size, void* data);
     void map(VkDeviceSize size);
+    // Null until map() has been called.
+    void* getMappedData() const { return m_pBufferData; }
     void cleanup(VkDevice device);
     VkBuffer getVkBuffer() const;
     VkDeviceMemory getVkDeviceMemory() const;
@@ -0,0 +1,88 @@
+#include "StagingBuffer.h"
+#include <algorithm>
+#include <stdexcept>
+
+void StagingBuffer::initialize(const VkPhysicalDevice& physicalDevice, const VkDevice& device) {
+    m_PhysicalDevice = physicalDevice;
+    m_Device = device;
+}
+
+void StagingBuffer::cleanup() {
+    if (m_CopyFence != VK_NULL_HANDLE) {
+        vkDestroyFence(m_Device, m_CopyFence, nullptr);
+        m_CopyFence = VK_NULL_HANDLE;
+        m_CommandPool.cleanup(m_Device);
+    }
+    releaseBuffer();
+}
+
+void StagingBuffer::releaseBuffer() {
+    if (m_pBuffer) {
+        m_pBuffer->cleanup(m_Device);
+        m_pBuffer.reset();
+    }
+    m_Size = 0;
+    m_pData = nullptr;
+}
+
+void StagingBuffer::reserve(VkDeviceSize size) {
+    if (size <= m_Size) {
+        return;
+    }
+
+    // Grow geometrically so a scene's worth of uploads settles on one allocation quickly.
+    VkDeviceSize newSize = std::max(size, m_Size * 2);
+    releaseBuffer();
+
+    m_pBuffer = std::make_unique<DataBuffer>(
+        m_PhysicalDevice,
+        m_Device,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        newSize
+    );
+    m_pBuffer->map(newSize);
+    m_Size = newSize;
+    m_pData = m_pBuffer->getMappedData();
+}
+
+void StagingBuffer::copyTo(QueueFamilyIndices queueFamInd, VkQueue graphicsQueue, const Copy* copies, size_t copyCount) {
+    // The fence is created last, so cleanup() can tell from it that the pool exists.
+    if (m_CopyFence == VK_NULL_HANDLE) {
+        m_CommandPool.initialize(m_Device, queueFamInd);
+        m_CommandBuffer = m_CommandPool.createCommandBuffer(m_Device);
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(m_Device, &fenceInfo, nullptr, &m_CopyFence) != VK_SUCCESS) {
+            m_CommandPool.cleanup(m_Device);
+            throw std::runtime_error("failed to create staging copy fence!");
+        }
+    }
+
+    m_CommandBuffer.reset();
+    m_CommandBuffer.beginRecording(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    for (size_t i = 0; i < copyCount; ++i) {
+        if (copies[i].size == 0) {
+            continue;
+        }
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = copies[i].sourceOffset;
+        copyRegion.dstOffset = 0;
+        copyRegion.size = copies[i].size;
+        vkCmdCopyBuffer(m_CommandBuffer.getVkCommandBuffer(), m_pBuffer->getVkBuffer(), copies[i].destination, 1, &copyRegion);
+    }
+
+    m_CommandBuffer.endRecording();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    m_CommandBuffer.submit(submitInfo);
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, m_CopyFence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit staging copy!");
+    }
+    vkWaitForFences(m_Device, 1, &m_CopyFence, VK_TRUE, UINT64_MAX);
+    vkResetFences(m_Device, 1, &m_CopyFence);
+}
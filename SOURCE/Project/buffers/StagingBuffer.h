@@ -0,0 +1,45 @@
+#pragma once
+#include <memory>
+#include "vulkan/vulkan.h"
+#include "DataBuffer.h"
+
+// A host-visible buffer that stays mapped for its whole life and is reused by every upload. Callers
+// write their data straight into getData() in its final GPU layout, then copyTo() copies it into
+// device-local buffers and waits, after which the memory can be written again. The command pool,
+// command buffer and fence the copies go through are created on the first copy and reused.
+class StagingBuffer
+{
+public:
+    struct Copy {
+        VkBuffer destination;
+        VkDeviceSize sourceOffset;
+        VkDeviceSize size;
+    };
+
+    StagingBuffer() = default;
+    ~StagingBuffer() = default;
+
+    void initialize(const VkPhysicalDevice& physicalDevice, const VkDevice& device);
+    void cleanup();
+
+    // Grows the buffer to at least size bytes. The contents are lost when it grows.
+    void reserve(VkDeviceSize size);
+    void* getData() const { return m_pData; }
+    VkDeviceSize getSize() const { return m_Size; }
+
+    // Records every copy into one command buffer and waits on a fence for just that submission, so
+    // other work on the queue is not waited for. Every call must use the same queue family.
+    void copyTo(QueueFamilyIndices queueFamInd, VkQueue graphicsQueue, const Copy* copies, size_t copyCount);
+
+private:
+    void releaseBuffer();
+
+    VkPhysicalDevice m_PhysicalDevice{};
+    VkDevice m_Device{};
+    CommandPool m_CommandPool{};
+    CommandBuffer m_CommandBuffer{};
+    VkFence m_CopyFence = VK_NULL_HANDLE;
+    std::unique_ptr<DataBuffer> m_pBuffer{};
+    VkDeviceSize m_Size = 0;
+    void* m_pData = nullptr;
+};
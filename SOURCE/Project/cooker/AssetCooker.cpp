@@ -0,0 +1,276 @@
+#include "AssetCooker.h"
+#include <texture/TextureImage.h>
+#include <texture/MipChain.h>
+#include <texture/CookedTexture.h>
+#include <texture/BlockEncoder.h>
+#include <io/AssetPack.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <chrono>
+#include <future>
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    const std::vector<std::string> meshExtensions = { ".obj", ".glb" };
+    const std::vector<std::string> textureExtensions = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+    bool hasExtension(const std::string& path, const std::vector<std::string>& extensions) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }
+}
+
+AssetCooker::AssetCooker(const std::string& rootDirectory, ThreadPool& threadPool)
+    : m_RootDirectory(rootDirectory), m_ThreadPool(threadPool) {
+}
+
+bool AssetCooker::loadRules() {
+    m_Presets.clear();
+
+    std::ifstream file(std::filesystem::path(m_RootDirectory) / rulesFileName);
+    if (!file.is_open()) {
+        return true;
+    }
+
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        std::istringstream stream(line);
+        std::string path;
+        std::string preset;
+        if (!(stream >> path) || path[0] == '#') {
+            continue;
+        }
+        if (hasExtension(path, textureExtensions)) {
+            stream >> preset;
+            if (preset != "default" && preset != "uncompressed" && (preset != "bc1" || TextureFormats::guessRole(path) != TextureRole::Color)) {
+                std::cerr << rulesFileName << ":" << lineNumber << ": expected '<path> default|bc1|uncompressed', bc1 only for color images" << std::endl;
+                return false;
+            }
+        }
+        else if (!(stream >> preset) || (preset != "default" && preset != "minimal")) {
+            std::cerr << rulesFileName << ":" << lineNumber << ": expected '<path> default|minimal'" << std::endl;
+            return false;
+        }
+        m_Presets[path] = preset;
+    }
+    return true;
+}
+
+std::vector<AssetCooker::CookJob> AssetCooker::findJobs() const {
+    std::vector<CookJob> jobs;
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(m_RootDirectory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+        if (!it->is_regular_file()) {
+            continue;
+        }
+
+        CookJob job{};
+        job.path = it->path().generic_string();
+        auto preset = m_Presets.find(std::filesystem::relative(it->path(), m_RootDirectory).generic_string());
+        std::string presetName = preset != m_Presets.end() ? preset->second : "default";
+        if (hasExtension(job.path, meshExtensions)) {
+            job.type = AssetType::Mesh;
+            if (presetName == "minimal") {
+                job.meshOptions = MeshProcessingOptions::createMinimal();
+            }
+        }
+        else if (hasExtension(job.path, textureExtensions)) {
+            job.type = AssetType::Texture;
+            job.textureRole = TextureFormats::guessRole(job.path);
+            if (presetName == "bc1") {
+                job.textureFormat = TextureFormat::Bc1RgbSrgb;
+            }
+            else if (presetName == "uncompressed") {
+                job.textureFormat = TextureFormats::getUncompressedFormat(job.textureRole);
+            }
+            else {
+                job.textureFormat = TextureFormats::getCompressedFormat(job.textureRole);
+            }
+        }
+        else {
+            continue;
+        }
+        jobs.push_back(std::move(job));
+    }
+
+    // Largest first, so one big asset does not start last and hold up the whole run.
+    std::sort(jobs.begin(), jobs.end(), [](const CookJob& a, const CookJob& b) {
+        std::error_code sizeError;
+        return std::filesystem::file_size(a.path, sizeError) > std::filesystem::file_size(b.path, sizeError);
+    });
+    return jobs;
+}
+
+bool AssetCooker::collectJobs(std::vector<CookJob>& jobs) {
+    if (!loadRules()) {
+        return false;
+    }
+    jobs = findJobs();
+    return true;
+}
+
+AssetCooker::CookResult AssetCooker::cook(const CookJob& job) const {
+    return job.type == AssetType::Mesh ? cookMesh(job) : cookTexture(job);
+}
+
+AssetCooker::CookResult AssetCooker::cookMesh(const CookJob& job) const {
+    if (hasExtension(job.path, { ".glb" })) {
+        return cookGlb(job);
+    }
+
+    CachedMesh meshData;
+    if (!m_ForceRebuild && MeshCache::openCache(job.path, job.meshOptions.getKey(), meshData, MeshGeometryAccess::UploadOnly)) {
+        return CookResult::UpToDate;
+    }
+
+    std::error_code error;
+    std::filesystem::remove(MeshCache::getCachePath(job.path, job.meshOptions.getKey()), error);
+
+    // loadObj falls back to the parsed data if the cache cannot be written, so check the file.
+    if (!MeshCache::loadObj(job.path, meshData, job.meshOptions, MeshGeometryAccess::UploadOnly) || !MeshCache::openCache(job.path, job.meshOptions.getKey(), meshData, MeshGeometryAccess::UploadOnly)) {
+        return CookResult::Failed;
+    }
+    return CookResult::Cooked;
+}
+
+AssetCooker::CookResult AssetCooker::cookGlb(const CookJob& job) const {
+    std::vector<CachedMesh> primitives;
+    if (!m_ForceRebuild && MeshCache::openGlbCache(job.path, job.meshOptions.getKey(), primitives, MeshGeometryAccess::UploadOnly)) {
+        return CookResult::UpToDate;
+    }
+
+    // Without the first primitive's cache, loadGlb rebuilds every primitive.
+    std::error_code error;
+    std::filesystem::remove(MeshCache::getPrimitiveCachePath(job.path, 0, job.meshOptions.getKey()), error);
+
+    if (!MeshCache::loadGlb(job.path, primitives, job.meshOptions, MeshGeometryAccess::UploadOnly) || !MeshCache::openGlbCache(job.path, job.meshOptions.getKey(), primitives, MeshGeometryAccess::UploadOnly)) {
+        return CookResult::Failed;
+    }
+    return CookResult::Cooked;
+}
+
+AssetCooker::CookResult AssetCooker::cookTexture(const CookJob& job) const {
+    // Which of the two a source gets depends on its pixels, so either one is up to date.
+    TextureFormat colorFormat = TextureFormats::getColorFallback(job.textureFormat);
+    if (!m_ForceRebuild && (CookedTexture::isUpToDate(job.path, job.textureRole, job.textureFormat) ||
+        (colorFormat != job.textureFormat && CookedTexture::isUpToDate(job.path, job.textureRole, colorFormat)))) {
+        return CookResult::UpToDate;
+    }
+
+    TextureImage image{};
+    if (!TextureImage::decodeFile(job.path, image, job.textureRole)) {
+        return CookResult::Failed;
+    }
+    TextureFormat format = colorFormat != job.textureFormat && !image.isGrayscale() ? colorFormat : job.textureFormat;
+    MipChain::build(image);
+
+    TextureImage encodedImage{};
+    BlockEncoder::encode(image, format, encodedImage);
+    return CookedTexture::write(job.path, job.textureRole, encodedImage) ? CookResult::Cooked : CookResult::Failed;
+}
+
+bool AssetCooker::writePack(const std::vector<CookJob>& jobs) const {
+    std::filesystem::path rootPath = std::filesystem::absolute(m_RootDirectory).lexically_normal();
+    if (!rootPath.has_filename()) {
+        rootPath = rootPath.parent_path();
+    }
+
+    std::vector<std::string> filePaths;
+    filePaths.reserve(jobs.size());
+    for (const CookJob& job : jobs) {
+        if (job.type == AssetType::Texture) {
+            filePaths.push_back(CookedTexture::getCookedPath(job.path, job.textureRole));
+        }
+        else if (hasExtension(job.path, { ".glb" })) {
+            std::vector<CachedMesh> primitives;
+            if (!MeshCache::openGlbCache(job.path, job.meshOptions.getKey(), primitives, MeshGeometryAccess::UploadOnly)) {
+                std::cerr << "Mesh cache of " << job.path << " changed while packing" << std::endl;
+                return false;
+            }
+            for (size_t i = 0; i < primitives.size(); ++i) {
+                filePaths.push_back(MeshCache::getPrimitiveCachePath(job.path, i, job.meshOptions.getKey()));
+            }
+        }
+        else {
+            filePaths.push_back(MeshCache::getCachePath(job.path, job.meshOptions.getKey()));
+        }
+    }
+
+    std::vector<AssetPackEntry> entries;
+    entries.reserve(filePaths.size());
+    for (const std::string& filePath : filePaths) {
+        AssetPackEntry entry{};
+        entry.filePath = filePath;
+        entry.name = std::filesystem::absolute(entry.filePath).lexically_normal().lexically_relative(rootPath.parent_path()).generic_string();
+        entries.push_back(std::move(entry));
+    }
+
+    // Sorted by name, so a pack built from the same artifacts is byte for byte the same.
+    std::sort(entries.begin(), entries.end(), [](const AssetPackEntry& a, const AssetPackEntry& b) { return a.name < b.name; });
+
+    if (!AssetPack::write(m_PackPath, entries)) {
+        std::cerr << "Failed to write asset pack " << m_PackPath << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::cout << "Packed " << entries.size() << " assets into " << m_PackPath << " (" << std::filesystem::file_size(m_PackPath, error) / (1024.0 * 1024.0) << " MiB)" << std::endl;
+    return true;
+}
+
+bool AssetCooker::run() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    if (!std::filesystem::is_directory(m_RootDirectory)) {
+        std::cerr << "Asset directory not found: " << m_RootDirectory << std::endl;
+        return false;
+    }
+    std::vector<CookJob> jobs;
+    if (!collectJobs(jobs)) {
+        return false;
+    }
+    std::vector<std::future<CookResult>> results;
+    results.reserve(jobs.size());
+
+    std::mutex logMutex;
+    for (const CookJob& job : jobs) {
+        results.push_back(m_ThreadPool.enqueue([this, &job, &logMutex]() {
+            auto jobStartTime = std::chrono::high_resolution_clock::now();
+            CookResult result = cook(job);
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - jobStartTime).count();
+
+            std::lock_guard<std::mutex> lock(logMutex);
+            if (result == CookResult::Cooked) {
+                std::cout << "Cooked " << job.path << " (" << milliseconds << " ms)" << std::endl;
+            }
+            else if (result == CookResult::Failed) {
+                std::cerr << "Failed to cook " << job.path << std::endl;
+            }
+            return result;
+        }));
+    }
+
+    size_t cookedCount = 0;
+    size_t upToDateCount = 0;
+    size_t failedCount = 0;
+    for (auto& result : results) {
+        switch (result.get()) {
+        case CookResult::Cooked: ++cookedCount; break;
+        case CookResult::UpToDate: ++upToDateCount; break;
+        case CookResult::Failed: ++failedCount; break;
+        }
+    }
+
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Cooked " << cookedCount << " assets, " << upToDateCount << " up to date, " << failedCount << " failed in "
+        << milliseconds << " ms on " << m_ThreadPool.getThreadCount() << " worker threads" << std::endl;
+
+    if (failedCount != 0) {
+        return false;
+    }
+    return m_PackPath.empty() || writePack(jobs);
+}
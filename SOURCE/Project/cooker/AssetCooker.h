@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <threading/ThreadPool.h>
+#include <meshes/MeshCache.h>
+#include <texture/TextureFormat.h>
+
+// Converts every OBJ, GLB and image under a directory into the artifacts the runtime loads
+// directly: a .meshbin per OBJ or GLB primitive with optimized vertices, LODs and meshlets, and a
+// KTX2 file with a full, block-compressed mip chain per image. Images are cooked for the role
+// their file name suggests (see TextureFormats::guessRole); roles the runtime needs beyond that
+// are compressed and cached on first load. Both record a hash of their source, so a run only rebuilds assets whose source
+// changed. Assets are cooked in parallel on the thread pool.
+class AssetCooker {
+public:
+    enum class AssetType { Mesh, Texture };
+
+    struct CookJob {
+        std::string path;
+        AssetType type = AssetType::Mesh;
+        MeshProcessingOptions meshOptions{};
+        TextureRole textureRole = TextureRole::Color;
+        TextureFormat textureFormat = TextureFormat::Bc7Srgb;
+    };
+
+    explicit AssetCooker(const std::string& rootDirectory, ThreadPool& threadPool = ThreadPool::getShared());
+
+    // Rebuilds every asset, even if its artifact is up to date.
+    void setForceRebuild(bool forceRebuild) { m_ForceRebuild = forceRebuild; }
+
+    // After cooking, bundles every artifact into one AssetPack at packPath. Assets are named by
+    // their path starting at the root directory's name, e.g. "models/vehicle/vehicle_diffuse.png.ktx2",
+    // which is how the app refers to them.
+    void setPackPath(const std::string& packPath) { m_PackPath = packPath; }
+
+    // Returns false if any asset failed to cook.
+    bool run();
+
+    // Lists the assets run() would cook, with the options each is cooked with. Returns false if
+    // cook.txt is malformed.
+    bool collectJobs(std::vector<CookJob>& jobs);
+
+    // Per-file settings are read from cook.txt in the root directory, one "<relative path> <preset>"
+    // per line. Mesh presets are "default" and "minimal" (MeshProcessingOptions::createMinimal());
+    // they have to match the options the scene loads the mesh with. Image presets are "default"
+    // (the role's BC format), "bc1" (half the size of BC7 for color images without alpha) and
+    // "uncompressed".
+    static constexpr const char* rulesFileName = "cook.txt";
+
+private:
+    enum class CookResult { UpToDate, Cooked, Failed };
+
+    bool loadRules();
+    std::vector<CookJob> findJobs() const;
+    CookResult cook(const CookJob& job) const;
+    CookResult cookMesh(const CookJob& job) const;
+    CookResult cookGlb(const CookJob& job) const;
+    CookResult cookTexture(const CookJob& job) const;
+    bool writePack(const std::vector<CookJob>& jobs) const;
+
+    std::string m_RootDirectory;
+    ThreadPool& m_ThreadPool;
+    std::string m_PackPath;
+    bool m_ForceRebuild = false;
+    std::unordered_map<std::string, std::string> m_Presets;
+};
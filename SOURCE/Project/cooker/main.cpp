@@ -0,0 +1,30 @@
+#include "AssetCooker.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+// AssetCooker [--force] [--pack <file>] [directory]
+// Cooks the assets under directory (default "models") in place, next to their sources, and
+// optionally bundles the results into one asset pack.
+int main(int argc, char** argv) {
+    std::string rootDirectory = "models";
+    std::string packPath;
+    bool forceRebuild = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--force") == 0) {
+            forceRebuild = true;
+        }
+        else if (std::strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            packPath = argv[++i];
+        }
+        else {
+            rootDirectory = argv[i];
+        }
+    }
+
+    AssetCooker cooker(rootDirectory);
+    cooker.setForceRebuild(forceRebuild);
+    cooker.setPackPath(packPath);
+    return cooker.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
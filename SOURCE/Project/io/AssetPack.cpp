@@ -0,0 +1,267 @@
+#include "AssetPack.h"
+#include <io/ContentHash.h>
+#include <io/TemporaryFile.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    constexpr char assetPackMagic[8] = { 'A', 'S', 'S', 'E', 'T', 'P', 'A', 'K' };
+
+    uint64_t alignOffset(uint64_t offset, uint64_t alignment) {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    struct PreloadedFiles {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const FileBuffer>> buffers;
+    };
+
+    PreloadedFiles& getPreloadedFiles() {
+        static PreloadedFiles preloadedFiles;
+        return preloadedFiles;
+    }
+}
+
+std::string AssetPack::normalizeName(const std::string& name) {
+    std::string normalized = name;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0) {
+        normalized.erase(0, 2);
+    }
+    return normalized;
+}
+
+AssetPack& AssetPack::getShared() {
+    static AssetPack sharedPack;
+    return sharedPack;
+}
+
+bool AssetPack::open(const std::string& packPath) {
+    close();
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(packPath, false) || file->getSize() < sizeof(AssetPackHeader)) {
+        return false;
+    }
+
+    AssetPackHeader header{};
+    std::memcpy(&header, file->getData(), sizeof(header));
+    if (std::memcmp(header.magic, assetPackMagic, sizeof(assetPackMagic)) != 0 || header.version != version ||
+        header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0 ||
+        header.slotOffset > file->getSize() || header.slotCount > (file->getSize() - header.slotOffset) / sizeof(AssetPackSlot) ||
+        header.nameOffset > file->getSize() || header.nameSize > file->getSize() - header.nameOffset) {
+        return false;
+    }
+
+    const AssetPackSlot* slots = reinterpret_cast<const AssetPackSlot*>(file->getData() + header.slotOffset);
+    for (uint64_t i = 0; i < header.slotCount; ++i) {
+        if (slots[i].nameLength != 0 && (static_cast<uint64_t>(slots[i].nameOffset) + slots[i].nameLength > header.nameSize ||
+            slots[i].dataOffset > file->getSize() || slots[i].dataSize > file->getSize() - slots[i].dataOffset)) {
+            return false;
+        }
+    }
+
+    m_pSlots = slots;
+    m_pNames = file->getData() + header.nameOffset;
+    m_SlotCount = header.slotCount;
+    m_EntryCount = header.entryCount;
+    m_pFile = std::move(file);
+    return true;
+}
+
+void AssetPack::close() {
+    m_pFile.reset();
+    m_pSlots = nullptr;
+    m_pNames = nullptr;
+    m_SlotCount = 0;
+    m_EntryCount = 0;
+}
+
+bool AssetPack::find(const std::string& name, const char*& data, size_t& size) const {
+    if (!m_pFile) {
+        return false;
+    }
+
+    std::string normalized = normalizeName(name);
+    uint64_t hash = ContentHash::hashString(normalized);
+
+    for (uint64_t probe = 0, slotIndex = hash & (m_SlotCount - 1); probe < m_SlotCount; ++probe, slotIndex = (slotIndex + 1) & (m_SlotCount - 1)) {
+        const AssetPackSlot& slot = m_pSlots[slotIndex];
+        if (slot.nameLength == 0) {
+            return false;
+        }
+        if (slot.nameHash == hash && slot.nameLength == normalized.size() && std::memcmp(m_pNames + slot.nameOffset, normalized.data(), normalized.size()) == 0) {
+            data = m_pFile->getData() + slot.dataOffset;
+            size = static_cast<size_t>(slot.dataSize);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetPack::write(const std::string& packPath, const std::vector<AssetPackEntry>& entries) {
+    // At most half full, so probe sequences stay short.
+    uint64_t slotCount = 1;
+    while (slotCount < entries.size() * 2) {
+        slotCount *= 2;
+    }
+
+    std::vector<AssetPackSlot> slots(slotCount);
+    std::string names;
+    std::vector<uint64_t> entrySizes(entries.size());
+
+    AssetPackHeader header{};
+    std::memcpy(header.magic, assetPackMagic, sizeof(assetPackMagic));
+    header.version = version;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.slotCount = slotCount;
+    header.slotOffset = alignOffset(sizeof(AssetPackHeader), packAlignment);
+
+    std::vector<std::string> normalizedNames(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        normalizedNames[i] = normalizeName(entries[i].name);
+        std::error_code error;
+        entrySizes[i] = std::filesystem::file_size(entries[i].filePath, error);
+        if (error || normalizedNames[i].empty()) {
+            return false;
+        }
+        names += normalizedNames[i];
+    }
+    header.nameOffset = header.slotOffset + slotCount * sizeof(AssetPackSlot);
+    header.nameSize = names.size();
+
+    uint64_t dataOffset = alignOffset(header.nameOffset + header.nameSize, packAlignment);
+    std::vector<uint64_t> entryOffsets(entries.size());
+    uint32_t nameOffset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        entryOffsets[i] = dataOffset;
+        dataOffset = alignOffset(dataOffset + entrySizes[i], packAlignment);
+
+        uint64_t hash = ContentHash::hashString(normalizedNames[i]);
+        uint64_t slotIndex = hash & (slotCount - 1);
+        while (slots[slotIndex].nameLength != 0) {
+            const AssetPackSlot& slot = slots[slotIndex];
+            if (slot.nameHash == hash && names.compare(slot.nameOffset, slot.nameLength, normalizedNames[i]) == 0) {
+                return false;
+            }
+            slotIndex = (slotIndex + 1) & (slotCount - 1);
+        }
+        slots[slotIndex] = { hash, nameOffset, static_cast<uint32_t>(normalizedNames[i].size()), entryOffsets[i], entrySizes[i] };
+        nameOffset += static_cast<uint32_t>(normalizedNames[i].size());
+    }
+
+    std::string temporaryPath = TemporaryFile::getPath(packPath);
+    bool written = true;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        const char padding[packAlignment]{};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding, header.slotOffset - sizeof(header));
+        file.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(AssetPackSlot));
+        file.write(names.data(), names.size());
+
+        uint64_t position = header.nameOffset + header.nameSize;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            file.write(padding, entryOffsets[i] - position);
+
+            MappedFile source;
+            if (!source.open(entries[i].filePath) || source.getSize() != entrySizes[i]) {
+                written = false;
+                break;
+            }
+            file.write(source.getData(), source.getSize());
+            position = entryOffsets[i] + entrySizes[i];
+        }
+
+        file.close();
+        written = written && file.good();
+    }
+    return TemporaryFile::commit(temporaryPath, packPath, written);
+}
+
+AssetFile::AssetFile(AssetFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+AssetFile& AssetFile::operator=(AssetFile&& other) noexcept {
+    if (this != &other) {
+        m_pPack = std::move(other.m_pPack);
+        m_pBuffer = std::move(other.m_pBuffer);
+        m_File = std::move(other.m_File);
+        m_pData = std::exchange(other.m_pData, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_IsOpen = std::exchange(other.m_IsOpen, false);
+    }
+    return *this;
+}
+
+bool AssetFile::open(const std::string& name, bool sequentialAccess) {
+    close();
+
+    const AssetPack& pack = AssetPack::getShared();
+    if (pack.find(name, m_pData, m_Size)) {
+        m_pPack = pack.getMapping();
+        m_IsOpen = true;
+        return true;
+    }
+
+    {
+        PreloadedFiles& preloadedFiles = getPreloadedFiles();
+        std::lock_guard<std::mutex> lock(preloadedFiles.mutex);
+        auto it = preloadedFiles.buffers.find(AssetPack::normalizeName(name));
+        if (it != preloadedFiles.buffers.end()) {
+            m_pBuffer = it->second;
+            m_pData = m_pBuffer->getData();
+            m_Size = m_pBuffer->getSize();
+            m_IsOpen = true;
+            return true;
+        }
+    }
+
+    if (!m_File.open(name, sequentialAccess)) {
+        return false;
+    }
+    m_pData = m_File.getData();
+    m_Size = m_File.getSize();
+    m_IsOpen = true;
+    return true;
+}
+
+void AssetFile::preload(const std::string& name, std::shared_ptr<const FileBuffer> buffer) {
+    PreloadedFiles& preloadedFiles = getPreloadedFiles();
+    std::lock_guard<std::mutex> lock(preloadedFiles.mutex);
+    preloadedFiles.buffers[AssetPack::normalizeName(name)] = std::move(buffer);
+}
+
+void AssetFile::releasePreloaded(const std::string& name, const FileBuffer* pBuffer) {
+    PreloadedFiles& preloadedFiles = getPreloadedFiles();
+    std::lock_guard<std::mutex> lock(preloadedFiles.mutex);
+    auto it = preloadedFiles.buffers.find(AssetPack::normalizeName(name));
+    if (it != preloadedFiles.buffers.end() && it->second.get() == pBuffer) {
+        preloadedFiles.buffers.erase(it);
+    }
+}
+
+void AssetFile::clearPreloaded() {
+    PreloadedFiles& preloadedFiles = getPreloadedFiles();
+    std::lock_guard<std::mutex> lock(preloadedFiles.mutex);
+    preloadedFiles.buffers.clear();
+}
+
+void AssetFile::close() {
+    m_pPack.reset();
+    m_pBuffer.reset();
+    m_File.close();
+    m_pData = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <io/MappedFile.h>
+#include <io/FileBufferPool.h>
+
+struct AssetPackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t slotCount;
+    uint64_t slotOffset;
+    uint64_t nameOffset;
+    uint64_t nameSize;
+};
+
+// One slot of the open-addressed table of contents. Empty slots have nameLength 0.
+struct AssetPackSlot {
+    uint64_t nameHash;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+struct AssetPackEntry {
+    std::string name;
+    std::string filePath;
+};
+
+// A single file holding many assets: a header, a hash table of contents keyed by asset name,
+// the names, and the asset bytes aligned to packAlignment. The whole pack is mapped once and
+// assets are handed out as spans into that mapping, so looking one up costs no system calls.
+class AssetPack {
+public:
+    static constexpr uint32_t version = 1;
+    static constexpr uint64_t packAlignment = 64;
+
+    // Replaces the currently mapped pack. Assets already opened from the old one stay valid.
+    bool open(const std::string& packPath);
+    void close();
+
+    bool isOpen() const { return m_pFile != nullptr; }
+    uint32_t getEntryCount() const { return m_EntryCount; }
+    size_t getSize() const { return m_pFile ? m_pFile->getSize() : 0; }
+
+    // Returns false if the pack has no asset of that name.
+    bool find(const std::string& name, const char*& data, size_t& size) const;
+    const std::shared_ptr<const MappedFile>& getMapping() const { return m_pFile; }
+
+    // Writes entries to packPath, named by entry.name and read from entry.filePath.
+    static bool write(const std::string& packPath, const std::vector<AssetPackEntry>& entries);
+
+    // Asset names use forward slashes and no leading "./", so "models\\a.png" and "./models/a.png"
+    // find the same asset.
+    static std::string normalizeName(const std::string& name);
+
+    // The pack AssetFile looks in. Open it before any loading thread starts.
+    static AssetPack& getShared();
+
+private:
+    std::shared_ptr<const MappedFile> m_pFile;
+    const AssetPackSlot* m_pSlots = nullptr;
+    const char* m_pNames = nullptr;
+    uint64_t m_SlotCount = 0;
+    uint32_t m_EntryCount = 0;
+};
+
+// Read-only bytes of one asset: a span into the shared pack, a buffer handed over with preload(),
+// or else a mapping of the loose file. Keeps the pack mapping or buffer alive while open.
+class AssetFile {
+public:
+    AssetFile() = default;
+    AssetFile(AssetFile&& other) noexcept;
+    AssetFile& operator=(AssetFile&& other) noexcept;
+
+    bool open(const std::string& name, bool sequentialAccess = true);
+    void close();
+
+    // Serves name from buffer on every open instead of reading the disk, until it is released.
+    // AssetLoader uses this to pass on files it read ahead in one batch, and releases each buffer
+    // once the last request waiting for it has finished. Open files keep their buffer alive.
+    static void preload(const std::string& name, std::shared_ptr<const FileBuffer> buffer);
+    // Only drops the buffer for name if it is still pBuffer, so a newer preload survives.
+    static void releasePreloaded(const std::string& name, const FileBuffer* pBuffer);
+    static void clearPreloaded();
+
+    bool isOpen() const { return m_IsOpen; }
+    bool isPacked() const { return m_pPack != nullptr; }
+    bool isPreloaded() const { return m_pBuffer != nullptr; }
+    const char* getData() const { return m_pData; }
+    size_t getSize() const { return m_Size; }
+
+private:
+    std::shared_ptr<const MappedFile> m_pPack;
+    std::shared_ptr<const FileBuffer> m_pBuffer;
+    MappedFile m_File;
+    const char* m_pData = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+};
@@ -0,0 +1,340 @@
+#include "BatchFileReader.h"
+#include <fstream>
+#include <algorithm>
+
+#ifdef ASSET_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+// Minimal ring setup through the raw system calls, so the build does not depend on liburing.
+struct BatchFileReader::IoUring {
+    int ringFd = -1;
+    void* pSqRing = MAP_FAILED;
+    void* pCqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* pSqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* pSqTail = nullptr;
+    unsigned* pSqMask = nullptr;
+    unsigned* pSqArray = nullptr;
+    unsigned* pCqHead = nullptr;
+    unsigned* pCqTail = nullptr;
+    unsigned* pCqMask = nullptr;
+    io_uring_cqe* pCqes = nullptr;
+    unsigned entryCount = 0;
+
+    bool initialize(unsigned queueDepth) {
+        io_uring_params params{};
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+        if (ringFd < 0) {
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMapping) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        pSqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (pSqRing == MAP_FAILED) {
+            return false;
+        }
+        if (singleMapping) {
+            pCqRing = pSqRing;
+        }
+        else {
+            pCqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+            if (pCqRing == MAP_FAILED) {
+                return false;
+            }
+        }
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        pSqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (pSqes == MAP_FAILED) {
+            return false;
+        }
+
+        char* sqRing = static_cast<char*>(pSqRing);
+        char* cqRing = static_cast<char*>(pCqRing);
+        pSqTail = reinterpret_cast<unsigned*>(sqRing + params.sq_off.tail);
+        pSqMask = reinterpret_cast<unsigned*>(sqRing + params.sq_off.ring_mask);
+        pSqArray = reinterpret_cast<unsigned*>(sqRing + params.sq_off.array);
+        pCqHead = reinterpret_cast<unsigned*>(cqRing + params.cq_off.head);
+        pCqTail = reinterpret_cast<unsigned*>(cqRing + params.cq_off.tail);
+        pCqMask = reinterpret_cast<unsigned*>(cqRing + params.cq_off.ring_mask);
+        pCqes = reinterpret_cast<io_uring_cqe*>(cqRing + params.cq_off.cqes);
+        entryCount = params.sq_entries;
+        return true;
+    }
+
+    ~IoUring() {
+        if (pSqes != MAP_FAILED) {
+            munmap(pSqes, sqesSize);
+        }
+        if (pCqRing != MAP_FAILED && pCqRing != pSqRing) {
+            munmap(pCqRing, cqRingSize);
+        }
+        if (pSqRing != MAP_FAILED) {
+            munmap(pSqRing, sqRingSize);
+        }
+        if (ringFd >= 0) {
+            close(ringFd);
+        }
+    }
+
+    void queueRead(int fileDescriptor, char* destination, unsigned size, uint64_t offset, uint64_t userData) {
+        unsigned tail = *pSqTail;
+        unsigned index = tail & *pSqMask;
+
+        io_uring_sqe& sqe = pSqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fileDescriptor;
+        sqe.addr = reinterpret_cast<uint64_t>(destination);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.user_data = userData;
+
+        pSqArray[index] = index;
+        __atomic_store_n(pSqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Submits up to submitCount queued reads and waits until at least one read has completed.
+    // Returns the number submitted, or -1 on error.
+    long submitAndWait(unsigned submitCount) {
+        while (true) {
+            long result = syscall(__NR_io_uring_enter, ringFd, submitCount, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0 || errno != EINTR) {
+                return result;
+            }
+        }
+    }
+
+    template <typename Function>
+    void forEachCompletion(Function&& function) {
+        unsigned head = *pCqHead;
+        unsigned tail = __atomic_load_n(pCqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = pCqes[head & *pCqMask];
+            function(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(pCqHead, head, __ATOMIC_RELEASE);
+    }
+};
+#endif
+
+BatchFileReader::BatchFileReader(FileBufferPool& bufferPool, bool allowIoUring, unsigned queueDepth)
+    : m_BufferPool(bufferPool) {
+#ifdef ASSET_IO_URING
+    if (allowIoUring) {
+        auto ring = std::make_unique<IoUring>();
+        if (ring->initialize(queueDepth)) {
+            m_pRing = std::move(ring);
+            m_Backend = Backend::IoUring;
+        }
+    }
+#else
+    (void)allowIoUring;
+    (void)queueDepth;
+#endif
+}
+
+BatchFileReader::~BatchFileReader() = default;
+
+const char* BatchFileReader::getBackendName(Backend backend) {
+    return backend == Backend::IoUring ? "io_uring" : "blocking reads";
+}
+
+bool BatchFileReader::isResident(const std::string& path) {
+#ifdef ASSET_IO_URING
+    int fileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    bool resident = false;
+    struct stat status {};
+    if (fstat(fileDescriptor, &status) == 0) {
+        size_t size = static_cast<size_t>(status.st_size);
+        resident = size == 0;
+        void* pMapping = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0) : MAP_FAILED;
+        if (pMapping != MAP_FAILED) {
+            size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            std::vector<unsigned char> pages((size + pageSize - 1) / pageSize);
+            resident = mincore(pMapping, size, pages.data()) == 0 &&
+                std::all_of(pages.begin(), pages.end(), [](unsigned char page) { return (page & 1) != 0; });
+            munmap(pMapping, size);
+        }
+    }
+    close(fileDescriptor);
+    return resident;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void BatchFileReader::readAll(const std::vector<std::string>& paths, const FileReadCallback& onFileRead) {
+#ifdef ASSET_IO_URING
+    if (m_pRing) {
+        readAllIoUring(paths, onFileRead);
+        return;
+    }
+#endif
+    readAllBlocking(paths, std::vector<bool>(paths.size(), false), onFileRead);
+}
+
+void BatchFileReader::readAllBlocking(const std::vector<std::string>& paths, const std::vector<bool>& skip, const FileReadCallback& onFileRead) {
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (skip[i]) {
+            continue;
+        }
+
+        std::ifstream file(paths[i], std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            onFileRead(i, nullptr);
+            continue;
+        }
+
+        size_t size = static_cast<size_t>(file.tellg());
+        file.seekg(0, std::ios::beg);
+
+        auto buffer = m_BufferPool.acquire(size);
+        onFileRead(i, file.read(buffer->getData(), size) ? std::move(buffer) : nullptr);
+    }
+}
+
+#ifdef ASSET_IO_URING
+void BatchFileReader::readAllIoUring(const std::vector<std::string>& paths, const FileReadCallback& onFileRead) {
+    struct ReadRequest {
+        size_t fileIndex;
+        uint64_t offset;
+        size_t size;
+    };
+
+    std::vector<std::shared_ptr<FileBuffer>> buffers(paths.size());
+    std::vector<int> fileDescriptors(paths.size(), -1);
+    std::vector<size_t> remainingBytes(paths.size(), 0);
+    std::vector<bool> done(paths.size(), false);
+    std::deque<ReadRequest> pending;
+
+    auto finishFile = [&](size_t fileIndex, bool succeeded) {
+        if (fileDescriptors[fileIndex] >= 0) {
+            close(fileDescriptors[fileIndex]);
+            fileDescriptors[fileIndex] = -1;
+        }
+        done[fileIndex] = true;
+
+        // A failed file may still have reads in flight, so its buffer is kept until the end.
+        onFileRead(fileIndex, succeeded ? std::move(buffers[fileIndex]) : nullptr);
+    };
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        struct stat fileStat {};
+        fileDescriptors[i] = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptors[i] < 0 || fstat(fileDescriptors[i], &fileStat) != 0) {
+            finishFile(i, false);
+            continue;
+        }
+
+        buffers[i] = m_BufferPool.acquire(static_cast<size_t>(fileStat.st_size));
+        remainingBytes[i] = static_cast<size_t>(fileStat.st_size);
+        if (remainingBytes[i] == 0) {
+            finishFile(i, true);
+            continue;
+        }
+        for (uint64_t offset = 0; offset < static_cast<uint64_t>(fileStat.st_size); offset += maxReadSize) {
+            pending.push_back({ i, offset, std::min<size_t>(maxReadSize, static_cast<size_t>(fileStat.st_size - offset)) });
+        }
+    }
+
+    // Requests in flight, indexed by their user_data slot; free slots are reused.
+    std::vector<ReadRequest> inFlight(m_pRing->entryCount);
+    std::vector<unsigned> freeSlots(m_pRing->entryCount);
+    for (unsigned i = 0; i < m_pRing->entryCount; ++i) {
+        freeSlots[i] = m_pRing->entryCount - 1 - i;
+    }
+
+    unsigned inFlightCount = 0;
+    unsigned unsubmittedCount = 0;
+    bool ringFailed = false;
+    while (!pending.empty() || inFlightCount > 0) {
+        while (!pending.empty() && !freeSlots.empty()) {
+            ReadRequest request = pending.front();
+            pending.pop_front();
+            if (done[request.fileIndex]) {
+                continue;
+            }
+
+            unsigned slot = freeSlots.back();
+            freeSlots.pop_back();
+            inFlight[slot] = request;
+            m_pRing->queueRead(fileDescriptors[request.fileIndex], buffers[request.fileIndex]->getData() + request.offset, static_cast<unsigned>(request.size), request.offset, slot);
+            ++inFlightCount;
+            ++unsubmittedCount;
+        }
+        if (inFlightCount == 0) {
+            break;
+        }
+
+        long submitted = m_pRing->submitAndWait(unsubmittedCount);
+        if (submitted < 0) {
+            ringFailed = true;
+            break;
+        }
+        unsubmittedCount -= static_cast<unsigned>(submitted);
+
+        m_pRing->forEachCompletion([&](uint64_t slot, int result) {
+            ReadRequest request = inFlight[slot];
+            freeSlots.push_back(static_cast<unsigned>(slot));
+            --inFlightCount;
+
+            if (done[request.fileIndex]) {
+                return;
+            }
+            if (result == -EINTR || result == -EAGAIN) {
+                pending.push_back(request);
+                return;
+            }
+            if (result <= 0) {
+                finishFile(request.fileIndex, false);
+                return;
+            }
+            if (static_cast<size_t>(result) < request.size) {
+                // Short read: queue the rest.
+                pending.push_back({ request.fileIndex, request.offset + result, request.size - result });
+            }
+            remainingBytes[request.fileIndex] -= static_cast<size_t>(result);
+            if (remainingBytes[request.fileIndex] == 0) {
+                finishFile(request.fileIndex, true);
+            }
+        });
+    }
+
+    if (!ringFailed) {
+        return;
+    }
+
+    // Closing the ring cancels whatever was still in flight; read the rest the ordinary way.
+    m_pRing.reset();
+    m_Backend = Backend::Blocking;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (fileDescriptors[i] >= 0) {
+            close(fileDescriptors[i]);
+        }
+    }
+    readAllBlocking(paths, done, onFileRead);
+}
+#endif
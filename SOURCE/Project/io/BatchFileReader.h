@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <io/FileBufferPool.h>
+
+// Reads a list of whole files into pooled buffers. With the io_uring backend (Linux, built with
+// ASSET_IO_URING) every read of the batch is in flight at once, so the storage device sees the
+// whole queue instead of one request at a time. Elsewhere, or if the kernel refuses to create a
+// ring, the files are read one after another with blocking reads.
+class BatchFileReader {
+public:
+    enum class Backend { Blocking, IoUring };
+
+    explicit BatchFileReader(FileBufferPool& bufferPool, bool allowIoUring = true, unsigned queueDepth = 64);
+    ~BatchFileReader();
+
+    BatchFileReader(const BatchFileReader&) = delete;
+    BatchFileReader& operator=(const BatchFileReader&) = delete;
+
+    // Called once per path as soon as that file is completely read, in completion order, with
+    // nullptr if it could not be read.
+    using FileReadCallback = std::function<void(size_t pathIndex, std::shared_ptr<FileBuffer> buffer)>;
+
+    void readAll(const std::vector<std::string>& paths, const FileReadCallback& onFileRead);
+
+    Backend getBackend() const { return m_Backend; }
+    static const char* getBackendName(Backend backend);
+
+    // True if every page of the file is in the page cache, checked with mincore. Such files are
+    // faster to map than to copy through a batch. Always false without the io_uring backend.
+    static bool isResident(const std::string& path);
+
+    // Large files are split into reads of this size so they spread over the queue.
+    static constexpr size_t maxReadSize = 1024 * 1024;
+
+private:
+    void readAllBlocking(const std::vector<std::string>& paths, const std::vector<bool>& skip, const FileReadCallback& onFileRead);
+
+    FileBufferPool& m_BufferPool;
+    Backend m_Backend = Backend::Blocking;
+
+#ifdef ASSET_IO_URING
+    struct IoUring;
+    void readAllIoUring(const std::vector<std::string>& paths, const FileReadCallback& onFileRead);
+
+    std::unique_ptr<IoUring> m_pRing;
+#endif
+};
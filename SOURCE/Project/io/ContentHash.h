@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <io/MappedFile.h>
+
+// Fast non-cryptographic 64-bit hash used to key cached and cooked assets by content.
+namespace ContentHash {
+    inline uint64_t mix(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDull;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ull;
+        value ^= value >> 33;
+        return value;
+    }
+
+    inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed ^ (size * 0x9E3779B97F4A7C15ull);
+
+        size_t offset = 0;
+        for (; offset + 8 <= size; offset += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + offset, sizeof(word));
+            hash = (hash ^ mix(word)) * 0x9E3779B97F4A7C15ull;
+        }
+
+        uint64_t tail = 0;
+        for (size_t i = 0; offset + i < size; ++i) {
+            tail |= static_cast<uint64_t>(bytes[offset + i]) << (i * 8);
+        }
+        hash = (hash ^ mix(tail)) * 0x9E3779B97F4A7C15ull;
+
+        return mix(hash);
+    }
+
+    inline uint64_t hashString(const std::string& text, uint64_t seed = 0) {
+        return hashBytes(text.data(), text.size(), seed);
+    }
+
+    inline bool hashFile(const std::string& path, uint64_t& hash) {
+        MappedFile file;
+        if (!file.open(path)) {
+            return false;
+        }
+        hash = hashBytes(file.getData(), file.getSize());
+        return true;
+    }
+}
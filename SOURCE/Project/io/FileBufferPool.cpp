@@ -0,0 +1,51 @@
+#include "FileBufferPool.h"
+#include <algorithm>
+
+FileBufferPool::FileBufferPool(size_t maxPooledBytes)
+    : m_pState(std::make_shared<State>()) {
+    m_pState->maxPooledBytes = maxPooledBytes;
+}
+
+std::shared_ptr<FileBuffer> FileBufferPool::acquire(size_t size) {
+    std::unique_ptr<FileBuffer> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_pState->mutex);
+
+        // Smallest free buffer that fits, so large buffers stay available for large files.
+        auto best = m_pState->freeBuffers.end();
+        for (auto it = m_pState->freeBuffers.begin(); it != m_pState->freeBuffers.end(); ++it) {
+            if ((*it)->capacity >= size && (best == m_pState->freeBuffers.end() || (*it)->capacity < (*best)->capacity)) {
+                best = it;
+            }
+        }
+        if (best != m_pState->freeBuffers.end()) {
+            buffer = std::move(*best);
+            m_pState->freeBuffers.erase(best);
+            m_pState->pooledBytes -= buffer->capacity;
+        }
+    }
+
+    if (!buffer) {
+        buffer = std::make_unique<FileBuffer>();
+        buffer->storage.reset(new char[std::max<size_t>(size, 1)]);
+        buffer->capacity = std::max<size_t>(size, 1);
+    }
+    buffer->size = size;
+
+    std::weak_ptr<State> weakState = m_pState;
+    return std::shared_ptr<FileBuffer>(buffer.release(), [weakState](FileBuffer* released) {
+        std::unique_ptr<FileBuffer> owned(released);
+        if (auto state = weakState.lock()) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->pooledBytes + owned->capacity <= state->maxPooledBytes) {
+                state->pooledBytes += owned->capacity;
+                state->freeBuffers.push_back(std::move(owned));
+            }
+        }
+    });
+}
+
+size_t FileBufferPool::getPooledBytes() const {
+    std::lock_guard<std::mutex> lock(m_pState->mutex);
+    return m_pState->pooledBytes;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+// Whole-file read buffer. The storage is left uninitialized and reused across reads.
+struct FileBuffer {
+    std::unique_ptr<char[]> storage;
+    size_t capacity = 0;
+    size_t size = 0;
+
+    char* getData() { return storage.get(); }
+    const char* getData() const { return storage.get(); }
+    size_t getSize() const { return size; }
+};
+
+// Hands out FileBuffers that return to the pool when their last reference is dropped, so loading
+// a scene a second time allocates nothing. Copies share the same pool.
+class FileBufferPool {
+public:
+    explicit FileBufferPool(size_t maxPooledBytes = 256 * 1024 * 1024);
+
+    // Returns a buffer with getSize() == size.
+    std::shared_ptr<FileBuffer> acquire(size_t size);
+
+    size_t getPooledBytes() const;
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<FileBuffer>> freeBuffers;
+        size_t pooledBytes = 0;
+        size_t maxPooledBytes = 0;
+    };
+
+    std::shared_ptr<State> m_pState;
+};
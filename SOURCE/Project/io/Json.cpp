@@ -0,0 +1,299 @@
+#include "Json.h"
+#include <charconv>
+#include <system_error>
+#include <cstring>
+
+class JsonParser {
+public:
+    JsonParser(const char* text, size_t length) : m_pCurrent(text), m_pBegin(text), m_pEnd(text + length) {}
+
+    bool parseDocument(JsonValue& value) {
+        if (!parseValue(value, 0)) {
+            return false;
+        }
+        skipWhitespace();
+        return m_pCurrent == m_pEnd || fail("trailing characters");
+    }
+
+    std::string getError() const { return m_Error + " at offset " + std::to_string(m_ErrorOffset); }
+
+private:
+    // glTF nests a handful of levels; this only guards against stack overflow on hostile input.
+    static constexpr int maxDepth = 256;
+
+    bool fail(const char* message) {
+        m_Error = message;
+        m_ErrorOffset = static_cast<size_t>(m_pCurrent - m_pBegin);
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (m_pCurrent < m_pEnd && (*m_pCurrent == ' ' || *m_pCurrent == '\t' || *m_pCurrent == '\n' || *m_pCurrent == '\r')) {
+            ++m_pCurrent;
+        }
+    }
+
+    bool consumeLiteral(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (static_cast<size_t>(m_pEnd - m_pCurrent) < length || std::memcmp(m_pCurrent, literal, length) != 0) {
+            return fail("invalid literal");
+        }
+        m_pCurrent += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        skipWhitespace();
+        if (m_pCurrent == m_pEnd) {
+            return fail("unexpected end of input");
+        }
+        if (depth > maxDepth) {
+            return fail("nesting too deep");
+        }
+
+        switch (*m_pCurrent) {
+        case '{': return parseObject(value, depth);
+        case '[': return parseArray(value, depth);
+        case '"':
+            value.m_Type = JsonValue::Type::String;
+            return parseString(value.m_String);
+        case 't':
+            value.m_Type = JsonValue::Type::Bool;
+            value.m_Bool = true;
+            return consumeLiteral("true");
+        case 'f':
+            value.m_Type = JsonValue::Type::Bool;
+            value.m_Bool = false;
+            return consumeLiteral("false");
+        case 'n':
+            value.m_Type = JsonValue::Type::Null;
+            return consumeLiteral("null");
+        default:
+            return parseNumber(value);
+        }
+    }
+
+    bool parseNumber(JsonValue& value) {
+        // from_chars ignores the locale and reads the span in place; the scan only bounds it, so
+        // "inf", "nan" and hexadecimal never reach it.
+        const char* start = m_pCurrent;
+        while (m_pCurrent < m_pEnd && std::strchr("+-0123456789.eE", *m_pCurrent) != nullptr) {
+            ++m_pCurrent;
+        }
+
+        value.m_Type = JsonValue::Type::Number;
+        auto [next, error] = std::from_chars(start, m_pCurrent, value.m_Number);
+        return (m_pCurrent != start && error == std::errc{} && next == m_pCurrent) || fail("invalid number");
+    }
+
+    static void appendUtf8(std::string& text, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            text += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800) {
+            text += static_cast<char>(0xC0 | (codePoint >> 6));
+            text += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            text += static_cast<char>(0xE0 | (codePoint >> 12));
+            text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            text += static_cast<char>(0xF0 | (codePoint >> 18));
+            text += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool parseHex4(uint32_t& codePoint) {
+        if (m_pEnd - m_pCurrent < 4) {
+            return fail("truncated escape");
+        }
+        codePoint = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *m_pCurrent++;
+            codePoint <<= 4;
+            if (c >= '0' && c <= '9') codePoint |= c - '0';
+            else if (c >= 'a' && c <= 'f') codePoint |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') codePoint |= c - 'A' + 10;
+            else return fail("invalid escape");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& text) {
+        ++m_pCurrent;
+        text.clear();
+
+        while (m_pCurrent < m_pEnd) {
+            const char* runStart = m_pCurrent;
+            while (m_pCurrent < m_pEnd && *m_pCurrent != '"' && *m_pCurrent != '\\') {
+                ++m_pCurrent;
+            }
+            text.append(runStart, m_pCurrent);
+            if (m_pCurrent == m_pEnd) {
+                break;
+            }
+            if (*m_pCurrent++ == '"') {
+                return true;
+            }
+
+            if (m_pCurrent == m_pEnd) {
+                break;
+            }
+            char escape = *m_pCurrent++;
+            switch (escape) {
+            case '"': text += '"'; break;
+            case '\\': text += '\\'; break;
+            case '/': text += '/'; break;
+            case 'b': text += '\b'; break;
+            case 'f': text += '\f'; break;
+            case 'n': text += '\n'; break;
+            case 'r': text += '\r'; break;
+            case 't': text += '\t'; break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                if (!parseHex4(codePoint)) {
+                    return false;
+                }
+                if (codePoint >= 0xD800 && codePoint < 0xDC00 && m_pEnd - m_pCurrent >= 6 && m_pCurrent[0] == '\\' && m_pCurrent[1] == 'u') {
+                    m_pCurrent += 2;
+                    uint32_t lowSurrogate = 0;
+                    if (!parseHex4(lowSurrogate)) {
+                        return false;
+                    }
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                }
+                appendUtf8(text, codePoint);
+                break;
+            }
+            default:
+                return fail("invalid escape");
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    bool parseArray(JsonValue& value, int depth) {
+        ++m_pCurrent;
+        value.m_Type = JsonValue::Type::Array;
+
+        skipWhitespace();
+        if (m_pCurrent < m_pEnd && *m_pCurrent == ']') {
+            ++m_pCurrent;
+            return true;
+        }
+
+        while (true) {
+            value.m_Elements.emplace_back();
+            if (!parseValue(value.m_Elements.back(), depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (m_pCurrent == m_pEnd) {
+                return fail("unterminated array");
+            }
+            char c = *m_pCurrent++;
+            if (c == ']') {
+                return true;
+            }
+            if (c != ',') {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool parseObject(JsonValue& value, int depth) {
+        ++m_pCurrent;
+        value.m_Type = JsonValue::Type::Object;
+
+        skipWhitespace();
+        if (m_pCurrent < m_pEnd && *m_pCurrent == '}') {
+            ++m_pCurrent;
+            return true;
+        }
+
+        while (true) {
+            skipWhitespace();
+            if (m_pCurrent == m_pEnd || *m_pCurrent != '"') {
+                return fail("expected member name");
+            }
+            value.m_Members.emplace_back();
+            if (!parseString(value.m_Members.back().first)) {
+                return false;
+            }
+            skipWhitespace();
+            if (m_pCurrent == m_pEnd || *m_pCurrent++ != ':') {
+                return fail("expected ':'");
+            }
+            if (!parseValue(value.m_Members.back().second, depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (m_pCurrent == m_pEnd) {
+                return fail("unterminated object");
+            }
+            char c = *m_pCurrent++;
+            if (c == '}') {
+                return true;
+            }
+            if (c != ',') {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    const char* m_pCurrent;
+    const char* m_pBegin;
+    const char* m_pEnd;
+    std::string m_Error;
+    size_t m_ErrorOffset = 0;
+};
+
+namespace {
+    const JsonValue& getNullValue() {
+        static const JsonValue nullValue;
+        return nullValue;
+    }
+}
+
+const JsonValue& JsonValue::operator[](const std::string& key) const {
+    for (const auto& member : m_Members) {
+        if (member.first == key) {
+            return member.second;
+        }
+    }
+    return getNullValue();
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+    return index < m_Elements.size() ? m_Elements[index] : getNullValue();
+}
+
+bool JsonValue::has(const std::string& key) const {
+    for (const auto& member : m_Members) {
+        if (member.first == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t JsonValue::size() const {
+    return m_Type == Type::Array ? m_Elements.size() : m_Members.size();
+}
+
+bool JsonValue::parse(const char* text, size_t length, JsonValue& value, std::string* pError) {
+    value = JsonValue{};
+    JsonParser parser(text, length);
+    if (!parser.parseDocument(value)) {
+        value = JsonValue{};
+        if (pError != nullptr) {
+            *pError = parser.getError();
+        }
+        return false;
+    }
+    return true;
+}
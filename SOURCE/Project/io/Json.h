@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Minimal read-only JSON document, enough for glTF headers. Objects keep their members in file
+// order; lookups are linear, which is fine for the small objects glTF uses.
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type getType() const { return m_Type; }
+    bool isNull() const { return m_Type == Type::Null; }
+    bool isNumber() const { return m_Type == Type::Number; }
+    bool isString() const { return m_Type == Type::String; }
+    bool isArray() const { return m_Type == Type::Array; }
+    bool isObject() const { return m_Type == Type::Object; }
+
+    // Missing members and out-of-range elements return a shared null value, so lookups chain:
+    // json["materials"][0]["name"].getString().
+    const JsonValue& operator[](const std::string& key) const;
+    const JsonValue& operator[](size_t index) const;
+    bool has(const std::string& key) const;
+    size_t size() const;
+
+    double getNumber(double fallback = 0.0) const { return m_Type == Type::Number ? m_Number : fallback; }
+    int64_t getInt(int64_t fallback = 0) const { return m_Type == Type::Number ? static_cast<int64_t>(m_Number) : fallback; }
+    bool getBool(bool fallback = false) const { return m_Type == Type::Bool ? m_Bool : fallback; }
+    const std::string& getString() const { return m_String; }
+    const std::vector<std::pair<std::string, JsonValue>>& getMembers() const { return m_Members; }
+
+    // Returns false and leaves value null on malformed input; error describes where.
+    static bool parse(const char* text, size_t length, JsonValue& value, std::string* pError = nullptr);
+
+private:
+    friend class JsonParser;
+
+    Type m_Type = Type::Null;
+    bool m_Bool = false;
+    double m_Number = 0.0;
+    std::string m_String;
+    std::vector<JsonValue> m_Elements;
+    std::vector<std::pair<std::string, JsonValue>> m_Members;
+};
@@ -0,0 +1,137 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_pData = std::exchange(other.m_pData, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_IsOpen = std::exchange(other.m_IsOpen, false);
+#ifdef _WIN32
+        m_FileHandle = std::exchange(other.m_FileHandle, nullptr);
+        m_MappingHandle = std::exchange(other.m_MappingHandle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path, bool sequentialAccess) {
+    close();
+
+#ifdef _WIN32
+    DWORD flags = sequentialAccess ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle = file;
+    m_Size = static_cast<size_t>(fileSize.QuadPart);
+    m_IsOpen = true;
+
+    if (m_Size == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+    m_MappingHandle = mapping;
+
+    m_pData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_pData == nullptr) {
+        close();
+        return false;
+    }
+#else
+    int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    struct stat fileStat {};
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(fileStat.st_size);
+    m_IsOpen = true;
+
+    if (m_Size == 0) {
+        ::close(fileDescriptor);
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    ::close(fileDescriptor);
+
+    if (mapping == MAP_FAILED) {
+        m_Size = 0;
+        m_IsOpen = false;
+        return false;
+    }
+
+    if (sequentialAccess) {
+        madvise(mapping, m_Size, MADV_SEQUENTIAL);
+    }
+    m_pData = static_cast<const char*>(mapping);
+#endif
+
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (m_pData != nullptr) {
+        UnmapViewOfFile(m_pData);
+    }
+    if (m_MappingHandle != nullptr) {
+        CloseHandle(m_MappingHandle);
+        m_MappingHandle = nullptr;
+    }
+    if (m_FileHandle != nullptr) {
+        CloseHandle(m_FileHandle);
+        m_FileHandle = nullptr;
+    }
+#else
+    if (m_pData != nullptr) {
+        munmap(const_cast<char*>(m_pData), m_Size);
+    }
+#endif
+
+    m_pData = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
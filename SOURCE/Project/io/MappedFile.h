@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path, bool sequentialAccess = true);
+    void close();
+
+    bool isOpen() const { return m_IsOpen; }
+    const char* getData() const { return m_pData; }
+    size_t getSize() const { return m_Size; }
+
+private:
+    const char* m_pData = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+
+#ifdef _WIN32
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#endif
+};
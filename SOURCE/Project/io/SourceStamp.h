@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <io/ContentHash.h>
+
+// Identifies the version of a source file that a cached or cooked artifact was built from.
+struct SourceStamp {
+    uint64_t modifiedTime = 0;
+    uint64_t size = 0;
+    uint64_t contentHash = 0;
+
+    // Fills in the modification time and size only.
+    static bool readInfo(const std::string& path, SourceStamp& stamp) {
+        std::error_code error;
+        auto writeTime = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return false;
+        }
+        auto fileSize = std::filesystem::file_size(path, error);
+        if (error) {
+            return false;
+        }
+
+        stamp.modifiedTime = static_cast<uint64_t>(writeTime.time_since_epoch().count());
+        stamp.size = static_cast<uint64_t>(fileSize);
+        return true;
+    }
+
+    static bool read(const std::string& path, SourceStamp& stamp) {
+        return readInfo(path, stamp) && ContentHash::hashFile(path, stamp.contentHash);
+    }
+
+    // Compares the cheap modification time and size first and only hashes the content when they
+    // differ, so touching a source without changing it does not invalidate its artifacts. A
+    // missing source matches, which lets cooked artifacts ship without their sources. If the
+    // source matched by content, pTouchedTime receives its new modification time; store it in the
+    // artifact with writeModifiedTime() so the next check does not hash the source again.
+    bool matches(const std::string& path, uint64_t* pTouchedTime = nullptr) const {
+        SourceStamp current{};
+        if (!readInfo(path, current) || (current.modifiedTime == modifiedTime && current.size == size)) {
+            return true;
+        }
+        if (current.size != size || !ContentHash::hashFile(path, current.contentHash) || current.contentHash != contentHash) {
+            return false;
+        }
+        if (pTouchedTime != nullptr) {
+            *pTouchedTime = current.modifiedTime;
+        }
+        return true;
+    }
+
+    // Overwrites the modification time an artifact stores at offset, leaving the rest of the file as
+    // it is. Meant for loose artifacts only; assets in a pack are never rewritten.
+    static bool writeModifiedTime(const std::string& artifactPath, uint64_t offset, uint64_t modifiedTime) {
+        std::fstream file(artifactPath, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&modifiedTime), sizeof(modifiedTime));
+        return file.good();
+    }
+};
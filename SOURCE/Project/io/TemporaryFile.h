@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// Artifacts are written next to their final path and renamed into place, so a crash never leaves
+// a half-written file behind. The temporary name is unique per process and call, so writers that
+// race on the same artifact, e.g. the app and the cooker, never write into each other's file.
+namespace TemporaryFile {
+    inline std::string getPath(const std::string& finalPath) {
+        static std::atomic<uint32_t> counter{ 0 };
+#ifdef _WIN32
+        long long processId = _getpid();
+#else
+        long long processId = getpid();
+#endif
+        return finalPath + "." + std::to_string(processId) + "." + std::to_string(counter++) + ".tmp";
+    }
+
+    // Renames temporaryPath to finalPath if written is true, replacing any existing file, and
+    // deletes it otherwise or if the rename fails.
+    inline bool commit(const std::string& temporaryPath, const std::string& finalPath, bool written) {
+        std::error_code error;
+        if (written) {
+            std::filesystem::rename(temporaryPath, finalPath, error);
+            if (!error) {
+                return true;
+            }
+        }
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+}
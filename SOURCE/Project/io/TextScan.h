@@ -0,0 +1,55 @@
+#pragma once
+#include <charconv>
+#include <system_error>
+
+// Locale-independent number scanning for text asset formats. Every function reads only inside
+// [p, end), skips leading spaces and tabs (never line breaks) and returns the position after the
+// parsed token. When no number is found the value is set to zero and the position after the
+// skipped blanks is returned, matching what strtof/strtol report for an empty conversion.
+namespace TextScan {
+    inline bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline bool isSpace(char c) {
+        return isBlank(c) || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    inline const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    inline const char* skipLine(const char* p, const char* end) {
+        while (p < end && *p != '\n') {
+            ++p;
+        }
+        return p < end ? p + 1 : end;
+    }
+
+    inline const char* parseFloat(const char* p, const char* end, float& value) {
+        p = skipBlanks(p, end);
+        const char* start = (p < end && *p == '+') ? p + 1 : p;
+
+        auto [next, error] = std::from_chars(start, end, value);
+        if (error != std::errc{}) {
+            value = 0.0f;
+            return p;
+        }
+        return next;
+    }
+
+    inline const char* parseInt(const char* p, const char* end, int& value) {
+        p = skipBlanks(p, end);
+        const char* start = (p < end && *p == '+') ? p + 1 : p;
+
+        auto [next, error] = std::from_chars(start, end, value, 10);
+        if (error != std::errc{}) {
+            value = 0;
+            return p;
+        }
+        return next;
+    }
+}
@@ -5,172 +5,356 @@
 #include <glm/glm.hpp>
 #include <Vertex.h>
 #include <iostream>
-#include <unordered_map>
 #include <limits>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <io/AssetPack.h>
+#include <io/TextScan.h>
+#include <threading/ThreadPool.h>
+#include <meshes/IndexTripletMap.h>
+#include <meshes/ObjStreamLoader.h>
+#include <filesystem>
 
 namespace ObjLoader {
-    inline bool loadObjFile(const std::string& filename, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices) {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            std::cerr << "Could not open the file: " << filename << std::endl;
-            return false;
-        }
-
-        file.seekg(0, std::ios::end);
-        size_t fileSize = file.tellg();
-        file.seekg(0, std::ios::beg);
+    struct ObjLoadStats {
+        size_t bytesRead = 0;
+        bool memoryMapped = false;
+        bool streamed = false;
+        double parseMilliseconds = 0.0;
+        IndexTripletMapStats dedupStats{};
+    };
 
-        size_t vertexEstimate = fileSize / 100;
-        vertices.reserve(vertexEstimate);
-        indices.reserve(vertexEstimate * 3);
+    struct ObjIndexTriplet {
+        int vertex;
+        int texCoord;
+        int normal;
+    };
 
-        std::vector<glm::vec3> tempVertices;
-        std::vector<glm::vec2> tempTexCoords;
-        std::vector<glm::vec3> tempNormals;
-        std::vector<glm::vec3> tangents;
+    struct ObjChunk {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        std::vector<ObjIndexTriplet> faceCorners;
+    };
 
-        tempVertices.reserve(vertexEstimate);
-        tempTexCoords.reserve(vertexEstimate / 2);
-        tempNormals.reserve(vertexEstimate);
-        tangents.reserve(vertexEstimate);
+    constexpr size_t minParallelChunkSize = 256 * 1024;
 
-        std::unordered_map<Vertex3D_PBR, uint32_t, Vertex3D_PBR::Hash> uniqueVertices;
-        uniqueVertices.reserve(vertexEstimate);
-
-        std::vector<char> buffer(fileSize);
-        file.read(buffer.data(), fileSize);
-
-        const char* data = buffer.data();
-        const char* end = data + fileSize;
+    inline void parseObjChunk(const char* data, const char* end, ObjChunk& chunk) {
+        size_t recordEstimate = static_cast<size_t>(end - data) / 100;
+        chunk.positions.reserve(recordEstimate);
+        chunk.texCoords.reserve(recordEstimate / 2);
+        chunk.normals.reserve(recordEstimate);
+        chunk.faceCorners.reserve(recordEstimate * 3);
 
         while (data < end) {
             // Skip whitespace
-            while (data < end && isspace(*data)) data++;
+            while (data < end && TextScan::isSpace(*data)) data++;
 
             if (data >= end) break;
 
-            if (*data == 'v') {
+            if (*data == 'v' && data + 1 < end) {
                 if (data[1] == ' ') {
                     glm::vec3 vertex;
                     data += 2;
-                    vertex.x = strtof(data, (char**)&data);
-                    vertex.y = strtof(data, (char**)&data);
-                    vertex.z = strtof(data, (char**)&data);
-                    tempVertices.push_back(vertex);
+                    data = TextScan::parseFloat(data, end, vertex.x);
+                    data = TextScan::parseFloat(data, end, vertex.y);
+                    data = TextScan::parseFloat(data, end, vertex.z);
+                    chunk.positions.push_back(vertex);
                 }
                 else if (data[1] == 't') {
                     glm::vec2 texCoord;
-                    data += 3;
-                    texCoord.x = strtof(data, (char**)&data);
-                    texCoord.y = 1.0f - strtof(data, (char**)&data);
-                    tempTexCoords.push_back(texCoord);
+                    data = std::min(data + 3, end);
+                    data = TextScan::parseFloat(data, end, texCoord.x);
+                    data = TextScan::parseFloat(data, end, texCoord.y);
+                    texCoord.y = 1.0f - texCoord.y;
+                    chunk.texCoords.push_back(texCoord);
                 }
                 else if (data[1] == 'n') {
                     glm::vec3 normal;
-                    data += 3;
-                    normal.x = strtof(data, (char**)&data);
-                    normal.y = strtof(data, (char**)&data);
-                    normal.z = strtof(data, (char**)&data);
-                    tempNormals.push_back(normal);
+                    data = std::min(data + 3, end);
+                    data = TextScan::parseFloat(data, end, normal.x);
+                    data = TextScan::parseFloat(data, end, normal.y);
+                    data = TextScan::parseFloat(data, end, normal.z);
+                    chunk.normals.push_back(normal);
                 }
             }
             else if (*data == 'f') {
                 // Face
                 data++;
 
-                int vertexIndex[3], texCoordIndex[3], normalIndex[3];
                 for (int i = 0; i < 3; i++) {
-                    vertexIndex[i] = strtol(data, (char**)&data, 10) - 1;
-                    if (*data == '/') {
+                    ObjIndexTriplet corner{};
+                    data = TextScan::parseInt(data, end, corner.vertex);
+                    corner.vertex -= 1;
+                    if (data < end && *data == '/') {
                         data++;
-                        texCoordIndex[i] = strtol(data, (char**)&data, 10) - 1;
+                        data = TextScan::parseInt(data, end, corner.texCoord);
+                        corner.texCoord -= 1;
                     }
                     else {
-                        texCoordIndex[i] = -1;
+                        corner.texCoord = -1;
                     }
-                    if (*data == '/') {
+                    if (data < end && *data == '/') {
                         data++;
-                        normalIndex[i] = strtol(data, (char**)&data, 10) - 1;
+                        data = TextScan::parseInt(data, end, corner.normal);
+                        corner.normal -= 1;
                     }
                     else {
-                        normalIndex[i] = -1;
+                        corner.normal = -1;
                     }
+                    chunk.faceCorners.push_back(corner);
                 }
+            }
+
+            data = TextScan::skipLine(data, end);
+        }
+    }
+
+    inline int32_t attributeKey(float value) {
+        // Folds -0.0 into 0.0 so the key agrees with float equality.
+        value = value == 0.0f ? 0.0f : value;
+        int32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // Maps every attribute to the first attribute with the same value. Exporters often write one
+    // vn/vt per face corner, and without this the index-triplet dedup would keep those copies.
+    inline std::vector<int32_t> buildAttributeRemap(const std::vector<glm::vec3>& attributes) {
+        std::vector<int32_t> remap(attributes.size());
+        IndexTripletMap firstOccurrence(attributes.size());
+        for (size_t i = 0; i < attributes.size(); ++i) {
+            const glm::vec3& value = attributes[i];
+            remap[i] = static_cast<int32_t>(firstOccurrence.findOrInsert(attributeKey(value.x), attributeKey(value.y), attributeKey(value.z), static_cast<uint32_t>(i)).first);
+        }
+        return remap;
+    }
+
+    inline std::vector<int32_t> buildAttributeRemap(const std::vector<glm::vec2>& attributes) {
+        std::vector<int32_t> remap(attributes.size());
+        IndexTripletMap firstOccurrence(attributes.size());
+        for (size_t i = 0; i < attributes.size(); ++i) {
+            const glm::vec2& value = attributes[i];
+            remap[i] = static_cast<int32_t>(firstOccurrence.findOrInsert(attributeKey(value.x), attributeKey(value.y), 0, static_cast<uint32_t>(i)).first);
+        }
+        return remap;
+    }
+
+    // Builds the indexed mesh from chunks in file order. Because OBJ indices are absolute, the
+    // per-chunk attribute arrays only need concatenating, and walking the faces chunk by chunk
+    // visits them in the same order as a single-threaded pass, so the output is identical.
+    // Tangents are left zero for TangentGenerator.
+    inline bool buildObjMesh(std::vector<ObjChunk>& chunks, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, IndexTripletMapStats* pDedupStats = nullptr) {
+        std::vector<glm::vec3> tempVertices;
+        std::vector<glm::vec2> tempTexCoords;
+        std::vector<glm::vec3> tempNormals;
+
+        if (chunks.size() == 1) {
+            tempVertices = std::move(chunks[0].positions);
+            tempTexCoords = std::move(chunks[0].texCoords);
+            tempNormals = std::move(chunks[0].normals);
+        }
+        else {
+            for (const ObjChunk& chunk : chunks) {
+                tempVertices.insert(tempVertices.end(), chunk.positions.begin(), chunk.positions.end());
+                tempTexCoords.insert(tempTexCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+                tempNormals.insert(tempNormals.end(), chunk.normals.begin(), chunk.normals.end());
+            }
+        }
+
+        size_t cornerCount = 0;
+        for (const ObjChunk& chunk : chunks) {
+            cornerCount += chunk.faceCorners.size();
+        }
+
+        vertices.reserve(tempVertices.size());
+        indices.reserve(cornerCount);
+
+        std::vector<int32_t> positionRemap = buildAttributeRemap(tempVertices);
+        std::vector<int32_t> texCoordRemap = buildAttributeRemap(tempTexCoords);
+        std::vector<int32_t> normalRemap = buildAttributeRemap(tempNormals);
+
+        IndexTripletMap uniqueVertices(tempVertices.size());
+
+        for (const ObjChunk& chunk : chunks) {
+            for (size_t face = 0; face + 3 <= chunk.faceCorners.size(); face += 3) {
+                const ObjIndexTriplet* corners = &chunk.faceCorners[face];
 
                 glm::vec3 positions[3];
                 glm::vec2 texCoords[3];
 
                 for (int i = 0; i < 3; ++i) {
-                    if (vertexIndex[i] < 0 || vertexIndex[i] >= tempVertices.size()) {
-                        std::cerr << "Vertex index out of range: " << vertexIndex[i] + 1 << std::endl;
+                    if (corners[i].vertex < 0 || corners[i].vertex >= tempVertices.size()) {
+                        std::cerr << "Vertex index out of range: " << corners[i].vertex + 1 << std::endl;
                         return false;
                     }
-                    positions[i] = tempVertices[vertexIndex[i]];
+                    positions[i] = tempVertices[corners[i].vertex];
 
-                    if (texCoordIndex[i] >= 0) {
-                        if (texCoordIndex[i] >= tempTexCoords.size()) {
-                            std::cerr << "Texture coordinate index out of range: " << texCoordIndex[i] + 1 << std::endl;
+                    if (corners[i].texCoord >= 0) {
+                        if (corners[i].texCoord >= tempTexCoords.size()) {
+                            std::cerr << "Texture coordinate index out of range: " << corners[i].texCoord + 1 << std::endl;
                             return false;
                         }
-                        texCoords[i] = tempTexCoords[texCoordIndex[i]];
+                        texCoords[i] = tempTexCoords[corners[i].texCoord];
                     }
                     else {
                         texCoords[i] = glm::vec2(0.0f);
                     }
 
-                    if (normalIndex[i] >= 0) {
-                        if (normalIndex[i] >= tempNormals.size()) {
-                            std::cerr << "Normal index out of range: " << normalIndex[i] + 1 << std::endl;
+                    if (corners[i].normal >= 0) {
+                        if (corners[i].normal >= tempNormals.size()) {
+                            std::cerr << "Normal index out of range: " << corners[i].normal + 1 << std::endl;
                             return false;
                         }
                     }
                 }
 
-                glm::vec3 edge1 = positions[1] - positions[0];
-                glm::vec3 edge2 = positions[2] - positions[0];
-                glm::vec2 deltaUV1 = texCoords[1] - texCoords[0];
-                glm::vec2 deltaUV2 = texCoords[2] - texCoords[0];
-
-                float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-                glm::vec3 tangent{
-                    f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x),
-                    f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y),
-                    f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z)
-                };
-
                 for (int i = 0; i < 3; ++i) {
-                    Vertex3D_PBR vertex{};
-                    vertex.pos = positions[i];
-                    vertex.normal = normalIndex[i] >= 0 ? tempNormals[normalIndex[i]] : glm::vec3(0.0f);
-                    vertex.texCoord = texCoords[i];
-                    vertex.color = { 1.0f, 1.0f, 1.0f };
+                    int32_t texCoordKey = corners[i].texCoord >= 0 ? texCoordRemap[corners[i].texCoord] : -1;
+                    int32_t normalKey = corners[i].normal >= 0 ? normalRemap[corners[i].normal] : -1;
 
-                    auto [it, inserted] = uniqueVertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+                    auto [index, inserted] = uniqueVertices.findOrInsert(positionRemap[corners[i].vertex], texCoordKey, normalKey, static_cast<uint32_t>(vertices.size()));
                     if (inserted) {
+                        Vertex3D_PBR vertex{};
+                        vertex.pos = positions[i];
+                        vertex.normal = corners[i].normal >= 0 ? tempNormals[corners[i].normal] : glm::vec3(0.0f);
+                        vertex.texCoord = texCoords[i];
+                        vertex.color = { 1.0f, 1.0f, 1.0f };
+
                         vertices.push_back(vertex);
-                        indices.push_back(it->second);
-                        tangents.push_back(tangent);
-                    }
-                    else {
-                        indices.push_back(it->second);
-                        tangents[it->second] += tangent;
                     }
+                    indices.push_back(index);
                 }
             }
+        }
 
-            while (data < end && *data != '\n') {
-                data++;
+        if (pDedupStats != nullptr) {
+            *pDedupStats = uniqueVertices.getStats();
+        }
+
+        return true;
+    }
+
+    // Splits the buffer at line boundaries into exactly chunkCount pieces, some of which may be
+    // empty, and parses them on the shared thread pool.
+    inline bool parseObjChunks(const char* data, size_t dataSize, size_t chunkCount, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, IndexTripletMapStats* pDedupStats = nullptr) {
+        const char* end = data + dataSize;
+        chunkCount = std::max<size_t>(1, chunkCount);
+
+        std::vector<const char*> chunkBounds{ data };
+        for (size_t i = 1; i < chunkCount; ++i) {
+            const char* split = std::max(chunkBounds.back(), data + dataSize * i / chunkCount);
+            while (split < end && *split != '\n') {
+                split++;
+            }
+            if (split < end) {
+                split++;
             }
-            data++;
+            chunkBounds.push_back(split);
         }
+        chunkBounds.push_back(end);
 
-#pragma omp parallel for
-        for (size_t i = 0; i < vertices.size(); ++i) {
-            const glm::vec3& n = vertices[i].normal;
-            glm::vec3& t = tangents[i];
-            vertices[i].tangent = glm::normalize(t - n * glm::dot(n, t));
+        std::vector<ObjChunk> chunks(chunkCount);
+        ThreadPool::getShared().parallelFor(chunkCount, 1, [&](size_t begin, size_t last) {
+            for (size_t i = begin; i < last; ++i) {
+                parseObjChunk(chunkBounds[i], chunkBounds[i + 1], chunks[i]);
+            }
+        });
+
+        return buildObjMesh(chunks, vertices, indices, pDedupStats);
+    }
+
+    // Parses with up to maxChunkCount chunks, but none smaller than minParallelChunkSize. A
+    // maxChunkCount of 1 gives the plain single-threaded parse, 0 one chunk per pool thread.
+    inline bool parseObjBuffer(const char* data, size_t dataSize, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, size_t maxChunkCount = 0, IndexTripletMapStats* pDedupStats = nullptr) {
+        if (maxChunkCount == 0) {
+            maxChunkCount = ThreadPool::getShared().getThreadCount();
         }
+        size_t chunkCount = std::max<size_t>(1, std::min(maxChunkCount, dataSize / minParallelChunkSize));
+        return parseObjChunks(data, dataSize, chunkCount, vertices, indices, pDedupStats);
+    }
 
-        return true;
+    // Streams the file with streamObjFile and appends its blocks to vertices and indices. Vertices on
+    // block borders are duplicated, and each block's tangents were generated before it was handed
+    // over. Every vertex belongs to one block only, so running TangentGenerator on the whole mesh
+    // would give the same result; callers can skip it when the stats report a streamed load.
+    inline bool streamObjMesh(const std::string& filename, const ObjStreamOptions& streamOptions, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, ObjLoadStats& stats) {
+        ObjStreamStats streamStats{};
+        bool result = streamObjFile(filename, streamOptions, [&](const ObjMeshBlock& block) {
+            if (vertices.size() + block.vertices.size() > std::numeric_limits<uint32_t>::max()) {
+                std::cerr << "Too many vertices for 32-bit indices in " << filename << std::endl;
+                return false;
+            }
+            uint32_t firstVertex = static_cast<uint32_t>(vertices.size());
+            vertices.insert(vertices.end(), block.vertices.begin(), block.vertices.end());
+            for (uint32_t index : block.indices) {
+                indices.push_back(firstVertex + index);
+            }
+            return true;
+        }, &streamStats);
+
+        stats.bytesRead = streamStats.bytesRead;
+        stats.streamed = true;
+        stats.parseMilliseconds = streamStats.firstPassMilliseconds + streamStats.secondPassMilliseconds;
+        return result;
+    }
+
+    // Files above streamOptions.streamThreshold go through streamObjMesh, so the text and the
+    // attribute arrays never have to fit in memory at once; only the finished mesh does.
+    inline bool loadObjFile(const std::string& filename, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const ObjStreamOptions& streamOptions = {}, ObjLoadStats* pStats = nullptr) {
+        ObjLoadStats stats{};
+
+        std::error_code error;
+        uintmax_t fileSize = std::filesystem::file_size(filename, error);
+        if (!error && fileSize > streamOptions.streamThreshold) {
+            bool result = streamObjMesh(filename, streamOptions, vertices, indices, stats);
+            if (pStats != nullptr) {
+                *pStats = stats;
+            }
+            return result;
+        }
+
+        AssetFile mappedFile;
+        std::vector<char> buffer;
+        const char* data = nullptr;
+        size_t dataSize = 0;
+
+        if (mappedFile.open(filename)) {
+            data = mappedFile.getData();
+            dataSize = mappedFile.getSize();
+            stats.memoryMapped = true;
+        }
+        else {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.is_open()) {
+                std::cerr << "Could not open the file: " << filename << std::endl;
+                return false;
+            }
+
+            file.seekg(0, std::ios::end);
+            dataSize = static_cast<size_t>(file.tellg());
+            file.seekg(0, std::ios::beg);
+
+            buffer.resize(dataSize);
+            file.read(buffer.data(), dataSize);
+            data = buffer.data();
+        }
+        stats.bytesRead = dataSize;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        bool result = parseObjBuffer(data, dataSize, vertices, indices, 0, &stats.dedupStats);
+        stats.parseMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        double megabytesPerSecond = stats.parseMilliseconds > 0.0 ? (stats.bytesRead / (1024.0 * 1024.0)) / (stats.parseMilliseconds / 1000.0) : 0.0;
+        std::cout << "Loaded " << filename << ": " << stats.bytesRead << " bytes " << (stats.memoryMapped ? "mapped" : "read")
+            << ", parsed in " << stats.parseMilliseconds << " ms (" << megabytesPerSecond << " MB/s), dedup "
+            << stats.dedupStats.collisions << "/" << stats.dedupStats.lookups << " collisions, avg probe "
+            << stats.dedupStats.getAverageProbeLength() << ", max probe " << stats.dedupStats.maxProbeLength << std::endl;
+
+        if (pStats != nullptr) {
+            *pStats = stats;
+        }
+        return result;
     }
 }
\ No newline at end of file
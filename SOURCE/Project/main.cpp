@@ -1,6 +1,13 @@
 #include "vulkanbase/VulkanBase.h"
+#include <io/AssetPack.h>
 
 int main() {
+	// Assets in the pack are read from its single mapping; anything else falls back to loose files.
+	AssetPack& assetPack = AssetPack::getShared();
+	if (assetPack.open("models.pak")) {
+		std::cout << "Mounted models.pak: " << assetPack.getEntryCount() << " assets, " << assetPack.getSize() / (1024.0 * 1024.0) << " MiB" << std::endl;
+	}
+
 	VulkanBase app;
 
 	try {
@@ -0,0 +1,112 @@
+#include "AmbientOcclusionBaker.h"
+#include <meshes/TriangleBvh.h>
+#include <threading/ThreadPool.h>
+#include <glm/gtc/constants.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr size_t minVerticesPerRange = 64;
+
+    float radicalInverse(uint32_t bits) {
+        bits = (bits << 16) | (bits >> 16);
+        bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+        bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+        bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+        bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+        return static_cast<float>(bits) * 2.3283064365386963e-10f;
+    }
+
+    // Hammersley points mapped to a cosine-weighted hemisphere around +z, so the unoccluded
+    // fraction of rays estimates the cosine-weighted visibility the diffuse ambient term needs.
+    std::vector<glm::vec3> buildHemisphereDirections(uint32_t rayCount) {
+        std::vector<glm::vec3> directions(rayCount);
+        for (uint32_t i = 0; i < rayCount; ++i) {
+            float u = (i + 0.5f) / rayCount;
+            float phi = glm::two_pi<float>() * radicalInverse(i);
+            float radius = std::sqrt(u);
+            directions[i] = { radius * std::cos(phi), radius * std::sin(phi), std::sqrt(std::max(0.0f, 1.0f - u)) };
+        }
+        return directions;
+    }
+
+    float hashPosition(const glm::vec3& position) {
+        uint32_t bits[3];
+        std::memcpy(bits, &position, sizeof(bits));
+        uint32_t hash = bits[0] * 0x8DA6B343u ^ bits[1] * 0xD8163841u ^ bits[2] * 0xCB1AB31Fu;
+        hash ^= hash >> 15;
+        hash *= 0x2C1B3C6Du;
+        hash ^= hash >> 12;
+        return static_cast<float>(hash) * 2.3283064365386963e-10f;
+    }
+}
+
+AmbientOcclusionStats AmbientOcclusionBaker::bake(std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, uint32_t indexOffset, uint32_t indexCount, const AmbientOcclusionOptions& options) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AmbientOcclusionStats stats{};
+    if (vertices.empty() || indexCount < 3 || options.rayCount == 0) {
+        return stats;
+    }
+
+    std::vector<glm::vec3> positions(vertices.size());
+    glm::vec3 boundsMin = vertices[0].pos;
+    glm::vec3 boundsMax = vertices[0].pos;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        positions[i] = vertices[i].pos;
+        boundsMin = glm::min(boundsMin, positions[i]);
+        boundsMax = glm::max(boundsMax, positions[i]);
+    }
+
+    TriangleBvh bvh;
+    bvh.build(positions.data(), indices.data(), indexOffset, indexCount);
+
+    float radius = glm::length(boundsMax - boundsMin) * 0.5f;
+    float maxDistance = options.maxDistance * radius;
+    // Lifts the ray origins off the surface so they do not hit the triangles they start on.
+    float bias = radius * 1e-4f;
+
+    std::vector<glm::vec3> directions = buildHemisphereDirections(options.rayCount);
+    ThreadPool& threadPool = ThreadPool::getShared();
+
+    threadPool.parallelFor(vertices.size(), minVerticesPerRange, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Vertex3D_PBR& vertex = vertices[i];
+            float normalLength = glm::length(vertex.normal);
+            if (!(normalLength > 0.0f)) {
+                vertex.color = glm::vec3{ 1.0f };
+                continue;
+            }
+            glm::vec3 normal = vertex.normal / normalLength;
+
+            // Orthonormal basis around the normal (Duff et al. 2017).
+            float sign = std::copysign(1.0f, normal.z);
+            float a = -1.0f / (sign + normal.z);
+            float b = normal.x * normal.y * a;
+            glm::vec3 tangent{ 1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x };
+            glm::vec3 bitangent{ b, sign + normal.y * normal.y * a, -normal.y };
+
+            float angle = glm::two_pi<float>() * hashPosition(vertex.pos);
+            float cosAngle = std::cos(angle);
+            float sinAngle = std::sin(angle);
+            glm::vec3 rotatedTangent = tangent * cosAngle + bitangent * sinAngle;
+            glm::vec3 rotatedBitangent = bitangent * cosAngle - tangent * sinAngle;
+
+            glm::vec3 origin = vertex.pos + normal * bias;
+            uint32_t unoccluded = 0;
+            for (const glm::vec3& local : directions) {
+                glm::vec3 direction = rotatedTangent * local.x + rotatedBitangent * local.y + normal * local.z;
+                if (!bvh.isOccluded(origin, direction, bias, maxDistance)) {
+                    ++unoccluded;
+                }
+            }
+
+            vertex.color = glm::vec3{ static_cast<float>(unoccluded) / directions.size() };
+        }
+    });
+
+    stats.rayCount = vertices.size() * directions.size();
+    stats.threadCount = std::min(threadPool.getThreadCount(), std::max<size_t>(1, vertices.size() / minVerticesPerRange));
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return stats;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <Vertex.h>
+
+struct AmbientOcclusionOptions {
+    bool bakeAmbientOcclusion = true;
+    uint32_t rayCount = 64;
+    // Occluders further away than this fraction of the mesh's bounding radius are ignored, so the
+    // bake darkens creases and contact areas rather than everything facing into the mesh.
+    float maxDistance = 0.1f;
+
+    // Bit 0 is the bake flag, bits 1-32 the full ray count and bits 33-63 the distance in
+    // ten-thousandths, so no two fields can overlap.
+    uint64_t getKey() const {
+        return static_cast<uint64_t>(bakeAmbientOcclusion) | (static_cast<uint64_t>(rayCount) << 1) |
+            ((static_cast<uint64_t>(maxDistance * 10000.0f) & 0x7FFFFFFFull) << 33);
+    }
+};
+
+struct AmbientOcclusionStats {
+    size_t rayCount = 0;
+    size_t threadCount = 0;
+    double milliseconds = 0.0;
+
+    double getRaysPerSecondPerThread() const { return milliseconds > 0.0 ? rayCount / (milliseconds * 0.001) / threadCount : 0.0; }
+};
+
+namespace AmbientOcclusionBaker {
+    // Casts rayCount cosine-distributed rays over each vertex's normal hemisphere against a BVH of
+    // the triangles in indices[indexOffset, indexOffset + indexCount) and stores the unoccluded
+    // fraction in every channel of the vertex color. Vertices are spread over the shared thread
+    // pool. Every vertex uses the same ray pattern, rotated by a hash of its position, so the
+    // copies of a vertex split at a UV seam get the same value and neighbours do not band.
+    AmbientOcclusionStats bake(std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, uint32_t indexOffset, uint32_t indexCount, const AmbientOcclusionOptions& options);
+}
@@ -0,0 +1,457 @@
+#include "GeometryCodec.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GEOMETRY_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace GeometryCodec {
+    namespace {
+        constexpr uint8_t vertexStreamTag = 0xA0;
+        constexpr uint8_t indexStreamTag = 0xB0;
+
+        constexpr size_t groupSize = 16;
+        constexpr size_t maxBlockBytes = 16384;
+        constexpr size_t maxBlockVertices = 256;
+
+        // Widths in bits for the four group codes.
+        constexpr uint32_t groupWidths[4] = { 0, 2, 4, 8 };
+
+        size_t getBlockVertexCount(size_t vertexSize) {
+            size_t count = std::min(maxBlockVertices, maxBlockBytes / vertexSize);
+            return count & ~(groupSize - 1);
+        }
+
+        uint8_t zigzag8(uint8_t delta) {
+            return static_cast<uint8_t>((delta << 1) ^ (static_cast<int8_t>(delta) >> 7));
+        }
+
+        uint32_t zigzag32(uint32_t delta) {
+            return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+        }
+
+        uint32_t unzigzag32(uint32_t value) {
+            return (value >> 1) ^ (0u - (value & 1u));
+        }
+
+        size_t getGroupCost(const uint8_t* values, uint32_t width) {
+            if (width == 0) {
+                return std::all_of(values, values + groupSize, [](uint8_t value) { return value == 0; }) ? 0 : SIZE_MAX;
+            }
+            if (width == 8) {
+                return groupSize;
+            }
+
+            uint32_t escape = (1u << width) - 1;
+            size_t cost = groupSize * width / 8;
+            for (size_t i = 0; i < groupSize; ++i) {
+                cost += values[i] >= escape ? 1 : 0;
+            }
+            return cost;
+        }
+
+        // values holds groupCount * groupSize bytes, zero padded past the real count. Packed codes
+        // are laid out so a group unpacks with a few 64-bit shifts and masks: value j sits in byte
+        // j % packedSize, in the (j / packedSize)-th field from the top.
+        void encodeLane(const uint8_t* values, size_t groupCount, std::vector<uint8_t>& output) {
+            size_t headerOffset = output.size();
+            output.resize(output.size() + (groupCount + 3) / 4, 0);
+
+            for (size_t group = 0; group < groupCount; ++group) {
+                const uint8_t* groupValues = values + group * groupSize;
+
+                uint32_t bestCode = 3;
+                size_t bestCost = groupSize;
+                for (uint32_t code = 0; code < 3; ++code) {
+                    size_t cost = getGroupCost(groupValues, groupWidths[code]);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestCode = code;
+                    }
+                }
+                output[headerOffset + group / 4] |= static_cast<uint8_t>(bestCode << (6 - 2 * (group % 4)));
+
+                uint32_t width = groupWidths[bestCode];
+                if (width == 8) {
+                    output.insert(output.end(), groupValues, groupValues + groupSize);
+                }
+                else if (width != 0) {
+                    uint32_t escape = (1u << width) - 1;
+                    size_t packedSize = groupSize * width / 8;
+                    size_t packedOffset = output.size();
+                    output.resize(output.size() + packedSize, 0);
+                    for (size_t i = 0; i < groupSize; ++i) {
+                        uint32_t shift = 8 - width * static_cast<uint32_t>(i / packedSize + 1);
+                        output[packedOffset + i % packedSize] |= static_cast<uint8_t>(std::min<uint32_t>(groupValues[i], escape) << shift);
+                    }
+                    for (size_t i = 0; i < groupSize; ++i) {
+                        if (groupValues[i] >= escape) {
+                            output.push_back(groupValues[i]);
+                        }
+                    }
+                }
+            }
+        }
+
+        constexpr uint64_t byteMask(uint8_t value) {
+            return 0x0101010101010101ull * value;
+        }
+
+        // Returns 0x80 in every byte of bytes that equals value and 0 elsewhere.
+        uint64_t matchBytes(uint64_t bytes, uint8_t value) {
+            uint64_t difference = bytes ^ byteMask(value);
+            return ~(((difference & byteMask(0x7F)) + byteMask(0x7F)) | difference) & byteMask(0x80);
+        }
+
+        // Replaces the bytes flagged by matches, lowest first, with raw bytes read from data.
+        const uint8_t* replaceBytes(uint64_t& bytes, uint64_t matches, const uint8_t* data, const uint8_t* end) {
+            while (matches != 0) {
+                if (data == end) {
+                    return nullptr;
+                }
+                uint64_t flag = matches & (0 - matches);
+                uint64_t unit = flag >> 7;
+                bytes = (bytes & ~(unit * 0xFF)) | (unit * *data++);
+                matches ^= flag;
+            }
+            return data;
+        }
+
+        // Adds eight bytes at once without carries between them.
+        uint64_t addBytes(uint64_t a, uint64_t b) {
+            return ((a & byteMask(0x7F)) + (b & byteMask(0x7F))) ^ ((a ^ b) & byteMask(0x80));
+        }
+
+        uint64_t unzigzagBytes(uint64_t bytes) {
+            return ((bytes >> 1) & byteMask(0x7F)) ^ ((bytes & byteMask(0x01)) * 0xFF);
+        }
+
+        // Unpacks one group of 2- or 4-bit codes into two words of eight values, replacing escape
+        // codes with the raw bytes that follow the packed data. Returns the position after the
+        // group or nullptr if it is cut off.
+        template <uint32_t Width>
+        const uint8_t* decodeGroup(const uint8_t* data, const uint8_t* end, uint64_t& low, uint64_t& high) {
+            constexpr uint32_t packedSize = groupSize * Width / 8;
+            constexpr uint8_t escape = (1u << Width) - 1;
+            if (static_cast<size_t>(end - data) < packedSize) {
+                return nullptr;
+            }
+
+            if (Width == 4) {
+                uint64_t packed;
+                std::memcpy(&packed, data, sizeof(packed));
+                low = (packed >> 4) & byteMask(0x0F);
+                high = packed & byteMask(0x0F);
+            }
+            else {
+                uint32_t packed32;
+                std::memcpy(&packed32, data, sizeof(packed32));
+                uint64_t packed = packed32;
+                low = ((packed >> 6) & byteMask(0x03)) | (((packed >> 4) & byteMask(0x03)) << 32);
+                high = (((packed >> 2) & byteMask(0x03)) & 0xFFFFFFFFull) | ((packed & byteMask(0x03)) << 32);
+            }
+            data += packedSize;
+
+            data = replaceBytes(low, matchBytes(low, escape), data, end);
+            return data != nullptr ? replaceBytes(high, matchBytes(high, escape), data, end) : nullptr;
+        }
+
+        // Decodes count values of one lane into target, contiguous and padded to whole groups.
+        const uint8_t* decodeLane(const uint8_t* data, const uint8_t* end, uint8_t* target, size_t count) {
+            size_t groupCount = (count + groupSize - 1) / groupSize;
+            size_t headerSize = (groupCount + 3) / 4;
+            if (static_cast<size_t>(end - data) < headerSize) {
+                return nullptr;
+            }
+            const uint8_t* header = data;
+            data += headerSize;
+
+            for (size_t group = 0; group < groupCount; ++group) {
+                uint32_t code = (header[group / 4] >> (6 - 2 * (group % 4))) & 3;
+
+                uint64_t low = 0;
+                uint64_t high = 0;
+                switch (code) {
+                case 0:
+                    break;
+                case 1:
+                    data = decodeGroup<2>(data, end, low, high);
+                    break;
+                case 2:
+                    data = decodeGroup<4>(data, end, low, high);
+                    break;
+                default:
+                    if (static_cast<size_t>(end - data) < groupSize) {
+                        return nullptr;
+                    }
+                    std::memcpy(&low, data, sizeof(low));
+                    std::memcpy(&high, data + 8, sizeof(high));
+                    data += groupSize;
+                    break;
+                }
+                if (data == nullptr) {
+                    return nullptr;
+                }
+
+                std::memcpy(target + group * groupSize, &low, sizeof(low));
+                std::memcpy(target + group * groupSize + 8, &high, sizeof(high));
+            }
+            return data;
+        }
+
+        // Transposes an 8x8 byte matrix held in eight words, one row per word.
+        void transposeBytes8x8(uint64_t rows[8]) {
+            for (int r = 0; r < 4; ++r) {
+                uint64_t a = rows[r];
+                uint64_t b = rows[r + 4];
+                rows[r] = (a & 0x00000000FFFFFFFFull) | (b << 32);
+                rows[r + 4] = (a >> 32) | (b & 0xFFFFFFFF00000000ull);
+            }
+            for (int r : { 0, 1, 4, 5 }) {
+                uint64_t a = rows[r];
+                uint64_t b = rows[r + 2];
+                rows[r] = (a & 0x0000FFFF0000FFFFull) | ((b & 0x0000FFFF0000FFFFull) << 16);
+                rows[r + 2] = ((a >> 16) & 0x0000FFFF0000FFFFull) | (b & 0xFFFF0000FFFF0000ull);
+            }
+            for (int r = 0; r < 8; r += 2) {
+                uint64_t a = rows[r];
+                uint64_t b = rows[r + 1];
+                rows[r] = (a & byteMask(0xFF) & 0x00FF00FF00FF00FFull) | ((b & 0x00FF00FF00FF00FFull) << 8);
+                rows[r + 1] = ((a >> 8) & 0x00FF00FF00FF00FFull) | (b & 0xFF00FF00FF00FF00ull);
+            }
+        }
+
+#ifdef GEOMETRY_CODEC_SSE2
+        // The SSE2 version of interleaveLanes below, sixteen lanes by sixteen elements at a time.
+        // Returns the number of lanes it handled.
+        template <bool Accumulate>
+        size_t interleaveLanes16(const uint8_t* lanes, size_t laneSize, uint8_t* elements, size_t elementCount, size_t elementSize, uint8_t* previous) {
+            // Index deltas have four lanes, which two rounds of interleaving put back together.
+            if (!Accumulate && elementSize == 4) {
+                for (size_t i = 0; i < elementCount; i += 16) {
+                    __m128i lane0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + i));
+                    __m128i lane1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + laneSize + i));
+                    __m128i lane2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 2 * laneSize + i));
+                    __m128i lane3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 3 * laneSize + i));
+                    __m128i low01 = _mm_unpacklo_epi8(lane0, lane1);
+                    __m128i high01 = _mm_unpackhi_epi8(lane0, lane1);
+                    __m128i low23 = _mm_unpacklo_epi8(lane2, lane3);
+                    __m128i high23 = _mm_unpackhi_epi8(lane2, lane3);
+                    __m128i* target = reinterpret_cast<__m128i*>(elements + i * 4);
+                    _mm_storeu_si128(target, _mm_unpacklo_epi16(low01, low23));
+                    _mm_storeu_si128(target + 1, _mm_unpackhi_epi16(low01, low23));
+                    _mm_storeu_si128(target + 2, _mm_unpacklo_epi16(high01, high23));
+                    _mm_storeu_si128(target + 3, _mm_unpackhi_epi16(high01, high23));
+                }
+                return elementSize;
+            }
+
+            size_t laneCount = elementSize & ~size_t(15);
+            const __m128i one = _mm_set1_epi8(1);
+            const __m128i low7 = _mm_set1_epi8(0x7F);
+
+            for (size_t i = 0; i < elementCount; i += 16) {
+                size_t lastRow = std::min<size_t>(15, elementCount - 1 - i);
+
+                for (size_t lane = 0; lane < laneCount; lane += 16) {
+                    __m128i rows[16];
+                    for (int r = 0; r < 16; ++r) {
+                        rows[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + (lane + r) * laneSize + i));
+                    }
+                    // Four rounds of interleaving row r with row r + 8 transpose a 16x16 matrix.
+                    for (int round = 0; round < 4; ++round) {
+                        __m128i interleaved[16];
+                        for (int r = 0; r < 8; ++r) {
+                            interleaved[2 * r] = _mm_unpacklo_epi8(rows[r], rows[r + 8]);
+                            interleaved[2 * r + 1] = _mm_unpackhi_epi8(rows[r], rows[r + 8]);
+                        }
+                        std::memcpy(rows, interleaved, sizeof(rows));
+                    }
+
+                    if (Accumulate) {
+                        __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + lane));
+                        for (int r = 0; r < 16; ++r) {
+                            __m128i magnitude = _mm_and_si128(_mm_srli_epi16(rows[r], 1), low7);
+                            __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(rows[r], one));
+                            sum = _mm_add_epi8(sum, _mm_xor_si128(magnitude, sign));
+                            rows[r] = sum;
+                        }
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(previous + lane), rows[lastRow]);
+                    }
+                    for (int r = 0; r < 16; ++r) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(elements + (i + r) * elementSize + lane), rows[r]);
+                    }
+                }
+            }
+            return laneCount;
+        }
+#endif
+
+        // Interleaves lanes (lane k holds byte k of every element, laneSize bytes apart) back into
+        // elements, eight lanes by eight elements at a time, or sixteen by sixteen with SSE2. With
+        // Accumulate the lanes hold zigzag deltas, which are summed per byte on whole words of the
+        // interleaved elements; previous holds the last element of the block before and is updated
+        // to this block's last one.
+        template <bool Accumulate>
+        void interleaveLanes(const uint8_t* lanes, size_t laneSize, uint8_t* elements, size_t elementCount, size_t elementSize, uint8_t* previous) {
+            size_t firstLane = 0;
+#ifdef GEOMETRY_CODEC_SSE2
+            firstLane = interleaveLanes16<Accumulate>(lanes, laneSize, elements, elementCount, elementSize, previous);
+#endif
+            for (size_t i = 0; i < elementCount; i += 8) {
+                // Rows past elementCount are padding; previous keeps the sum of the last real one.
+                size_t lastRow = std::min<size_t>(7, elementCount - 1 - i);
+
+                for (size_t lane = firstLane; lane < elementSize; lane += 8) {
+                    size_t width = std::min<size_t>(8, elementSize - lane);
+                    uint64_t rows[8]{};
+                    for (size_t r = 0; r < width; ++r) {
+                        std::memcpy(&rows[r], lanes + (lane + r) * laneSize + i, sizeof(uint64_t));
+                    }
+                    transposeBytes8x8(rows);
+
+                    if (Accumulate) {
+                        uint64_t sum = 0;
+                        std::memcpy(&sum, previous + lane, width);
+                        for (int r = 0; r < 8; ++r) {
+                            sum = addBytes(sum, unzigzagBytes(rows[r]));
+                            rows[r] = sum;
+                        }
+                        std::memcpy(previous + lane, &rows[lastRow], width);
+                    }
+
+                    if (width == 8) {
+                        for (int r = 0; r < 8; ++r) {
+                            std::memcpy(elements + (i + r) * elementSize + lane, &rows[r], sizeof(uint64_t));
+                        }
+                    }
+                    else if (width == 4) {
+                        for (int r = 0; r < 8; ++r) {
+                            std::memcpy(elements + (i + r) * elementSize + lane, &rows[r], sizeof(uint32_t));
+                        }
+                    }
+                    else {
+                        for (int r = 0; r < 8; ++r) {
+                            std::memcpy(elements + (i + r) * elementSize + lane, &rows[r], width);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Splits elements into byte lanes and encodes every lane block by block. With Accumulate
+        // each lane holds zigzag deltas to the previous element instead of the bytes themselves.
+        template <bool Accumulate>
+        void encodeStream(const uint8_t* elements, size_t elementCount, size_t elementSize, std::vector<uint8_t>& output) {
+            size_t blockCount = getBlockVertexCount(elementSize);
+            uint8_t previous[maxVertexSize]{};
+            uint8_t lane[maxBlockVertices];
+
+            for (size_t blockStart = 0; blockStart < elementCount; blockStart += blockCount) {
+                size_t count = std::min(blockCount, elementCount - blockStart);
+                size_t groupCount = (count + groupSize - 1) / groupSize;
+                const uint8_t* block = elements + blockStart * elementSize;
+
+                for (size_t k = 0; k < elementSize; ++k) {
+                    std::memset(lane, 0, groupCount * groupSize);
+                    for (size_t i = 0; i < count; ++i) {
+                        uint8_t byte = block[i * elementSize + k];
+                        lane[i] = Accumulate ? zigzag8(static_cast<uint8_t>(byte - previous[k])) : byte;
+                        previous[k] = byte;
+                    }
+                    encodeLane(lane, groupCount, output);
+                }
+            }
+        }
+
+        // Rebuilds blocks in a local buffer and hands each to finishBlock, which copies it out.
+        template <bool Accumulate, typename FinishBlock>
+        bool decodeStream(const uint8_t* data, const uint8_t* end, size_t elementCount, size_t elementSize, FinishBlock&& finishBlock) {
+            size_t blockCount = getBlockVertexCount(elementSize);
+            uint8_t previous[maxVertexSize]{};
+            alignas(16) uint8_t lanes[maxBlockBytes];
+            // interleaveLanes also writes the padding rows up to the next group, which still fit
+            // because blockCount is a whole number of groups.
+            alignas(16) uint8_t block[maxBlockBytes];
+
+            for (size_t blockStart = 0; blockStart < elementCount; blockStart += blockCount) {
+                size_t count = std::min(blockCount, elementCount - blockStart);
+                for (size_t k = 0; k < elementSize; ++k) {
+                    data = decodeLane(data, end, lanes + k * blockCount, count);
+                    if (data == nullptr) {
+                        return false;
+                    }
+                }
+                interleaveLanes<Accumulate>(lanes, blockCount, block, count, elementSize, previous);
+                finishBlock(block, blockStart, count);
+            }
+            return data == end;
+        }
+    }
+
+    std::vector<uint8_t> encodeVertices(const void* vertices, size_t vertexCount, size_t vertexSize) {
+        std::vector<uint8_t> output;
+        if (vertexSize == 0 || vertexSize > maxVertexSize) {
+            return output;
+        }
+
+        output.reserve(1 + vertexCount * vertexSize / 2);
+        output.push_back(vertexStreamTag);
+        encodeStream<true>(static_cast<const uint8_t*>(vertices), vertexCount, vertexSize, output);
+        return output;
+    }
+
+    std::vector<uint8_t> encodeIndices(const uint32_t* indices, size_t indexCount) {
+        std::vector<uint32_t> deltas(indexCount);
+        uint32_t previous = 0;
+        for (size_t i = 0; i < indexCount; ++i) {
+            deltas[i] = zigzag32(indices[i] - previous);
+            previous = indices[i];
+        }
+
+        std::vector<uint8_t> output;
+        output.reserve(1 + indexCount * 2);
+        output.push_back(indexStreamTag);
+        encodeStream<false>(reinterpret_cast<const uint8_t*>(deltas.data()), indexCount, sizeof(uint32_t), output);
+        return output;
+    }
+
+    bool decodeVertexBlocks(size_t vertexCount, size_t vertexSize, const uint8_t* data, size_t dataSize, const VertexBlockCallback& callback) {
+        if (vertexSize == 0 || vertexSize > maxVertexSize || dataSize == 0 || data[0] != vertexStreamTag) {
+            return false;
+        }
+
+        return decodeStream<true>(data + 1, data + dataSize, vertexCount, vertexSize, callback);
+    }
+
+    bool decodeIndexBlocks(size_t indexCount, const uint8_t* data, size_t dataSize, const IndexBlockCallback& callback) {
+        if (dataSize == 0 || data[0] != indexStreamTag) {
+            return false;
+        }
+
+        uint32_t previous = 0;
+        return decodeStream<false>(data + 1, data + dataSize, indexCount, sizeof(uint32_t), [&](uint8_t* block, size_t blockStart, size_t count) {
+            uint32_t* values = reinterpret_cast<uint32_t*>(block);
+            for (size_t i = 0; i < count; ++i) {
+                previous += unzigzag32(values[i]);
+                values[i] = previous;
+            }
+            callback(values, blockStart, count);
+        });
+    }
+
+    bool decodeVertices(void* destination, size_t vertexCount, size_t vertexSize, const uint8_t* data, size_t dataSize) {
+        uint8_t* target = static_cast<uint8_t*>(destination);
+        return decodeVertexBlocks(vertexCount, vertexSize, data, dataSize, [&](const void* vertices, size_t firstVertex, size_t count) {
+            std::memcpy(target + firstVertex * vertexSize, vertices, count * vertexSize);
+        });
+    }
+
+    bool decodeIndices(uint32_t* destination, size_t indexCount, const uint8_t* data, size_t dataSize) {
+        return decodeIndexBlocks(indexCount, data, dataSize, [&](const uint32_t* indices, size_t firstIndex, size_t count) {
+            std::memcpy(destination + firstIndex, indices, count * sizeof(uint32_t));
+        });
+    }
+}
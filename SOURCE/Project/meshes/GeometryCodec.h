@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// Lossless compression for vertex and index arrays, in the style of meshoptimizer's codecs.
+//
+// Vertices are cut into blocks that fit in L1. Within a block each byte of the vertex is coded as
+// its own stream: the byte's difference to the same byte of the previous vertex, zigzag mapped so
+// small changes in either direction become small numbers. Each run of 16 such deltas is stored
+// with 0, 2, 4 or 8 bits per value, picked per run. A value that does not fit is escaped with
+// the all-ones code and follows as a raw byte. Constant bytes, such as the color of an OBJ, cost
+// almost nothing. Smoothly varying high bytes of floats cost 2 or 4 bits. Noisy low mantissa
+// bytes stay at 8 bits.
+//
+// Indices are zigzag coded as differences to the previous index and then byte-split the same
+// way, so the mostly empty high bytes of each difference shrink to 0 bits.
+//
+// Decoding assembles one block at a time in a small local buffer and then copies it out in a
+// single sequential write. The destination is never read, so it can be mapped, write-combined
+// staging memory.
+namespace GeometryCodec {
+    std::vector<uint8_t> encodeVertices(const void* vertices, size_t vertexCount, size_t vertexSize);
+    std::vector<uint8_t> encodeIndices(const uint32_t* indices, size_t indexCount);
+
+    // Return false if the data is corrupt or does not describe exactly vertexCount vertices of
+    // vertexSize bytes (or indexCount indices). destination may then be partly written.
+    bool decodeVertices(void* destination, size_t vertexCount, size_t vertexSize, const uint8_t* data, size_t dataSize);
+    bool decodeIndices(uint32_t* destination, size_t indexCount, const uint8_t* data, size_t dataSize);
+
+    // Hand each decoded block to the callback while it is still in L1, so the caller can convert
+    // it (quantize vertices, narrow indices) on its way into staging memory without a full-size
+    // intermediate array. Blocks arrive in order and hold at most a few hundred elements.
+    using VertexBlockCallback = std::function<void(const void* vertices, size_t firstVertex, size_t vertexCount)>;
+    using IndexBlockCallback = std::function<void(const uint32_t* indices, size_t firstIndex, size_t indexCount)>;
+    bool decodeVertexBlocks(size_t vertexCount, size_t vertexSize, const uint8_t* data, size_t dataSize, const VertexBlockCallback& callback);
+    bool decodeIndexBlocks(size_t indexCount, const uint8_t* data, size_t dataSize, const IndexBlockCallback& callback);
+
+    // Vertices up to this size can be encoded; Vertex3D_PBR is 56 bytes.
+    constexpr size_t maxVertexSize = 256;
+}
@@ -0,0 +1,579 @@
+#include "GltfLoader.h"
+#include <io/Json.h>
+#include <meshes/TangentGenerator.h>
+#include <texture/TextureImage.h>
+#include <threading/ThreadPool.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace GltfLoader {
+    namespace {
+        constexpr uint32_t glbMagic = 0x46546C67;
+        constexpr uint32_t jsonChunkType = 0x4E4F534A;
+        constexpr uint32_t binaryChunkType = 0x004E4942;
+
+        constexpr uint32_t componentByte = 5120;
+        constexpr uint32_t componentUnsignedByte = 5121;
+        constexpr uint32_t componentShort = 5122;
+        constexpr uint32_t componentUnsignedShort = 5123;
+        constexpr uint32_t componentUnsignedInt = 5125;
+        constexpr uint32_t componentFloat = 5126;
+
+        constexpr int64_t modeTriangles = 4;
+
+        // Below this many vertices the copy is done on the calling thread.
+        constexpr size_t parallelCopyRange = 32768;
+
+        struct BufferSpan {
+            const char* pData = nullptr;
+            size_t size = 0;
+        };
+
+        // A validated accessor: element i starts at pData + i * stride.
+        struct AccessorView {
+            const char* pData = nullptr;
+            size_t count = 0;
+            size_t stride = 0;
+            uint32_t componentType = 0;
+            uint32_t componentCount = 0;
+            bool normalized = false;
+
+            bool isValid() const { return count > 0; }
+            bool isFloat(uint32_t components) const { return pData != nullptr && componentType == componentFloat && componentCount == components; }
+        };
+
+        uint32_t getComponentSize(uint32_t componentType) {
+            switch (componentType) {
+            case componentByte:
+            case componentUnsignedByte: return 1;
+            case componentShort:
+            case componentUnsignedShort: return 2;
+            case componentUnsignedInt:
+            case componentFloat: return 4;
+            default: return 0;
+            }
+        }
+
+        uint32_t getComponentCount(const std::string& type) {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2") return 2;
+            if (type == "VEC3") return 3;
+            if (type == "VEC4") return 4;
+            return 0;
+        }
+
+        int getHexDigit(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        // Returns false on a '%' that is not followed by two hex digits.
+        bool decodeUri(const std::string& uri, std::string& decoded) {
+            decoded.clear();
+            decoded.reserve(uri.size());
+            for (size_t i = 0; i < uri.size(); ++i) {
+                if (uri[i] == '%') {
+                    int high = i + 2 < uri.size() ? getHexDigit(uri[i + 1]) : -1;
+                    int low = high >= 0 ? getHexDigit(uri[i + 2]) : -1;
+                    if (low < 0) {
+                        return false;
+                    }
+                    decoded += static_cast<char>(high * 16 + low);
+                    i += 2;
+                }
+                else {
+                    decoded += uri[i];
+                }
+            }
+            return true;
+        }
+
+        bool resolveUri(const std::string& glbPath, const std::string& uri, std::string& resolved) {
+            std::string decoded;
+            if (!decodeUri(uri, decoded)) {
+                return false;
+            }
+            resolved = (std::filesystem::path(glbPath).parent_path() / decoded).generic_string();
+            return true;
+        }
+
+        bool readGlbChunks(const AssetFile& file, BufferSpan& json, BufferSpan& binary) {
+            const char* data = file.getData();
+            size_t size = file.getSize();
+
+            uint32_t header[3]{};
+            if (size < sizeof(header)) {
+                return false;
+            }
+            std::memcpy(header, data, sizeof(header));
+            if (header[0] != glbMagic || header[1] != 2 || header[2] > size) {
+                return false;
+            }
+
+            size_t offset = sizeof(header);
+            size_t end = header[2];
+            while (offset + 8 <= end) {
+                uint32_t chunk[2]{};
+                std::memcpy(chunk, data + offset, sizeof(chunk));
+                offset += sizeof(chunk);
+                if (chunk[0] > end - offset) {
+                    return false;
+                }
+
+                if (chunk[1] == jsonChunkType && json.pData == nullptr) {
+                    json = { data + offset, chunk[0] };
+                }
+                else if (chunk[1] == binaryChunkType && binary.pData == nullptr) {
+                    binary = { data + offset, chunk[0] };
+                }
+                offset += (chunk[0] + 3) & ~size_t(3);
+            }
+            return json.pData != nullptr;
+        }
+
+        bool getBufferView(const JsonValue& document, const std::vector<BufferSpan>& buffers, int64_t viewIndex, BufferSpan& view, size_t* pStride = nullptr) {
+            const JsonValue& bufferView = document["bufferViews"][static_cast<size_t>(viewIndex)];
+            int64_t bufferIndex = bufferView["buffer"].getInt(-1);
+            if (!bufferView.isObject() || bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= buffers.size()) {
+                return false;
+            }
+
+            const BufferSpan& buffer = buffers[static_cast<size_t>(bufferIndex)];
+            uint64_t offset = static_cast<uint64_t>(bufferView["byteOffset"].getInt(0));
+            uint64_t length = static_cast<uint64_t>(bufferView["byteLength"].getInt(0));
+            if (offset > buffer.size || length > buffer.size - offset) {
+                return false;
+            }
+
+            view = { buffer.pData + offset, static_cast<size_t>(length) };
+            if (pStride != nullptr) {
+                *pStride = static_cast<size_t>(bufferView["byteStride"].getInt(0));
+            }
+            return true;
+        }
+
+        bool getAccessor(const JsonValue& document, const std::vector<BufferSpan>& buffers, int64_t accessorIndex, AccessorView& view) {
+            view = {};
+            if (accessorIndex < 0) {
+                return true;
+            }
+
+            const JsonValue& accessor = document["accessors"][static_cast<size_t>(accessorIndex)];
+            if (!accessor.isObject()) {
+                std::cerr << "Accessor " << accessorIndex << " does not exist" << std::endl;
+                return false;
+            }
+            if (accessor.has("sparse")) {
+                std::cerr << "Sparse accessors are not supported" << std::endl;
+                return false;
+            }
+
+            view.componentType = static_cast<uint32_t>(accessor["componentType"].getInt(0));
+            view.componentCount = getComponentCount(accessor["type"].getString());
+            view.count = static_cast<size_t>(accessor["count"].getInt(0));
+            view.normalized = accessor["normalized"].getBool();
+
+            size_t elementSize = static_cast<size_t>(getComponentSize(view.componentType)) * view.componentCount;
+            if (elementSize == 0) {
+                std::cerr << "Accessor " << accessorIndex << " has an unsupported type" << std::endl;
+                return false;
+            }
+            view.stride = elementSize;
+
+            // Accessors without a buffer view are all zeros; pData stays null for those.
+            if (!accessor.has("bufferView") || view.count == 0) {
+                return true;
+            }
+
+            BufferSpan bufferView{};
+            size_t byteStride = 0;
+            if (!getBufferView(document, buffers, accessor["bufferView"].getInt(-1), bufferView, &byteStride)) {
+                std::cerr << "Accessor " << accessorIndex << " references an invalid buffer view" << std::endl;
+                return false;
+            }
+            if (byteStride != 0) {
+                view.stride = byteStride;
+            }
+
+            uint64_t offset = static_cast<uint64_t>(accessor["byteOffset"].getInt(0));
+            uint64_t available = bufferView.size;
+            if (offset > available || elementSize > available - offset || static_cast<uint64_t>(view.count - 1) > (available - offset - elementSize) / view.stride) {
+                std::cerr << "Accessor " << accessorIndex << " runs past the end of its buffer view" << std::endl;
+                return false;
+            }
+
+            view.pData = bufferView.pData + offset;
+            return true;
+        }
+
+        float readNormalized(const char* pComponent, uint32_t componentType) {
+            switch (componentType) {
+            case componentUnsignedByte: return static_cast<uint8_t>(*pComponent) / 255.0f;
+            case componentUnsignedShort: {
+                uint16_t value;
+                std::memcpy(&value, pComponent, sizeof(value));
+                return value / 65535.0f;
+            }
+            case componentFloat: {
+                float value;
+                std::memcpy(&value, pComponent, sizeof(value));
+                return value;
+            }
+            default: return 0.0f;
+            }
+        }
+
+        // Texture coordinates may also be stored as normalized unsigned integers.
+        bool isReadableAttribute(const AccessorView& view, uint32_t minComponents) {
+            return view.componentCount >= minComponents && (view.componentType == componentFloat ||
+                (view.normalized && (view.componentType == componentUnsignedByte || view.componentType == componentUnsignedShort)));
+        }
+
+        template <typename Member>
+        void copyAttribute(const AccessorView& view, Vertex3D_PBR* vertices, Member Vertex3D_PBR::* member, size_t begin, size_t end) {
+            if (view.pData == nullptr) {
+                return;
+            }
+
+            if (view.componentType == componentFloat) {
+                const char* pSource = view.pData + begin * view.stride;
+                for (size_t i = begin; i < end; ++i, pSource += view.stride) {
+                    std::memcpy(&(vertices[i].*member), pSource, sizeof(Member));
+                }
+                return;
+            }
+
+            uint32_t componentSize = getComponentSize(view.componentType);
+            for (size_t i = begin; i < end; ++i) {
+                const char* pSource = view.pData + i * view.stride;
+                float* pTarget = reinterpret_cast<float*>(&(vertices[i].*member));
+                for (size_t c = 0; c < sizeof(Member) / sizeof(float); ++c) {
+                    pTarget[c] = readNormalized(pSource + c * componentSize, view.componentType);
+                }
+            }
+        }
+
+        bool copyIndices(const AccessorView& view, size_t vertexCount, std::vector<uint32_t>& indices) {
+            if (view.count == 0) {
+                indices.resize(vertexCount);
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    indices[i] = static_cast<uint32_t>(i);
+                }
+                return true;
+            }
+            if (view.componentCount != 1 || view.pData == nullptr) {
+                return false;
+            }
+
+            indices.resize(view.count);
+            uint32_t maxIndex = 0;
+            switch (view.componentType) {
+            case componentUnsignedInt:
+                if (view.stride == sizeof(uint32_t)) {
+                    std::memcpy(indices.data(), view.pData, view.count * sizeof(uint32_t));
+                }
+                else {
+                    for (size_t i = 0; i < view.count; ++i) {
+                        std::memcpy(&indices[i], view.pData + i * view.stride, sizeof(uint32_t));
+                    }
+                }
+                for (uint32_t index : indices) {
+                    maxIndex = std::max(maxIndex, index);
+                }
+                break;
+            case componentUnsignedShort:
+                for (size_t i = 0; i < view.count; ++i) {
+                    uint16_t index;
+                    std::memcpy(&index, view.pData + i * view.stride, sizeof(index));
+                    indices[i] = index;
+                    maxIndex = std::max<uint32_t>(maxIndex, index);
+                }
+                break;
+            case componentUnsignedByte:
+                for (size_t i = 0; i < view.count; ++i) {
+                    indices[i] = static_cast<uint8_t>(view.pData[i * view.stride]);
+                    maxIndex = std::max(maxIndex, indices[i]);
+                }
+                break;
+            default:
+                return false;
+            }
+
+            if (indices.size() % 3 != 0 || (!indices.empty() && maxIndex >= vertexCount)) {
+                std::cerr << "Primitive indices are out of range or not a triangle list" << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        void generateNormals(std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices) {
+            for (auto& vertex : vertices) {
+                vertex.normal = glm::vec3(0.0f);
+            }
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                Vertex3D_PBR& v0 = vertices[indices[i]];
+                Vertex3D_PBR& v1 = vertices[indices[i + 1]];
+                Vertex3D_PBR& v2 = vertices[indices[i + 2]];
+                glm::vec3 faceNormal = glm::cross(v1.pos - v0.pos, v2.pos - v0.pos);
+                v0.normal += faceNormal;
+                v1.normal += faceNormal;
+                v2.normal += faceNormal;
+            }
+            for (auto& vertex : vertices) {
+                float length = glm::length(vertex.normal);
+                vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+
+        bool loadPrimitive(const JsonValue& document, const std::vector<BufferSpan>& buffers, const JsonValue& primitive, GltfPrimitive& result, size_t& attributeBytes) {
+            const JsonValue& attributes = primitive["attributes"];
+
+            AccessorView positions, normals, tangents, texCoords, indices;
+            if (!getAccessor(document, buffers, attributes["POSITION"].getInt(-1), positions) ||
+                !getAccessor(document, buffers, attributes["NORMAL"].getInt(-1), normals) ||
+                !getAccessor(document, buffers, attributes["TANGENT"].getInt(-1), tangents) ||
+                !getAccessor(document, buffers, attributes["TEXCOORD_0"].getInt(-1), texCoords) ||
+                !getAccessor(document, buffers, primitive["indices"].getInt(-1), indices)) {
+                return false;
+            }
+
+            size_t vertexCount = positions.count;
+            if (!positions.isFloat(3)) {
+                std::cerr << "Primitive has no float3 POSITION attribute" << std::endl;
+                return false;
+            }
+            if ((normals.isValid() && (normals.count != vertexCount || normals.componentType != componentFloat || normals.componentCount != 3)) ||
+                (tangents.isValid() && (tangents.count != vertexCount || tangents.componentType != componentFloat || tangents.componentCount != 4)) ||
+                (texCoords.isValid() && (texCoords.count != vertexCount || !isReadableAttribute(texCoords, 2)))) {
+                std::cerr << "Primitive has attributes with unsupported formats or mismatched counts" << std::endl;
+                return false;
+            }
+
+            result.vertices.resize(vertexCount);
+            Vertex3D_PBR* pVertices = result.vertices.data();
+
+            // One pass per vertex range writes each output vertex once, whatever the source layout.
+            auto copyRange = [&](size_t begin, size_t end) {
+                copyAttribute(positions, pVertices, &Vertex3D_PBR::pos, begin, end);
+                copyAttribute(normals, pVertices, &Vertex3D_PBR::normal, begin, end);
+                copyAttribute(tangents, pVertices, &Vertex3D_PBR::tangent, begin, end);
+                copyAttribute(texCoords, pVertices, &Vertex3D_PBR::texCoord, begin, end);
+                // The color channel holds baked ambient occlusion, so COLOR_0 is not read.
+                for (size_t i = begin; i < end; ++i) {
+                    pVertices[i].color = { 1.0f, 1.0f, 1.0f };
+                }
+            };
+            if (vertexCount < 2 * parallelCopyRange) {
+                copyRange(0, vertexCount);
+            }
+            else {
+                ThreadPool::getShared().parallelFor(vertexCount, parallelCopyRange, copyRange);
+            }
+
+            if (!copyIndices(indices, vertexCount, result.indices)) {
+                return false;
+            }
+
+            if (!normals.isValid()) {
+                generateNormals(result.vertices, result.indices);
+            }
+            if (!tangents.isValid()) {
+                TangentGenerator::generate(result.vertices, result.indices);
+            }
+
+            for (const AccessorView* pView : { &positions, &normals, &tangents, &texCoords, &indices }) {
+                attributeBytes += pView->count * getComponentSize(pView->componentType) * pView->componentCount;
+            }
+            return true;
+        }
+
+        GltfTextureRef readTextureRef(const JsonValue& document, const JsonValue& textureInfo) {
+            GltfTextureRef ref{};
+            if (!textureInfo.isObject()) {
+                return ref;
+            }
+            const JsonValue& texture = document["textures"][static_cast<size_t>(textureInfo["index"].getInt(-1))];
+            ref.image = static_cast<int32_t>(texture["source"].getInt(-1));
+            ref.texCoord = static_cast<uint32_t>(textureInfo["texCoord"].getInt(0));
+            return ref;
+        }
+
+        void readMaterials(const JsonValue& document, GltfModel& model) {
+            const JsonValue& materials = document["materials"];
+            model.materials.resize(materials.size());
+
+            for (size_t i = 0; i < materials.size(); ++i) {
+                const JsonValue& source = materials[i];
+                const JsonValue& pbr = source["pbrMetallicRoughness"];
+                GltfMaterial& material = model.materials[i];
+
+                material.name = source["name"].getString();
+                for (int c = 0; c < 4; ++c) {
+                    material.baseColorFactor[c] = static_cast<float>(pbr["baseColorFactor"][c].getNumber(1.0));
+                }
+                for (int c = 0; c < 3; ++c) {
+                    material.emissiveFactor[c] = static_cast<float>(source["emissiveFactor"][c].getNumber(0.0));
+                }
+                material.metallicFactor = static_cast<float>(pbr["metallicFactor"].getNumber(1.0));
+                material.roughnessFactor = static_cast<float>(pbr["roughnessFactor"].getNumber(1.0));
+                material.normalScale = static_cast<float>(source["normalTexture"]["scale"].getNumber(1.0));
+                material.occlusionStrength = static_cast<float>(source["occlusionTexture"]["strength"].getNumber(1.0));
+                material.doubleSided = source["doubleSided"].getBool();
+
+                material.baseColorTexture = readTextureRef(document, pbr["baseColorTexture"]);
+                material.metallicRoughnessTexture = readTextureRef(document, pbr["metallicRoughnessTexture"]);
+                material.normalTexture = readTextureRef(document, source["normalTexture"]);
+                material.occlusionTexture = readTextureRef(document, source["occlusionTexture"]);
+                material.emissiveTexture = readTextureRef(document, source["emissiveTexture"]);
+            }
+        }
+
+        bool readImages(const std::string& path, const JsonValue& document, const std::vector<BufferSpan>& buffers, GltfModel& model) {
+            const JsonValue& images = document["images"];
+            model.images.resize(images.size());
+
+            for (size_t i = 0; i < images.size(); ++i) {
+                const JsonValue& source = images[i];
+                GltfImage& image = model.images[i];
+                image.mimeType = source["mimeType"].getString();
+
+                if (source.has("bufferView")) {
+                    BufferSpan view{};
+                    if (!getBufferView(document, buffers, source["bufferView"].getInt(-1), view)) {
+                        std::cerr << "Image " << i << " references an invalid buffer view" << std::endl;
+                        return false;
+                    }
+                    image.pData = view.pData;
+                    image.size = view.size;
+                }
+                else {
+                    const std::string& uri = source["uri"].getString();
+                    if (uri.compare(0, 5, "data:") == 0) {
+                        std::cerr << "Image " << i << " uses a data URI, which is not supported" << std::endl;
+                        return false;
+                    }
+                    if (!resolveUri(path, uri, image.path)) {
+                        std::cerr << "Image " << i << " has a malformed URI " << uri << std::endl;
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    }
+
+    bool loadGlbFile(const std::string& path, GltfModel& model, GltfLoadStats* pStats) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        model = GltfModel{};
+
+        AssetFile file;
+        if (!file.open(path, false)) {
+            std::cerr << "Failed to open glTF file: " << path << std::endl;
+            return false;
+        }
+
+        BufferSpan jsonChunk{};
+        BufferSpan binaryChunk{};
+        if (!readGlbChunks(file, jsonChunk, binaryChunk)) {
+            std::cerr << "Not a valid binary glTF 2.0 file: " << path << std::endl;
+            return false;
+        }
+
+        JsonValue document;
+        std::string error;
+        if (!JsonValue::parse(jsonChunk.pData, jsonChunk.size, document, &error)) {
+            std::cerr << "Invalid glTF JSON in " << path << ": " << error << std::endl;
+            return false;
+        }
+
+        size_t fileSize = file.getSize();
+        model.buffers.push_back(std::move(file));
+
+        // Buffer 0 without a URI is the binary chunk; any other buffer is a file next to the GLB.
+        const JsonValue& bufferList = document["buffers"];
+        std::vector<BufferSpan> buffers;
+        for (size_t i = 0; i < bufferList.size(); ++i) {
+            const JsonValue& buffer = bufferList[i];
+            size_t byteLength = static_cast<size_t>(buffer["byteLength"].getInt(0));
+            if (!buffer.has("uri")) {
+                if (i != 0 || binaryChunk.size < byteLength) {
+                    std::cerr << "Buffer " << i << " of " << path << " has no data" << std::endl;
+                    return false;
+                }
+                buffers.push_back({ binaryChunk.pData, byteLength });
+                continue;
+            }
+
+            const std::string& uri = buffer["uri"].getString();
+            std::string bufferPath;
+            AssetFile bufferFile;
+            if (uri.compare(0, 5, "data:") == 0 || !resolveUri(path, uri, bufferPath) || !bufferFile.open(bufferPath, false) || bufferFile.getSize() < byteLength) {
+                std::cerr << "Failed to open buffer " << uri << " of " << path << std::endl;
+                return false;
+            }
+            buffers.push_back({ bufferFile.getData(), byteLength });
+            model.buffers.push_back(std::move(bufferFile));
+        }
+
+        readMaterials(document, model);
+        if (!readImages(path, document, buffers, model)) {
+            return false;
+        }
+
+        auto copyStartTime = std::chrono::high_resolution_clock::now();
+        size_t attributeBytes = 0;
+
+        const JsonValue& meshes = document["meshes"];
+        for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex) {
+            const JsonValue& mesh = meshes[meshIndex];
+            const JsonValue& primitives = mesh["primitives"];
+
+            for (size_t primitiveIndex = 0; primitiveIndex < primitives.size(); ++primitiveIndex) {
+                const JsonValue& primitive = primitives[primitiveIndex];
+                if (primitive["mode"].getInt(modeTriangles) != modeTriangles) {
+                    std::cerr << "Skipping non-triangle primitive " << primitiveIndex << " of mesh " << meshIndex << " in " << path << std::endl;
+                    continue;
+                }
+
+                GltfPrimitive result{};
+                result.meshName = mesh["name"].getString();
+                result.meshIndex = static_cast<uint32_t>(meshIndex);
+                result.material = static_cast<int32_t>(primitive["material"].getInt(-1));
+                if (!loadPrimitive(document, buffers, primitive, result, attributeBytes)) {
+                    std::cerr << "Failed to load primitive " << primitiveIndex << " of mesh " << meshIndex << " in " << path << std::endl;
+                    return false;
+                }
+                model.primitives.push_back(std::move(result));
+            }
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        if (pStats != nullptr) {
+            *pStats = {};
+            pStats->fileSize = fileSize;
+            pStats->primitiveCount = model.primitives.size();
+            for (const auto& primitive : model.primitives) {
+                pStats->vertexCount += primitive.vertices.size();
+                pStats->indexCount += primitive.indices.size();
+            }
+            pStats->attributeBytes = attributeBytes;
+            pStats->parseMilliseconds = std::chrono::duration<double, std::milli>(copyStartTime - startTime).count();
+            pStats->copyMilliseconds = std::chrono::duration<double, std::milli>(endTime - copyStartTime).count();
+        }
+        return true;
+    }
+
+    bool loadImage(const GltfModel& model, int32_t imageIndex, TextureImage& image, TextureRole role) {
+        if (imageIndex < 0 || static_cast<size_t>(imageIndex) >= model.images.size()) {
+            return false;
+        }
+        const GltfImage& source = model.images[static_cast<size_t>(imageIndex)];
+        return source.isEmbedded() ? TextureImage::decodeMemory(source.pData, source.size, image, role) : TextureImage::loadFromFile(source.path, role, false, image);
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <Vertex.h>
+#include <io/AssetPack.h>
+#include <texture/TextureFormat.h>
+
+struct TextureImage;
+
+namespace GltfLoader {
+    // An image is either a file next to the GLB or bytes embedded in one of its buffer views.
+    // Embedded bytes point into the mapping held by the GltfModel.
+    struct GltfImage {
+        std::string path;
+        const char* pData = nullptr;
+        size_t size = 0;
+        std::string mimeType;
+
+        bool isEmbedded() const { return pData != nullptr; }
+    };
+
+    struct GltfTextureRef {
+        int32_t image = -1;
+        uint32_t texCoord = 0;
+
+        bool isValid() const { return image >= 0; }
+    };
+
+    struct GltfMaterial {
+        std::string name;
+        glm::vec4 baseColorFactor{ 1.0f };
+        float metallicFactor = 1.0f;
+        float roughnessFactor = 1.0f;
+        glm::vec3 emissiveFactor{ 0.0f };
+        float normalScale = 1.0f;
+        float occlusionStrength = 1.0f;
+        bool doubleSided = false;
+
+        GltfTextureRef baseColorTexture;
+        GltfTextureRef normalTexture;
+        // Roughness in green, metalness in blue.
+        GltfTextureRef metallicRoughnessTexture;
+        GltfTextureRef occlusionTexture;
+        GltfTextureRef emissiveTexture;
+    };
+
+    // One triangle list with one material. A glTF mesh with several primitives yields one entry per
+    // primitive, all with the same meshIndex.
+    struct GltfPrimitive {
+        std::string meshName;
+        uint32_t meshIndex = 0;
+        int32_t material = -1;
+        std::vector<Vertex3D_PBR> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    struct GltfModel {
+        std::vector<GltfPrimitive> primitives;
+        std::vector<GltfMaterial> materials;
+        std::vector<GltfImage> images;
+
+        // Keep embedded images valid; buffers[0] is the GLB itself.
+        std::vector<AssetFile> buffers;
+    };
+
+    struct GltfLoadStats {
+        size_t fileSize = 0;
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        size_t primitiveCount = 0;
+        // Accessor bytes read, for comparing the copy time with a plain memcpy.
+        size_t attributeBytes = 0;
+        double parseMilliseconds = 0.0;
+        double copyMilliseconds = 0.0;
+    };
+
+    // Maps a binary glTF 2.0 file and copies each primitive's POSITION, NORMAL, TANGENT and TEXCOORD_0
+    // accessors straight out of the binary chunk into Vertex3D_PBR arrays ready for
+    // Mesh::initialize. COLOR_0 is ignored and color set to white, since that channel carries the
+    // baked ambient occlusion. Float attributes are copied with one strided memcpy per vertex and nothing is
+    // parsed per vertex. Missing normals and tangents are generated like the OBJ loader does. The
+    // tangent's w sign is dropped, since the shaders rebuild the bitangent as cross(N, T). Node
+    // transforms are not applied; every primitive stays in its mesh's space.
+    bool loadGlbFile(const std::string& path, GltfModel& model, GltfLoadStats* pStats = nullptr);
+
+    // Decodes an image of a loaded model for role, from the uncompressed cooked file or source next
+    // to the GLB, or from its embedded bytes.
+    bool loadImage(const GltfModel& model, int32_t imageIndex, TextureImage& image, TextureRole role = TextureRole::Color);
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+struct IndexTripletMapStats {
+    size_t lookups = 0;
+    size_t collisions = 0;
+    size_t totalProbeLength = 0;
+    size_t maxProbeLength = 0;
+
+    double getAverageProbeLength() const { return lookups > 0 ? static_cast<double>(totalProbeLength) / lookups : 0.0; }
+};
+
+// Open-addressing (linear probing) map from an OBJ (v, vt, vn) index triplet to an output vertex
+// index. Slots are 16 bytes and stored inline, so a lookup is usually a single cache line and
+// inserting never allocates except when the table doubles.
+class IndexTripletMap {
+public:
+    explicit IndexTripletMap(size_t expectedCount = 0) {
+        size_t capacity = 16;
+        while (capacity < expectedCount * 2) {
+            capacity *= 2;
+        }
+        m_Slots.assign(capacity, Slot{});
+        m_Mask = capacity - 1;
+    }
+
+    // Returns the stored index and false when the triplet is already present, otherwise stores
+    // newIndex and returns it with true.
+    std::pair<uint32_t, bool> findOrInsert(int32_t vertex, int32_t texCoord, int32_t normal, uint32_t newIndex) {
+        if ((m_Size + 1) * 2 > m_Slots.size()) {
+            grow();
+        }
+
+        size_t slotIndex = hash(vertex, texCoord, normal) & m_Mask;
+        size_t probeLength = 0;
+
+        while (true) {
+            Slot& slot = m_Slots[slotIndex];
+            if (slot.value == emptyValue) {
+                slot = Slot{ vertex, texCoord, normal, newIndex };
+                ++m_Size;
+                recordProbe(probeLength);
+                return { newIndex, true };
+            }
+            if (slot.vertex == vertex && slot.texCoord == texCoord && slot.normal == normal) {
+                recordProbe(probeLength);
+                return { slot.value, false };
+            }
+            slotIndex = (slotIndex + 1) & m_Mask;
+            ++probeLength;
+        }
+    }
+
+    void clear() {
+        std::fill(m_Slots.begin(), m_Slots.end(), Slot{});
+        m_Size = 0;
+    }
+
+    size_t getSize() const { return m_Size; }
+    size_t getCapacity() const { return m_Slots.size(); }
+    const IndexTripletMapStats& getStats() const { return m_Stats; }
+
+private:
+    static constexpr uint32_t emptyValue = UINT32_MAX;
+
+    struct Slot {
+        int32_t vertex = 0;
+        int32_t texCoord = 0;
+        int32_t normal = 0;
+        uint32_t value = emptyValue;
+    };
+
+    static size_t hash(int32_t vertex, int32_t texCoord, int32_t normal) {
+        uint64_t h = static_cast<uint32_t>(vertex);
+        h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(texCoord);
+        h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(normal);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    void recordProbe(size_t probeLength) {
+        ++m_Stats.lookups;
+        m_Stats.totalProbeLength += probeLength;
+        m_Stats.maxProbeLength = std::max(m_Stats.maxProbeLength, probeLength);
+        if (probeLength > 0) {
+            ++m_Stats.collisions;
+        }
+    }
+
+    void grow() {
+        std::vector<Slot> oldSlots = std::move(m_Slots);
+        m_Slots.assign(oldSlots.size() * 2, Slot{});
+        m_Mask = m_Slots.size() - 1;
+
+        for (const Slot& slot : oldSlots) {
+            if (slot.value == emptyValue) {
+                continue;
+            }
+            size_t slotIndex = hash(slot.vertex, slot.texCoord, slot.normal) & m_Mask;
+            while (m_Slots[slotIndex].value != emptyValue) {
+                slotIndex = (slotIndex + 1) & m_Mask;
+            }
+            m_Slots[slotIndex] = slot;
+        }
+    }
+
+    std::vector<Slot> m_Slots;
+    size_t m_Mask = 0;
+    size_t m_Size = 0;
+    IndexTripletMapStats m_Stats{};
+};
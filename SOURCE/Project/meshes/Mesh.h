@@ -1,13 +1,16 @@
 #pragma once
 #include "vulkan/vulkan_core.h"
 #include <vector>
+#include <memory>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "Vertex.h"
+#include <meshes/MeshAsset.h>
+#include "Frustum.h"
 #include "DescriptorPool.h"
-#include "buffers/DataBuffer.h"
 #include "buffers/CommandBuffer.h"
 #include "texture/Material.h"
 #include <physicsEngine/PhysicsEngine.h>
@@ -24,7 +27,9 @@ enum class ShapeType {
 template <typename VertexType>
 class Mesh {
 public:
-    void initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, const std::vector<VertexType> vertices, std::vector<uint32_t> indices);
+    // Uploads the given geometry as an asset owned by this mesh alone. Meshes that share geometry
+    // should be given an asset with setAsset() instead; SceneBase::addMesh then skips the upload.
+    void initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices);
     void draw(CommandBuffer commandBuffer) const;
     void cleanUp(const VkDevice& device);
 
@@ -33,6 +38,33 @@ public:
 
     void setVertices(const std::vector<VertexType>& vertices) { m_Vertices = vertices; }
     void setIndices(const std::vector<uint32_t>& indices) { m_Indices = indices; }
+    void setVertices(const VertexType* vertices, size_t vertexCount) { m_Vertices.assign(vertices, vertices + vertexCount); }
+    void setIndices(const uint32_t* indices, size_t indexCount) { m_Indices.assign(indices, indices + indexCount); }
+    void setVertices(std::vector<VertexType>&& vertices) { m_Vertices = std::move(vertices); }
+    void setIndices(std::vector<uint32_t>&& indices) { m_Indices = std::move(indices); }
+
+    // Keeps getVertices() and getIndices() filled after initialize(), for code that reads the
+    // geometry on the CPU. Off by default; initialize() packs it straight into staging memory and
+    // then frees it.
+    void setKeepCpuGeometry(bool keep) { m_KeepCpuGeometry = keep; }
+
+    void setAsset(const std::shared_ptr<MeshAsset<VertexType>>& asset) { m_pAsset = asset; m_CurrentLod = 0; }
+    const std::shared_ptr<MeshAsset<VertexType>>& getAsset() const { return m_pAsset; }
+
+    const glm::vec3& getPositionScale() const { return m_pAsset->getPositionScale(); }
+    const glm::vec3& getPositionBias() const { return m_pAsset->getPositionBias(); }
+
+    uint32_t getCurrentLod() const { return m_CurrentLod; }
+
+    // Picks the coarsest LOD whose projected error stays under lodPixelError pixels. pixelScale is
+    // the screen height in pixels over 2 * tan(fov / 2), i.e. pixels per unit at distance 1.
+    void selectLod(const glm::vec3& cameraPosition, float pixelScale);
+
+    // Tests the bounding sphere against the frustum and, at LOD 0, every meshlet against the
+    // frustum and its normal cone. draw() then submits only the surviving index ranges, with
+    // neighbouring survivors merged into one draw.
+    void cull(const Frustum& frustum, const glm::vec3& cameraPosition);
+    bool isCulled() const { return m_UseDrawRanges && m_DrawRanges.empty(); }
 
     static Mesh<Vertex2D> CreateRectangle(glm::vec2 center, float width, float height, const glm::vec3& color);
     static Mesh<Vertex2D> CreateRectangle(glm::vec2 center, float width, float height, const std::vector<glm::vec3>& colors);
@@ -49,86 +81,157 @@ public:
     std::shared_ptr<Material> m_pMaterial{};
     std::unique_ptr<btRigidBody> m_pPhysicsBody = nullptr;
 private:
-    std::unique_ptr<DataBuffer> m_pVertexBuffer{};
-    std::unique_ptr<DataBuffer> m_pIndexBuffer{};
+    std::shared_ptr<MeshAsset<VertexType>> m_pAsset{};
 
+    // Only holds geometry until initialize() has uploaded it, unless m_KeepCpuGeometry is set.
     std::vector<VertexType> m_Vertices{};
     std::vector<uint32_t> m_Indices{};
+    bool m_KeepCpuGeometry = false;
 
     float m_BoundingBoxWidth{};
     float m_BoundingBoxHeight{};
     float m_BoundingBoxDepth{};
     bool m_ImpulseApplied = false;
+
+    static constexpr float lodPixelError = 1.0f;
+    // Switching to a coarser LOD needs the error this far below the threshold, so meshes sitting
+    // right at a switching distance do not flicker between two levels.
+    static constexpr float lodHysteresis = 0.2f;
+
+    struct DrawRange {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    float getWorldScale() const;
+
+    uint32_t m_CurrentLod = 0;
+    std::vector<DrawRange> m_DrawRanges{};
+    bool m_UseDrawRanges = false;
 };
 
 
 
 template <typename VertexType>
-void Mesh<VertexType>::initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, const std::vector<VertexType> vertices, std::vector<uint32_t> indices) {
-    m_Vertices = vertices;
-    m_Indices = indices;
-
-    size_t vertexBufferSize = sizeof(VertexType) * m_Vertices.size();
-    size_t indexBufferSize = sizeof(uint32_t) * m_Indices.size();
-
-    auto stagingVertexBuffer = std::make_unique<DataBuffer>(
-        physDevice,
-        device,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        vertexBufferSize
-    );
-
-    stagingVertexBuffer->upload(vertexBufferSize, m_Vertices.data());
-
-    m_pVertexBuffer = std::make_unique<DataBuffer>(
-        physDevice,
-        device,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        vertexBufferSize
-    );
-
-
-    stagingVertexBuffer->copyBuffer(queueFamily, *m_pVertexBuffer, graphicsQueue);
-    stagingVertexBuffer->cleanup(device);
-
-    auto stagingIndexBuffer = std::make_unique<DataBuffer>(
-        physDevice,
-        device,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        indexBufferSize
-    );
-
-
-    stagingIndexBuffer->upload(indexBufferSize, m_Indices.data());
-
-    m_pIndexBuffer = std::make_unique<DataBuffer>(
-        physDevice,
-        device,
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        indexBufferSize
-    );
-
-    stagingIndexBuffer->copyBuffer(queueFamily, *m_pIndexBuffer, graphicsQueue);
-    stagingIndexBuffer->cleanup(device);
+void Mesh<VertexType>::initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices) {
+    m_pAsset = std::make_shared<MeshAsset<VertexType>>(device, physDevice, queueFamily, graphicsQueue, vertices, indices);
+    m_CurrentLod = 0;
+
+    if (!m_KeepCpuGeometry) {
+        std::vector<VertexType>().swap(m_Vertices);
+        std::vector<uint32_t>().swap(m_Indices);
+    }
 }
 
 template <typename VertexType>
 void Mesh<VertexType>::draw(CommandBuffer commandBuffer) const {
-    VkBuffer vertexBuffers[] = { m_pVertexBuffer->getVkBuffer() };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(commandBuffer.getVkCommandBuffer(), 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(commandBuffer.getVkCommandBuffer(), m_pIndexBuffer->getVkBuffer(), 0, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(commandBuffer.getVkCommandBuffer(), static_cast<uint32_t>(m_Indices.size()), 1, 0, 0, 0);
+    m_pAsset->bind(commandBuffer);
+
+    const std::vector<MeshLod>& lods = m_pAsset->getLods();
+    if (m_UseDrawRanges) {
+        for (const DrawRange& range : m_DrawRanges) {
+            vkCmdDrawIndexed(commandBuffer.getVkCommandBuffer(), range.indexCount, 1, range.firstIndex, 0, 0);
+        }
+    }
+    else if (lods.empty()) {
+        vkCmdDrawIndexed(commandBuffer.getVkCommandBuffer(), m_pAsset->getIndexCount(), 1, 0, 0, 0);
+    }
+    else {
+        const MeshLod& lod = lods[m_CurrentLod];
+        vkCmdDrawIndexed(commandBuffer.getVkCommandBuffer(), lod.indexCount, 1, lod.indexOffset, 0, 0);
+    }
+}
+
+template <typename VertexType>
+void Mesh<VertexType>::selectLod(const glm::vec3& cameraPosition, float pixelScale) {
+    const std::vector<MeshLod>& lods = m_pAsset->getLods();
+    if (lods.size() < 2) {
+        m_CurrentLod = 0;
+        return;
+    }
+
+    float worldScale = getWorldScale();
+    glm::vec3 worldCenter = glm::vec3(m_ModelMatrix * glm::vec4(m_pAsset->getBoundingCenter(), 1.0f));
+    float distance = std::max(glm::length(worldCenter - cameraPosition) - m_pAsset->getBoundingRadius() * worldScale, 0.001f);
+    float pixelsPerUnit = worldScale * pixelScale / distance;
+
+    uint32_t selectedLod = 0;
+    for (uint32_t lod = 1; lod < lods.size(); ++lod) {
+        float threshold = lod > m_CurrentLod ? lodPixelError * (1.0f - lodHysteresis) : lodPixelError;
+        if (lods[lod].error * pixelsPerUnit > threshold) {
+            break;
+        }
+        selectedLod = lod;
+    }
+    m_CurrentLod = selectedLod;
+}
+
+template <typename VertexType>
+float Mesh<VertexType>::getWorldScale() const {
+    return std::max({
+        glm::length(glm::vec3(m_ModelMatrix[0])),
+        glm::length(glm::vec3(m_ModelMatrix[1])),
+        glm::length(glm::vec3(m_ModelMatrix[2]))
+    });
+}
+
+template <typename VertexType>
+void Mesh<VertexType>::cull(const Frustum& frustum, const glm::vec3& cameraPosition) {
+    m_DrawRanges.clear();
+    m_UseDrawRanges = true;
+
+    float worldScale = getWorldScale();
+
+    if (m_pAsset->getBoundingRadius() > 0.0f) {
+        glm::vec3 worldCenter = glm::vec3(m_ModelMatrix * glm::vec4(m_pAsset->getBoundingCenter(), 1.0f));
+        if (!frustum.intersectsSphere(worldCenter, m_pAsset->getBoundingRadius() * worldScale)) {
+            return;
+        }
+    }
+
+    const std::vector<MeshLod>& lods = m_pAsset->getLods();
+    const std::vector<Meshlet>& meshlets = m_pAsset->getMeshlets();
+    if (meshlets.empty() || m_CurrentLod != 0) {
+        if (lods.empty()) {
+            m_DrawRanges.push_back({ 0, m_pAsset->getIndexCount() });
+        }
+        else {
+            m_DrawRanges.push_back({ lods[m_CurrentLod].indexOffset, lods[m_CurrentLod].indexCount });
+        }
+        return;
+    }
+
+    glm::mat3 normalMatrix = glm::mat3(m_ModelMatrix);
+
+    for (const Meshlet& meshlet : meshlets) {
+        glm::vec3 center = glm::vec3(m_ModelMatrix * glm::vec4(meshlet.center, 1.0f));
+        float radius = meshlet.radius * worldScale;
+
+        if (!frustum.intersectsSphere(center, radius)) {
+            continue;
+        }
+
+        if (meshlet.coneCutoff < 1.0f) {
+            glm::vec3 axis = glm::normalize(normalMatrix * meshlet.coneAxis);
+            glm::vec3 toCenter = center - cameraPosition;
+            if (glm::dot(toCenter, axis) >= meshlet.coneCutoff * glm::length(toCenter) + radius) {
+                continue;
+            }
+        }
+
+        if (!m_DrawRanges.empty() && m_DrawRanges.back().firstIndex + m_DrawRanges.back().indexCount == meshlet.indexOffset) {
+            m_DrawRanges.back().indexCount += meshlet.indexCount;
+        }
+        else {
+            m_DrawRanges.push_back({ meshlet.indexOffset, meshlet.indexCount });
+        }
+    }
 }
 
+// Drops this instance's reference; the asset's buffers are freed with the last one.
 template <typename VertexType>
 void Mesh<VertexType>::cleanUp(const VkDevice& device) {
-    m_pVertexBuffer->cleanup(device);
-    m_pIndexBuffer->cleanup(device);
+    m_pAsset.reset();
 }
 
 template <typename VertexType>
@@ -0,0 +1,218 @@
+#pragma once
+#include "vulkan/vulkan_core.h"
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <glm/glm.hpp>
+#include "Vertex.h"
+#include <meshes/MeshLod.h>
+#include <meshes/Meshlet.h>
+#include <meshes/VertexQuantization.h>
+#include <meshes/PackedMesh.h>
+#include "buffers/DataBuffer.h"
+#include "buffers/StagingBuffer.h"
+#include "buffers/CommandBuffer.h"
+
+// Geometry shared by every mesh instance drawn from the same source: the device-local vertex and
+// index buffers plus the data needed to pick and cull ranges of them. Instances hold it through a
+// shared_ptr; the buffers are released when the last instance lets go.
+template <typename VertexType>
+class MeshAsset {
+public:
+    using GpuVertex = typename GpuVertexFormat<VertexType>::Type;
+
+    // Fill mapped staging memory with every vertex in the GPU layout, or every index as indexType.
+    // They return false if the geometry cannot be produced, e.g. corrupt compressed data.
+    using VertexWriter = std::function<bool(GpuVertex* destination)>;
+    using IndexWriter = std::function<bool(void* destination, VkIndexType indexType)>;
+
+    // Packs the arrays straight into staging memory. Without a staging buffer a temporary one is
+    // created for this upload.
+    MeshAsset(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices, StagingBuffer* pStaging = nullptr);
+
+    // Lets the writers produce the geometry in place, e.g. straight out of a decoder, so it never
+    // exists as a full-size CPU array. writeVertices must quantize with positionScale and
+    // positionBias. Throws if a writer fails.
+    MeshAsset(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, StagingBuffer& staging,
+        size_t vertexCount, size_t indexCount, const glm::vec3& positionScale, const glm::vec3& positionBias, const VertexWriter& writeVertices, const IndexWriter& writeIndices);
+
+    // Copies geometry that a worker thread already packed into staging memory as it is. Only valid
+    // for vertex types whose GPU layout is PackedMesh::GpuVertex; throws otherwise.
+    MeshAsset(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, StagingBuffer& staging, const PackedMesh& packedMesh);
+    ~MeshAsset();
+
+    MeshAsset(const MeshAsset&) = delete;
+    MeshAsset& operator=(const MeshAsset&) = delete;
+
+    void bind(CommandBuffer commandBuffer) const;
+
+    uint32_t getVertexCount() const { return m_VertexCount; }
+    uint32_t getIndexCount() const { return m_IndexCount; }
+    VkIndexType getIndexType() const { return m_IndexType; }
+    VkDeviceSize getGpuMemorySize() const { return m_pVertexBuffer->getSizeInBytes() + m_pIndexBuffer->getSizeInBytes(); }
+
+    static VkIndexType getIndexType(size_t vertexCount) { return PackedMesh::getIndexType(vertexCount); }
+    static size_t getIndexSize(VkIndexType indexType) { return PackedMesh::getIndexSize(indexType); }
+    static void storeIndices(const uint32_t* indices, size_t indexCount, VkIndexType indexType, void* destination) { PackedMesh::storeIndices(indices, indexCount, indexType, destination); }
+
+    // Expands GPU positions back to object space: position = stored * scale + bias.
+    const glm::vec3& getPositionScale() const { return m_PositionScale; }
+    const glm::vec3& getPositionBias() const { return m_PositionBias; }
+
+    // The index buffer may hold several LODs back to back; without LODs the whole buffer is drawn.
+    void setLods(const MeshLod* lods, size_t lodCount) { m_Lods.assign(lods, lods + lodCount); }
+    const std::vector<MeshLod>& getLods() const { return m_Lods; }
+
+    // Meshlets index into LOD 0 and are only used while it is selected.
+    void setMeshlets(const Meshlet* meshlets, size_t meshletCount) { m_Meshlets.assign(meshlets, meshlets + meshletCount); }
+    const std::vector<Meshlet>& getMeshlets() const { return m_Meshlets; }
+
+    // Assets built in code have no bounding sphere (radius 0) and are never frustum culled.
+    void setBoundingSphere(const glm::vec3& center, float radius) { m_BoundingCenter = center; m_BoundingRadius = radius; }
+    const glm::vec3& getBoundingCenter() const { return m_BoundingCenter; }
+    float getBoundingRadius() const { return m_BoundingRadius; }
+
+private:
+    void upload(const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, StagingBuffer& staging, const VertexWriter& writeVertices, const IndexWriter& writeIndices);
+
+    VkDevice m_Device;
+
+    std::unique_ptr<DataBuffer> m_pVertexBuffer{};
+    std::unique_ptr<DataBuffer> m_pIndexBuffer{};
+
+    uint32_t m_VertexCount = 0;
+    uint32_t m_IndexCount = 0;
+    VkIndexType m_IndexType = VK_INDEX_TYPE_UINT32;
+
+    glm::vec3 m_PositionScale{ 1.0f };
+    glm::vec3 m_PositionBias{ 0.0f };
+
+    std::vector<MeshLod> m_Lods{};
+    std::vector<Meshlet> m_Meshlets{};
+    glm::vec3 m_BoundingCenter{ 0.0f };
+    float m_BoundingRadius = 0.0f;
+};
+
+
+
+template <typename VertexType>
+MeshAsset<VertexType>::MeshAsset(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices, StagingBuffer* pStaging)
+    : m_Device(device)
+    , m_VertexCount(static_cast<uint32_t>(vertices.size()))
+    , m_IndexCount(static_cast<uint32_t>(indices.size())) {
+    GpuVertexFormat<VertexType>::getQuantization(vertices.data(), vertices.size(), m_PositionScale, m_PositionBias);
+
+    auto writeVertices = [&](GpuVertex* destination) {
+        GpuVertexFormat<VertexType>::pack(vertices.data(), vertices.size(), m_PositionScale, m_PositionBias, destination);
+        return true;
+    };
+    auto writeIndices = [&](void* destination, VkIndexType indexType) {
+        storeIndices(indices.data(), indices.size(), indexType, destination);
+        return true;
+    };
+
+    if (pStaging != nullptr) {
+        upload(physDevice, queueFamily, graphicsQueue, *pStaging, writeVertices, writeIndices);
+        return;
+    }
+
+    StagingBuffer staging{};
+    staging.initialize(physDevice, device);
+    upload(physDevice, queueFamily, graphicsQueue, staging, writeVertices, writeIndices);
+    staging.cleanup();
+}
+
+template <typename VertexType>
+MeshAsset<VertexType>::MeshAsset(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, StagingBuffer& staging,
+    size_t vertexCount, size_t indexCount, const glm::vec3& positionScale, const glm::vec3& positionBias, const VertexWriter& writeVertices, const IndexWriter& writeIndices)
+    : m_Device(device)
+    , m_VertexCount(static_cast<uint32_t>(vertexCount))
+    , m_IndexCount(static_cast<uint32_t>(indexCount))
+    , m_PositionScale(positionScale)
+    , m_PositionBias(positionBias) {
+    upload(physDevice, queueFamily, graphicsQueue, staging, writeVertices, writeIndices);
+}
+
+template <typename VertexType>
+MeshAsset<VertexType>::MeshAsset(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, StagingBuffer& staging, const PackedMesh& packedMesh)
+    : m_Device(device)
+    , m_VertexCount(static_cast<uint32_t>(packedMesh.vertexCount))
+    , m_IndexCount(static_cast<uint32_t>(packedMesh.indexCount))
+    , m_PositionScale(packedMesh.positionScale)
+    , m_PositionBias(packedMesh.positionBias) {
+    if (sizeof(GpuVertex) != sizeof(PackedMesh::GpuVertex)) {
+        throw std::runtime_error("packed mesh does not match the vertex type!");
+    }
+
+    auto writeVertices = [&](GpuVertex* destination) {
+        std::memcpy(destination, packedMesh.getVertexData(), packedMesh.getVertexDataSize());
+        return true;
+    };
+    auto writeIndices = [&](void* destination, VkIndexType indexType) {
+        if (indexType != packedMesh.indexType) {
+            return false;
+        }
+        std::memcpy(destination, packedMesh.getIndexData(), packedMesh.getIndexDataSize());
+        return true;
+    };
+    upload(physDevice, queueFamily, graphicsQueue, staging, writeVertices, writeIndices);
+
+    setLods(packedMesh.lods.data(), packedMesh.lods.size());
+    setMeshlets(packedMesh.meshlets.data(), packedMesh.meshlets.size());
+    setBoundingSphere(packedMesh.bounds.getCenter(), packedMesh.bounds.getRadius());
+}
+
+template <typename VertexType>
+void MeshAsset<VertexType>::upload(const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue, StagingBuffer& staging, const VertexWriter& writeVertices, const IndexWriter& writeIndices) {
+    m_IndexType = getIndexType(m_VertexCount);
+
+    VkDeviceSize vertexBufferSize = sizeof(GpuVertex) * m_VertexCount;
+    VkDeviceSize indexBufferSize = getIndexSize(m_IndexType) * m_IndexCount;
+
+    // Vertices and indices share the staging buffer and go over in one submission.
+    VkDeviceSize indexOffset = PackedMesh::getIndexOffset(static_cast<size_t>(vertexBufferSize));
+    staging.reserve(indexOffset + indexBufferSize);
+
+    uint8_t* stagingData = static_cast<uint8_t*>(staging.getData());
+    if (!writeVertices(reinterpret_cast<GpuVertex*>(stagingData)) || !writeIndices(stagingData + indexOffset, m_IndexType)) {
+        throw std::runtime_error("failed to write mesh geometry!");
+    }
+
+    m_pVertexBuffer = std::make_unique<DataBuffer>(
+        physDevice,
+        m_Device,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        vertexBufferSize
+    );
+
+    m_pIndexBuffer = std::make_unique<DataBuffer>(
+        physDevice,
+        m_Device,
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        indexBufferSize
+    );
+
+    const StagingBuffer::Copy copies[] = {
+        { m_pVertexBuffer->getVkBuffer(), 0, vertexBufferSize },
+        { m_pIndexBuffer->getVkBuffer(), indexOffset, indexBufferSize }
+    };
+    staging.copyTo(queueFamily, graphicsQueue, copies, 2);
+}
+
+template <typename VertexType>
+MeshAsset<VertexType>::~MeshAsset() {
+    m_pVertexBuffer->cleanup(m_Device);
+    m_pIndexBuffer->cleanup(m_Device);
+}
+
+template <typename VertexType>
+void MeshAsset<VertexType>::bind(CommandBuffer commandBuffer) const {
+    VkBuffer vertexBuffers[] = { m_pVertexBuffer->getVkBuffer() };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer.getVkCommandBuffer(), 0, 1, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer.getVkCommandBuffer(), m_pIndexBuffer->getVkBuffer(), 0, m_IndexType);
+}
@@ -0,0 +1,164 @@
+#include "MeshAssetRegistry.h"
+#include <chrono>
+#include <iostream>
+
+void MeshAssetRegistry::initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue) {
+    m_Device = device;
+    m_PhysDevice = physDevice;
+    m_QueueFamily = queueFamily;
+    m_GraphicsQueue = graphicsQueue;
+    m_Staging.initialize(physDevice, device);
+}
+
+void MeshAssetRegistry::cleanup() {
+    m_Staging.cleanup();
+}
+
+std::string MeshAssetRegistry::getKey(const std::string& sourcePath, const MeshProcessingOptions& options) {
+    return sourcePath + '#' + std::to_string(options.getKey());
+}
+
+std::string MeshAssetRegistry::getPrimitiveKey(const std::string& key, size_t primitiveIndex) {
+    return key + '/' + std::to_string(primitiveIndex);
+}
+
+std::shared_ptr<MeshAsset<Vertex3D_PBR>> MeshAssetRegistry::findAsset(const std::string& key) {
+    auto it = m_Entries.find(key);
+    if (it == m_Entries.end()) {
+        return nullptr;
+    }
+
+    auto asset = it->second.asset.lock();
+    if (asset) {
+        ++m_ReuseCount;
+        m_SavedBytes += it->second.gpuMemorySize;
+        m_SavedMilliseconds += it->second.loadMilliseconds;
+    }
+    return asset;
+}
+
+std::shared_ptr<MeshAsset<Vertex3D_PBR>> MeshAssetRegistry::loadObj(const std::string& objPath, const MeshProcessingOptions& options) {
+    std::string key = getKey(objPath, options);
+    if (auto asset = findAsset(key)) {
+        return asset;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    CachedMesh meshData;
+    if (!MeshCache::loadObj(objPath, meshData, options, MeshGeometryAccess::UploadOnly)) {
+        return nullptr;
+    }
+
+    double loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return uploadAsset(objPath, key, meshData, loadMilliseconds);
+}
+
+std::vector<std::shared_ptr<MeshAsset<Vertex3D_PBR>>> MeshAssetRegistry::loadGlb(const std::string& glbPath, const MeshProcessingOptions& options) {
+    std::string key = getKey(glbPath, options);
+    std::vector<std::shared_ptr<MeshAsset<Vertex3D_PBR>>> assets;
+
+    auto countIt = m_PrimitiveCounts.find(key);
+    if (countIt != m_PrimitiveCounts.end()) {
+        bool allAlive = true;
+        for (size_t i = 0; i < countIt->second && allAlive; ++i) {
+            auto it = m_Entries.find(getPrimitiveKey(key, i));
+            allAlive = it != m_Entries.end() && !it->second.asset.expired();
+        }
+        if (allAlive) {
+            for (size_t i = 0; i < countIt->second; ++i) {
+                assets.push_back(findAsset(getPrimitiveKey(key, i)));
+            }
+            return assets;
+        }
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<CachedMesh> primitives;
+    if (!MeshCache::loadGlb(glbPath, primitives, options, MeshGeometryAccess::UploadOnly)) {
+        return assets;
+    }
+    m_PrimitiveCounts[key] = primitives.size();
+
+    double loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        std::string primitiveKey = getPrimitiveKey(key, i);
+        auto asset = findAsset(primitiveKey);
+        if (!asset) {
+            asset = uploadAsset(glbPath + " primitive " + std::to_string(i), primitiveKey, primitives[i], loadMilliseconds / primitives.size());
+        }
+        assets.push_back(asset);
+    }
+    return assets;
+}
+
+std::shared_ptr<MeshAsset<Vertex3D_PBR>> MeshAssetRegistry::addObj(const std::string& objPath, const MeshProcessingOptions& options, const PackedMesh& packedMesh) {
+    std::string key = getKey(objPath, options);
+    if (auto asset = findAsset(key)) {
+        return asset;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto asset = std::make_shared<MeshAsset<Vertex3D_PBR>>(m_Device, m_PhysDevice, m_QueueFamily, m_GraphicsQueue, m_Staging, packedMesh);
+    double uploadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return registerAsset(objPath, key, asset, packedMesh.data.size(), uploadMilliseconds);
+}
+
+std::shared_ptr<MeshAsset<Vertex3D_PBR>> MeshAssetRegistry::uploadAsset(const std::string& name, const std::string& key, const CachedMesh& meshData, double loadMilliseconds) {
+    using GpuFormat = GpuVertexFormat<Vertex3D_PBR>;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // The cache's bounds are exactly the vertex bounds, so the quantization is known before any
+    // vertex is decoded.
+    glm::vec3 positionScale;
+    glm::vec3 positionBias;
+    GpuFormat::getQuantization(meshData.getBounds().min, meshData.getBounds().max, positionScale, positionBias);
+
+    auto writeVertices = [&](GpuFormat::Type* destination) {
+        return meshData.decodeVertices([&](const Vertex3D_PBR* vertices, size_t firstVertex, size_t vertexCount) {
+            GpuFormat::pack(vertices, vertexCount, positionScale, positionBias, destination + firstVertex);
+        });
+    };
+    auto writeIndices = [&](void* destination, VkIndexType indexType) {
+        size_t indexSize = MeshAsset<Vertex3D_PBR>::getIndexSize(indexType);
+        return meshData.decodeIndices([&](const uint32_t* indices, size_t firstIndex, size_t indexCount) {
+            MeshAsset<Vertex3D_PBR>::storeIndices(indices, indexCount, indexType, static_cast<uint8_t*>(destination) + firstIndex * indexSize);
+        });
+    };
+
+    auto asset = std::make_shared<MeshAsset<Vertex3D_PBR>>(m_Device, m_PhysDevice, m_QueueFamily, m_GraphicsQueue, m_Staging,
+        meshData.getVertexCount(), meshData.getIndexCount(), positionScale, positionBias, writeVertices, writeIndices);
+
+    asset->setLods(meshData.getLods(), meshData.getLodCount());
+    asset->setMeshlets(meshData.getMeshlets(), meshData.getMeshletCount());
+    asset->setBoundingSphere(meshData.getBounds().getCenter(), meshData.getBounds().getRadius());
+
+    size_t copiedBytes = meshData.hasCpuGeometry() ? meshData.getVertexCount() * sizeof(Vertex3D_PBR) + meshData.getIndexCount() * sizeof(uint32_t) : 0;
+    return registerAsset(name, key, asset, copiedBytes, loadMilliseconds + std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+}
+
+std::shared_ptr<MeshAsset<Vertex3D_PBR>> MeshAssetRegistry::registerAsset(const std::string& name, const std::string& key, const std::shared_ptr<MeshAsset<Vertex3D_PBR>>& asset, size_t copiedBytes, double loadMilliseconds) {
+    size_t stagedBytes = static_cast<size_t>(asset->getGpuMemorySize());
+    m_StagedBytes += stagedBytes;
+    m_CopiedBytes += copiedBytes;
+    std::cout << "Uploaded " << name << ": " << stagedBytes << " bytes written to staging, " << copiedBytes << " bytes copied through CPU arrays" << std::endl;
+
+    Entry& entry = m_Entries[key];
+    entry.asset = asset;
+    entry.gpuMemorySize = asset->getGpuMemorySize();
+    entry.loadMilliseconds = loadMilliseconds;
+
+    ++m_LoadCount;
+    m_UploadedBytes += entry.gpuMemorySize;
+    m_LoadMilliseconds += entry.loadMilliseconds;
+
+    return asset;
+}
+
+void MeshAssetRegistry::printStatistics() const {
+    std::cout << "Mesh assets: " << m_LoadCount << " loaded (" << m_UploadedBytes / 1024.0 << " KiB on the GPU, "
+        << m_LoadMilliseconds << " ms), " << m_ReuseCount << " instances shared them, saving "
+        << m_SavedBytes / 1024.0 << " KiB of GPU memory and about " << m_SavedMilliseconds << " ms of loading; "
+        << m_StagedBytes / 1024.0 << " KiB written to staging, " << m_CopiedBytes / 1024.0 << " KiB copied through CPU arrays" << std::endl;
+}
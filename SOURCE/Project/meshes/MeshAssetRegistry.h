@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <meshes/MeshAsset.h>
+#include <meshes/MeshCache.h>
+#include <meshes/PackedMesh.h>
+
+// Loads each OBJ or GLB primitive once per set of processing options and hands out shared references to the
+// uploaded asset. Entries are weak, so an asset is freed as soon as no mesh uses it anymore and
+// is loaded again on the next request.
+class MeshAssetRegistry {
+public:
+    void initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue);
+    void cleanup();
+
+    // Returns nullptr if the OBJ could not be loaded.
+    std::shared_ptr<MeshAsset<Vertex3D_PBR>> loadObj(const std::string& objPath, const MeshProcessingOptions& options = {});
+
+    // Returns one asset per primitive of the GLB, in file order, for Mesh::setAsset, or an empty
+    // vector if the file could not be loaded. Primitives that are still alive are shared.
+    std::vector<std::shared_ptr<MeshAsset<Vertex3D_PBR>>> loadGlb(const std::string& glbPath, const MeshProcessingOptions& options = {});
+
+    // Uploads a mesh an AssetLoader worker has already decoded, quantized and narrowed, unless an
+    // asset for the same source and options is still alive. Its bytes are copied into the
+    // registry's persistently mapped staging buffer as they are.
+    std::shared_ptr<MeshAsset<Vertex3D_PBR>> addObj(const std::string& objPath, const MeshProcessingOptions& options, const PackedMesh& packedMesh);
+
+    // Logs how many loads were served from the registry and the GPU memory and load time that saved
+    // compared to loading and uploading every instance on its own, and the bytes the CPU copied.
+    void printStatistics() const;
+
+private:
+    static std::string getKey(const std::string& sourcePath, const MeshProcessingOptions& options);
+    static std::string getPrimitiveKey(const std::string& key, size_t primitiveIndex);
+    std::shared_ptr<MeshAsset<Vertex3D_PBR>> findAsset(const std::string& key);
+    // Decodes, quantizes and narrows compressed geometry block by block straight into staging.
+    std::shared_ptr<MeshAsset<Vertex3D_PBR>> uploadAsset(const std::string& name, const std::string& key, const CachedMesh& meshData, double loadMilliseconds);
+    std::shared_ptr<MeshAsset<Vertex3D_PBR>> registerAsset(const std::string& name, const std::string& key, const std::shared_ptr<MeshAsset<Vertex3D_PBR>>& asset, size_t copiedBytes, double loadMilliseconds);
+
+    struct Entry {
+        std::weak_ptr<MeshAsset<Vertex3D_PBR>> asset;
+        VkDeviceSize gpuMemorySize = 0;
+        double loadMilliseconds = 0.0;
+    };
+
+    VkDevice m_Device{};
+    VkPhysicalDevice m_PhysDevice{};
+    QueueFamilyIndices m_QueueFamily{};
+    VkQueue m_GraphicsQueue{};
+    StagingBuffer m_Staging{};
+
+    std::unordered_map<std::string, Entry> m_Entries;
+    // Primitive count of each GLB key, so a fully shared GLB is found without reading the file.
+    std::unordered_map<std::string, size_t> m_PrimitiveCounts;
+
+    uint32_t m_LoadCount = 0;
+    uint32_t m_ReuseCount = 0;
+    VkDeviceSize m_UploadedBytes = 0;
+    VkDeviceSize m_SavedBytes = 0;
+    // Bytes written into staging memory, and bytes that went through a full-size CPU array first.
+    size_t m_StagedBytes = 0;
+    size_t m_CopiedBytes = 0;
+    double m_LoadMilliseconds = 0.0;
+    double m_SavedMilliseconds = 0.0;
+};
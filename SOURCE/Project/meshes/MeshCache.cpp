@@ -0,0 +1,362 @@
+#include "MeshCache.h"
+#include <loadObjFile.h>
+#include <io/ContentHash.h>
+#include <io/SourceStamp.h>
+#include <io/TemporaryFile.h>
+#include <meshes/MeshSimplifier.h>
+#include <meshes/MeshletBuilder.h>
+#include <meshes/GeometryCodec.h>
+#include <meshes/TangentGenerator.h>
+#include <meshes/GltfLoader.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace {
+    constexpr char meshCacheMagic[8] = { 'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0' };
+
+    uint64_t alignOffset(uint64_t offset, uint64_t alignment) {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+MeshProcessingOptions MeshProcessingOptions::createMinimal() {
+    MeshProcessingOptions options{};
+    options.optimizer.optimizeVertexCache = false;
+    options.optimizer.optimizeOverdraw = false;
+    options.lods.maxLodCount = 1;
+    options.meshlets.buildMeshlets = false;
+    options.ambientOcclusion.bakeAmbientOcclusion = false;
+    return options;
+}
+
+uint64_t MeshProcessingOptions::getKey() const {
+    return ContentHash::mix(optimizer.getKey() ^ ContentHash::mix(lods.getKey() ^ ContentHash::mix(meshlets.getKey() ^ ContentHash::mix(ambientOcclusion.getKey()))));
+}
+
+std::string MeshCache::getCachePath(const std::string& sourcePath, uint64_t processingKey) {
+    std::ostringstream path;
+    path << sourcePath << '.' << std::hex << std::setw(16) << std::setfill('0') << processingKey << ".meshbin";
+    return path.str();
+}
+
+std::string MeshCache::getPrimitiveCachePath(const std::string& glbPath, size_t primitiveIndex, uint64_t processingKey) {
+    return getCachePath(glbPath + '.' + std::to_string(primitiveIndex), processingKey);
+}
+
+MeshBounds MeshCache::computeBounds(const Vertex3D_PBR* vertices, size_t vertexCount) {
+    MeshBounds bounds{};
+    if (vertexCount == 0) {
+        return bounds;
+    }
+
+    bounds.min = vertices[0].pos;
+    bounds.max = vertices[0].pos;
+    for (size_t i = 1; i < vertexCount; ++i) {
+        bounds.min = glm::min(bounds.min, vertices[i].pos);
+        bounds.max = glm::max(bounds.max, vertices[i].pos);
+    }
+    return bounds;
+}
+
+bool CachedMesh::decodeVertices(const VertexBlockCallback& callback) const {
+    if (m_pEncodedVertices == nullptr) {
+        callback(m_pVertices, 0, m_VertexCount);
+        return true;
+    }
+
+    return GeometryCodec::decodeVertexBlocks(m_VertexCount, sizeof(Vertex3D_PBR), m_pEncodedVertices, m_EncodedVertexSize, [&](const void* vertices, size_t firstVertex, size_t vertexCount) {
+        callback(static_cast<const Vertex3D_PBR*>(vertices), firstVertex, vertexCount);
+    });
+}
+
+bool CachedMesh::decodeIndices(const GeometryCodec::IndexBlockCallback& callback) const {
+    if (m_pEncodedIndices == nullptr) {
+        callback(m_pIndices, 0, m_IndexCount);
+        return true;
+    }
+
+    return GeometryCodec::decodeIndexBlocks(m_IndexCount, m_pEncodedIndices, m_EncodedIndexSize, callback);
+}
+
+bool MeshCache::openCache(const std::string& sourcePath, uint64_t processingKey, CachedMesh& cachedMesh, MeshGeometryAccess access) {
+    uint64_t primitiveCount = 0;
+    return openCacheFile(sourcePath, getCachePath(sourcePath, processingKey), processingKey, cachedMesh, access, primitiveCount);
+}
+
+bool MeshCache::openGlbCache(const std::string& glbPath, uint64_t processingKey, std::vector<CachedMesh>& primitives, MeshGeometryAccess access) {
+    primitives.clear();
+    uint64_t primitiveCount = 1;
+    for (size_t i = 0; i < primitiveCount; ++i) {
+        CachedMesh primitive;
+        uint64_t headerPrimitiveCount = 0;
+        if (!openCacheFile(glbPath, getPrimitiveCachePath(glbPath, i, processingKey), processingKey, primitive, access, headerPrimitiveCount) ||
+            (i != 0 && headerPrimitiveCount != primitiveCount)) {
+            primitives.clear();
+            return false;
+        }
+        primitiveCount = headerPrimitiveCount;
+        primitives.push_back(std::move(primitive));
+    }
+    return true;
+}
+
+bool MeshCache::openCacheFile(const std::string& sourcePath, const std::string& cachePath, uint64_t processingKey, CachedMesh& cachedMesh, MeshGeometryAccess access, uint64_t& primitiveCount) {
+    AssetFile file;
+    if (!file.open(cachePath, false) || file.getSize() < sizeof(MeshCacheHeader)) {
+        return false;
+    }
+
+    MeshCacheHeader header{};
+    std::memcpy(&header, file.getData(), sizeof(header));
+
+    if (std::memcmp(header.magic, meshCacheMagic, sizeof(meshCacheMagic)) != 0 || header.version != version || header.vertexStride != sizeof(Vertex3D_PBR) || header.processingKey != processingKey) {
+        return false;
+    }
+    // Written as offset > size || length > size - offset so that corrupt offsets cannot wrap.
+    uint64_t size = file.getSize();
+    if (header.vertexOffset > size || header.vertexDataSize > size - header.vertexOffset ||
+        header.indexOffset > size || header.indexDataSize > size - header.indexOffset ||
+        header.lodOffset > size || header.lodCount > (size - header.lodOffset) / sizeof(MeshLod) ||
+        header.meshletOffset > size || header.meshletCount > (size - header.meshletOffset) / sizeof(Meshlet)) {
+        return false;
+    }
+
+    SourceStamp sourceStamp{ header.sourceModifiedTime, header.sourceSize, header.sourceContentHash };
+    uint64_t touchedTime = 0;
+    if (!sourceStamp.matches(sourcePath, &touchedTime)) {
+        return false;
+    }
+    if (touchedTime != 0 && !file.isPacked()) {
+        SourceStamp::writeModifiedTime(cachePath, offsetof(MeshCacheHeader, sourceModifiedTime), touchedTime);
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file.getData());
+    const uint8_t* encodedVertices = data + header.vertexOffset;
+    const uint8_t* encodedIndices = data + header.indexOffset;
+
+    std::vector<Vertex3D_PBR> vertices;
+    std::vector<uint32_t> indices;
+    if (access == MeshGeometryAccess::CpuCopy) {
+        vertices.resize(static_cast<size_t>(header.vertexCount));
+        indices.resize(static_cast<size_t>(header.indexCount));
+        if (!GeometryCodec::decodeVertices(vertices.data(), vertices.size(), sizeof(Vertex3D_PBR), encodedVertices, static_cast<size_t>(header.vertexDataSize)) ||
+            !GeometryCodec::decodeIndices(indices.data(), indices.size(), encodedIndices, static_cast<size_t>(header.indexDataSize))) {
+            std::cerr << "Corrupt geometry in mesh cache " << cachePath << std::endl;
+            return false;
+        }
+        encodedVertices = nullptr;
+        encodedIndices = nullptr;
+    }
+
+    cachedMesh.m_OwnedVertices = std::move(vertices);
+    cachedMesh.m_OwnedIndices = std::move(indices);
+    cachedMesh.m_pEncodedVertices = encodedVertices;
+    cachedMesh.m_EncodedVertexSize = static_cast<size_t>(header.vertexDataSize);
+    cachedMesh.m_pEncodedIndices = encodedIndices;
+    cachedMesh.m_EncodedIndexSize = static_cast<size_t>(header.indexDataSize);
+    cachedMesh.m_pVertices = encodedVertices == nullptr ? cachedMesh.m_OwnedVertices.data() : nullptr;
+    cachedMesh.m_VertexCount = static_cast<size_t>(header.vertexCount);
+    cachedMesh.m_pIndices = encodedIndices == nullptr ? cachedMesh.m_OwnedIndices.data() : nullptr;
+    cachedMesh.m_IndexCount = static_cast<size_t>(header.indexCount);
+    cachedMesh.m_OwnedLods.clear();
+    cachedMesh.m_OwnedMeshlets.clear();
+    cachedMesh.m_pLods = reinterpret_cast<const MeshLod*>(file.getData() + header.lodOffset);
+    cachedMesh.m_LodCount = static_cast<size_t>(header.lodCount);
+    cachedMesh.m_pMeshlets = reinterpret_cast<const Meshlet*>(file.getData() + header.meshletOffset);
+    cachedMesh.m_MeshletCount = static_cast<size_t>(header.meshletCount);
+    cachedMesh.m_Bounds.min = { header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+    cachedMesh.m_Bounds.max = { header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+    cachedMesh.m_File = std::move(file);
+    primitiveCount = header.primitiveCount;
+    return true;
+}
+
+bool MeshCache::writeCache(const std::string& sourcePath, uint64_t processingKey, const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods, const std::vector<Meshlet>& meshlets) {
+    return writeCacheFile(sourcePath, getCachePath(sourcePath, processingKey), processingKey, 1, vertices, indices, lods, meshlets);
+}
+
+bool MeshCache::writeCacheFile(const std::string& sourcePath, const std::string& cachePath, uint64_t processingKey, uint64_t primitiveCount,
+    const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods, const std::vector<Meshlet>& meshlets) {
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+    header.version = version;
+    header.vertexStride = sizeof(Vertex3D_PBR);
+    header.processingKey = processingKey;
+    header.primitiveCount = primitiveCount;
+
+    SourceStamp sourceStamp{};
+    if (!SourceStamp::read(sourcePath, sourceStamp)) {
+        return false;
+    }
+    header.sourceModifiedTime = sourceStamp.modifiedTime;
+    header.sourceSize = sourceStamp.size;
+    header.sourceContentHash = sourceStamp.contentHash;
+
+    MeshBounds bounds = computeBounds(vertices.data(), vertices.size());
+    std::memcpy(header.boundsMin, &bounds.min, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &bounds.max, sizeof(header.boundsMax));
+
+    std::vector<uint8_t> vertexData = GeometryCodec::encodeVertices(vertices.data(), vertices.size(), sizeof(Vertex3D_PBR));
+    std::vector<uint8_t> indexData = GeometryCodec::encodeIndices(indices.data(), indices.size());
+
+    header.vertexCount = vertices.size();
+    header.indexCount = indices.size();
+    header.vertexDataSize = vertexData.size();
+    header.indexDataSize = indexData.size();
+    header.vertexOffset = alignOffset(sizeof(MeshCacheHeader), 16);
+    header.indexOffset = alignOffset(header.vertexOffset + vertexData.size(), 16);
+    header.lodCount = lods.size();
+    header.lodOffset = alignOffset(header.indexOffset + indexData.size(), 16);
+    header.meshletCount = meshlets.size();
+    header.meshletOffset = alignOffset(header.lodOffset + lods.size() * sizeof(MeshLod), 16);
+
+    std::string temporaryPath = TemporaryFile::getPath(cachePath);
+    bool written = false;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        const char padding[16]{};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding, header.vertexOffset - sizeof(header));
+        file.write(reinterpret_cast<const char*>(vertexData.data()), vertexData.size());
+        file.write(padding, header.indexOffset - (header.vertexOffset + vertexData.size()));
+        file.write(reinterpret_cast<const char*>(indexData.data()), indexData.size());
+        file.write(padding, header.lodOffset - (header.indexOffset + indexData.size()));
+        file.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(MeshLod));
+        file.write(padding, header.meshletOffset - (header.lodOffset + lods.size() * sizeof(MeshLod)));
+        file.write(reinterpret_cast<const char*>(meshlets.data()), meshlets.size() * sizeof(Meshlet));
+
+        file.close();
+        written = file.good();
+    }
+    return TemporaryFile::commit(temporaryPath, cachePath, written);
+}
+
+bool MeshCache::loadObj(const std::string& objPath, CachedMesh& cachedMesh, const MeshProcessingOptions& options, MeshGeometryAccess access) {
+    uint64_t processingKey = options.getKey();
+    if (openCache(objPath, processingKey, cachedMesh, access)) {
+        std::cout << "Mesh cache hit: " << getCachePath(objPath, processingKey) << " (" << cachedMesh.getVertexCount() << " vertices, "
+            << cachedMesh.getIndexCount() << " indices)" << std::endl;
+        return true;
+    }
+
+    std::vector<Vertex3D_PBR> vertices;
+    std::vector<uint32_t> indices;
+    ObjLoader::ObjLoadStats loadStats{};
+    if (!ObjLoader::loadObjFile(objPath, vertices, indices, options.streaming, &loadStats)) {
+        return false;
+    }
+
+    // Streamed blocks come with their tangents.
+    if (!loadStats.streamed) {
+        TangentStats tangentStats = TangentGenerator::generate(vertices, indices);
+        std::cout << "Generated tangents for " << objPath << ": " << tangentStats.triangleCount << " triangles (" << tangentStats.degenerateTriangleCount
+            << " degenerate) in " << tangentStats.milliseconds << " ms on " << tangentStats.threadCount << " threads" << std::endl;
+    }
+
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
+    processGeometry(objPath, vertices, indices, options, lods, meshlets);
+
+    if (writeCache(objPath, processingKey, vertices, indices, lods, meshlets) && openCache(objPath, processingKey, cachedMesh, access)) {
+        std::cout << "Mesh cache written: " << getCachePath(objPath, processingKey) << std::endl;
+        return true;
+    }
+
+    std::cerr << "Could not write mesh cache for " << objPath << ", using parsed data" << std::endl;
+    adoptGeometry(cachedMesh, std::move(vertices), std::move(indices), std::move(lods), std::move(meshlets));
+    return true;
+}
+
+bool MeshCache::loadGlb(const std::string& glbPath, std::vector<CachedMesh>& primitives, const MeshProcessingOptions& options, MeshGeometryAccess access) {
+    uint64_t processingKey = options.getKey();
+    if (openGlbCache(glbPath, processingKey, primitives, access)) {
+        std::cout << "Mesh cache hit: " << glbPath << " (" << primitives.size() << " primitives)" << std::endl;
+        return true;
+    }
+
+    GltfLoader::GltfModel model;
+    if (!GltfLoader::loadGlbFile(glbPath, model)) {
+        return false;
+    }
+    if (model.primitives.empty()) {
+        std::cerr << glbPath << " has no triangle primitives" << std::endl;
+        return false;
+    }
+
+    primitives.clear();
+    primitives.resize(model.primitives.size());
+    for (size_t i = 0; i < model.primitives.size(); ++i) {
+        GltfLoader::GltfPrimitive& primitive = model.primitives[i];
+        std::string name = glbPath + " [" + (primitive.meshName.empty() ? "mesh " + std::to_string(primitive.meshIndex) : primitive.meshName) + ", primitive " + std::to_string(i) + "]";
+
+        std::vector<MeshLod> lods;
+        std::vector<Meshlet> meshlets;
+        processGeometry(name, primitive.vertices, primitive.indices, options, lods, meshlets);
+
+        std::string cachePath = getPrimitiveCachePath(glbPath, i, processingKey);
+        uint64_t primitiveCount = 0;
+        if (writeCacheFile(glbPath, cachePath, processingKey, model.primitives.size(), primitive.vertices, primitive.indices, lods, meshlets) &&
+            openCacheFile(glbPath, cachePath, processingKey, primitives[i], access, primitiveCount)) {
+            std::cout << "Mesh cache written: " << cachePath << std::endl;
+            continue;
+        }
+
+        std::cerr << "Could not write mesh cache for " << name << ", using parsed data" << std::endl;
+        adoptGeometry(primitives[i], std::move(primitive.vertices), std::move(primitive.indices), std::move(lods), std::move(meshlets));
+    }
+    return true;
+}
+
+void MeshCache::processGeometry(const std::string& name, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const MeshProcessingOptions& options,
+    std::vector<MeshLod>& lods, std::vector<Meshlet>& meshlets) {
+    MeshOptimizer::optimize(name, vertices, indices, options.optimizer);
+
+    lods = MeshSimplifier::buildLodChain(vertices, indices, options.lods, options.optimizer.cacheSize);
+    std::cout << "Built " << lods.size() << " LODs for " << name << ":";
+    for (const MeshLod& lod : lods) {
+        std::cout << " " << lod.indexCount / 3 << " triangles (error " << lod.error << ")";
+    }
+    std::cout << std::endl;
+
+    if (options.meshlets.buildMeshlets) {
+        meshlets = MeshletBuilder::build(vertices, indices, lods[0].indexOffset, lods[0].indexCount, options.meshlets, options.optimizer.cacheSize);
+
+        size_t coneCount = std::count_if(meshlets.begin(), meshlets.end(), [](const Meshlet& meshlet) { return meshlet.coneCutoff < 1.0f; });
+        std::cout << "Built " << meshlets.size() << " meshlets for " << name << " (" << coneCount << " with a usable normal cone)" << std::endl;
+    }
+
+    if (options.ambientOcclusion.bakeAmbientOcclusion) {
+        AmbientOcclusionStats stats = AmbientOcclusionBaker::bake(vertices, indices, lods[0].indexOffset, lods[0].indexCount, options.ambientOcclusion);
+        std::cout << "Baked ambient occlusion for " << name << ": " << stats.rayCount << " rays in " << stats.milliseconds << " ms on "
+            << stats.threadCount << " threads (" << stats.getRaysPerSecondPerThread() / 1e6 << " Mrays/s per thread)" << std::endl;
+    }
+}
+
+void MeshCache::adoptGeometry(CachedMesh& cachedMesh, std::vector<Vertex3D_PBR> vertices, std::vector<uint32_t> indices, std::vector<MeshLod> lods, std::vector<Meshlet> meshlets) {
+    cachedMesh.m_File.close();
+    cachedMesh.m_pEncodedVertices = nullptr;
+    cachedMesh.m_pEncodedIndices = nullptr;
+    cachedMesh.m_OwnedVertices = std::move(vertices);
+    cachedMesh.m_OwnedIndices = std::move(indices);
+    cachedMesh.m_OwnedLods = std::move(lods);
+    cachedMesh.m_OwnedMeshlets = std::move(meshlets);
+    cachedMesh.m_pVertices = cachedMesh.m_OwnedVertices.data();
+    cachedMesh.m_VertexCount = cachedMesh.m_OwnedVertices.size();
+    cachedMesh.m_pIndices = cachedMesh.m_OwnedIndices.data();
+    cachedMesh.m_IndexCount = cachedMesh.m_OwnedIndices.size();
+    cachedMesh.m_pLods = cachedMesh.m_OwnedLods.data();
+    cachedMesh.m_LodCount = cachedMesh.m_OwnedLods.size();
+    cachedMesh.m_pMeshlets = cachedMesh.m_OwnedMeshlets.data();
+    cachedMesh.m_MeshletCount = cachedMesh.m_OwnedMeshlets.size();
+    cachedMesh.m_Bounds = computeBounds(cachedMesh.m_pVertices, cachedMesh.m_VertexCount);
+}
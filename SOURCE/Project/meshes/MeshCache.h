@@ -0,0 +1,179 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <Vertex.h>
+#include <io/AssetPack.h>
+#include <meshes/MeshOptimizer.h>
+#include <meshes/MeshLod.h>
+#include <meshes/Meshlet.h>
+#include <meshes/AmbientOcclusionBaker.h>
+#include <meshes/GeometryCodec.h>
+#include <meshes/ObjStreamLoader.h>
+
+struct MeshBounds {
+    glm::vec3 min{ 0.0f };
+    glm::vec3 max{ 0.0f };
+
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    float getRadius() const { return glm::length(max - min) * 0.5f; }
+};
+
+struct MeshProcessingOptions {
+    MeshOptimizerOptions optimizer{};
+    MeshLodOptions lods{};
+    MeshletOptions meshlets{};
+    AmbientOcclusionOptions ambientOcclusion{};
+    // How large sources are read. Not part of the key: a streamed source has the same triangles and
+    // only duplicates the vertices on block borders.
+    ObjLoader::ObjStreamOptions streaming{};
+
+    // For tiny meshes such as a 12-triangle cube of separate faces: only first-use vertex order is
+    // worth doing and there is nothing to simplify, split into meshlets or occlude.
+    static MeshProcessingOptions createMinimal();
+
+    uint64_t getKey() const;
+};
+
+struct MeshCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexStride;
+    uint64_t sourceModifiedTime;
+    uint64_t sourceSize;
+    uint64_t sourceContentHash;
+    uint64_t processingKey;
+    // Primitives in the source, each cached in its own file; 1 for an OBJ.
+    uint64_t primitiveCount;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t lodCount;
+    uint64_t lodOffset;
+    uint64_t meshletCount;
+    uint64_t meshletOffset;
+    // Sizes of the GeometryCodec streams at vertexOffset and indexOffset.
+    uint64_t vertexDataSize;
+    uint64_t indexDataSize;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+// Whether a cache hit decodes the vertices and indices into CPU arrays for getVertices() and
+// getIndices(). Uploads only need them once, so they can leave them compressed in the mapping and
+// decode them straight into staging memory with CachedMesh::decodeVertices() and decodeIndices().
+enum class MeshGeometryAccess {
+    CpuCopy,
+    UploadOnly
+};
+
+// Finished vertex and index arrays for one source mesh. The vertices and indices come from the
+// compressed .meshbin file or its copy in the asset pack, while the LODs and meshlets are a
+// read-only view into the mapping. When the cache cannot be written it owns the freshly parsed
+// arrays instead.
+class CachedMesh {
+public:
+    CachedMesh() = default;
+    ~CachedMesh() = default;
+
+    CachedMesh(const CachedMesh&) = delete;
+    CachedMesh& operator=(const CachedMesh&) = delete;
+    CachedMesh(CachedMesh&&) = default;
+    CachedMesh& operator=(CachedMesh&&) = default;
+
+    // Null when the mesh was loaded with MeshGeometryAccess::UploadOnly; see hasCpuGeometry().
+    const Vertex3D_PBR* getVertices() const { return m_pVertices; }
+    size_t getVertexCount() const { return m_VertexCount; }
+    const uint32_t* getIndices() const { return m_pIndices; }
+    size_t getIndexCount() const { return m_IndexCount; }
+    const MeshLod* getLods() const { return m_pLods; }
+    size_t getLodCount() const { return m_LodCount; }
+    const Meshlet* getMeshlets() const { return m_pMeshlets; }
+    size_t getMeshletCount() const { return m_MeshletCount; }
+    const MeshBounds& getBounds() const { return m_Bounds; }
+    bool isMapped() const { return m_File.isOpen(); }
+    bool hasCpuGeometry() const { return m_pEncodedVertices == nullptr; }
+
+    // Hand the vertices or indices to the callback in order, a few hundred at a time, decoding
+    // compressed geometry block by block while it is still in L1. Either way no full-size copy is
+    // made. Return false if the compressed data is corrupt.
+    using VertexBlockCallback = std::function<void(const Vertex3D_PBR* vertices, size_t firstVertex, size_t vertexCount)>;
+    bool decodeVertices(const VertexBlockCallback& callback) const;
+    bool decodeIndices(const GeometryCodec::IndexBlockCallback& callback) const;
+
+private:
+    // The cache file at cachePath, validated against the source at sourcePath. primitiveCount is
+    // set from the header.
+    static bool openCacheFile(const std::string& sourcePath, const std::string& cachePath, uint64_t processingKey, CachedMesh& cachedMesh, MeshGeometryAccess access, uint64_t& primitiveCount);
+    static bool writeCacheFile(const std::string& sourcePath, const std::string& cachePath, uint64_t processingKey, uint64_t primitiveCount,
+        const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods, const std::vector<Meshlet>& meshlets);
+    friend class MeshCache;
+
+    AssetFile m_File;
+    std::vector<Vertex3D_PBR> m_OwnedVertices;
+    std::vector<uint32_t> m_OwnedIndices;
+    std::vector<MeshLod> m_OwnedLods;
+    std::vector<Meshlet> m_OwnedMeshlets;
+
+    const uint8_t* m_pEncodedVertices = nullptr;
+    size_t m_EncodedVertexSize = 0;
+    const uint8_t* m_pEncodedIndices = nullptr;
+    size_t m_EncodedIndexSize = 0;
+
+    const Vertex3D_PBR* m_pVertices = nullptr;
+    size_t m_VertexCount = 0;
+    const uint32_t* m_pIndices = nullptr;
+    size_t m_IndexCount = 0;
+    const MeshLod* m_pLods = nullptr;
+    size_t m_LodCount = 0;
+    const Meshlet* m_pMeshlets = nullptr;
+    size_t m_MeshletCount = 0;
+    MeshBounds m_Bounds{};
+};
+
+class MeshCache {
+public:
+    static constexpr uint32_t version = 7;
+
+    // Maps the cache for these options when it matches the source, otherwise parses, optimizes and builds the
+    // LOD chain for the OBJ and rewrites the cache. The cache is valid when it was built with the
+    // same processing options and the source size and modification time match, or failing that the
+    // source content hash. The index array holds every LOD back to back, described by getLods(), and
+    // LOD 0 is laid out in meshlet order, described by getMeshlets(). Tangents follow MikkTSpace and
+    // vertex colors hold the baked ambient occlusion of LOD 0. Vertices and indices are stored
+    // compressed with GeometryCodec.
+    static bool loadObj(const std::string& objPath, CachedMesh& cachedMesh, const MeshProcessingOptions& options = {}, MeshGeometryAccess access = MeshGeometryAccess::CpuCopy);
+
+    // Loads every primitive of a binary glTF file, in file order, and runs it through the same
+    // optimization, LOD, meshlet and ambient occlusion steps as loadObj. Each primitive is cached
+    // like an OBJ, in the file getPrimitiveCachePath() names, and all of them are rebuilt when any
+    // one no longer matches the GLB.
+    static bool loadGlb(const std::string& glbPath, std::vector<CachedMesh>& primitives, const MeshProcessingOptions& options = {}, MeshGeometryAccess access = MeshGeometryAccess::CpuCopy);
+
+    // Maps the cache of every primitive of the GLB; false unless all of them match it.
+    static bool openGlbCache(const std::string& glbPath, uint64_t processingKey, std::vector<CachedMesh>& primitives, MeshGeometryAccess access = MeshGeometryAccess::CpuCopy);
+
+    static bool openCache(const std::string& sourcePath, uint64_t processingKey, CachedMesh& cachedMesh, MeshGeometryAccess access = MeshGeometryAccess::CpuCopy);
+    static bool writeCache(const std::string& sourcePath, uint64_t processingKey, const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods, const std::vector<Meshlet>& meshlets);
+
+    // <sourcePath>.<processing key in hex>.meshbin, so meshes loaded with different options keep
+    // separate caches instead of overwriting each other's.
+    static std::string getCachePath(const std::string& sourcePath, uint64_t processingKey);
+    // <glbPath>.<primitive index>.<processing key in hex>.meshbin.
+    static std::string getPrimitiveCachePath(const std::string& glbPath, size_t primitiveIndex, uint64_t processingKey);
+    static MeshBounds computeBounds(const Vertex3D_PBR* vertices, size_t vertexCount);
+
+private:
+    // The cache file at cachePath, validated against the source at sourcePath. primitiveCount is
+    // set from the header.
+    static bool openCacheFile(const std::string& sourcePath, const std::string& cachePath, uint64_t processingKey, CachedMesh& cachedMesh, MeshGeometryAccess access, uint64_t& primitiveCount);
+    static bool writeCacheFile(const std::string& sourcePath, const std::string& cachePath, uint64_t processingKey, uint64_t primitiveCount,
+        const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods, const std::vector<Meshlet>& meshlets);
+    // Optimizes the arrays in place and builds the LOD chain, meshlets and ambient occlusion the
+    // options ask for. name only labels the log output.
+    static void processGeometry(const std::string& name, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const MeshProcessingOptions& options,
+        std::vector<MeshLod>& lods, std::vector<Meshlet>& meshlets);
+    static void adoptGeometry(CachedMesh& cachedMesh, std::vector<Vertex3D_PBR> vertices, std::vector<uint32_t> indices, std::vector<MeshLod> lods, std::vector<Meshlet> meshlets);
+};
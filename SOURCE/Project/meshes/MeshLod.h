@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+// One level of detail: a range of the shared index buffer plus the object-space simplification
+// error it introduces. Level 0 is the full-detail mesh with zero error.
+struct MeshLod {
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;
+};
+
+struct MeshLodOptions {
+    uint32_t maxLodCount = 4;
+    float reductionPerLevel = 0.5f;
+    // Stops the chain once a level would need a larger error than this fraction of the mesh radius.
+    float maxRelativeError = 0.1f;
+
+    uint64_t getKey() const {
+        return static_cast<uint64_t>(maxLodCount) | (static_cast<uint64_t>(reductionPerLevel * 1000.0f) << 8) |
+            (static_cast<uint64_t>(maxRelativeError * 10000.0f) << 24);
+    }
+};
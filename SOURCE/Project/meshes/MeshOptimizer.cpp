@@ -0,0 +1,375 @@
+#include "MeshOptimizer.h"
+#include <loadObjFile.h>
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <limits>
+#include <glm/glm.hpp>
+
+namespace {
+    struct TriangleAdjacency {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+        std::vector<uint32_t> counts;
+    };
+
+    TriangleAdjacency buildTriangleAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount) {
+        TriangleAdjacency adjacency{};
+        adjacency.counts.assign(vertexCount, 0);
+        adjacency.offsets.assign(vertexCount + 1, 0);
+        adjacency.triangles.resize(indices.size());
+
+        for (uint32_t index : indices) {
+            adjacency.counts[index]++;
+        }
+        for (size_t i = 0; i < vertexCount; ++i) {
+            adjacency.offsets[i + 1] = adjacency.offsets[i] + adjacency.counts[i];
+        }
+
+        std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            adjacency.triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+        return adjacency;
+    }
+
+    // Triangles whose three vertices all miss a FIFO cache of cacheSize entries; these are where
+    // Tipsify jumped to a new fan and make natural cluster boundaries.
+    std::vector<uint32_t> findCacheFlushBoundaries(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+        std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+        uint32_t timestamp = cacheSize + 1;
+        std::vector<uint32_t> boundaries{ 0 };
+
+        for (size_t triangle = 0; triangle < indices.size() / 3; ++triangle) {
+            int misses = 0;
+            for (int corner = 0; corner < 3; ++corner) {
+                uint32_t vertex = indices[triangle * 3 + corner];
+                if (timestamp - cacheTimestamps[vertex] > cacheSize) {
+                    cacheTimestamps[vertex] = timestamp++;
+                    misses++;
+                }
+            }
+            if (misses == 3 && triangle > 0) {
+                boundaries.push_back(static_cast<uint32_t>(triangle));
+            }
+        }
+        return boundaries;
+    }
+
+    void rasterizeTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, int resolution, std::vector<float>& depthBuffer, size_t& shadedPixels) {
+        float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (std::abs(area) < 1e-12f) {
+            return;
+        }
+
+        int minX = std::max(0, static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))));
+        int maxX = std::min(resolution - 1, static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))));
+        int minY = std::max(0, static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))));
+        int maxY = std::min(resolution - 1, static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))));
+
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                float px = x + 0.5f;
+                float py = y + 0.5f;
+                float w0 = ((b.x - px) * (c.y - py) - (b.y - py) * (c.x - px)) / area;
+                float w1 = ((c.x - px) * (a.y - py) - (c.y - py) * (a.x - px)) / area;
+                float w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                    continue;
+                }
+
+                float depth = w0 * a.z + w1 * b.z + w2 * c.z;
+                float& storedDepth = depthBuffer[y * resolution + x];
+                if (depth < storedDepth) {
+                    storedDepth = depth;
+                    shadedPixels++;
+                }
+            }
+        }
+    }
+}
+
+uint64_t MeshOptimizerOptions::getKey() const {
+    uint64_t thresholdBits = static_cast<uint64_t>(overdrawThreshold * 1000.0f);
+    return (optimizeVertexCache ? 1ull : 0ull) | (optimizeOverdraw ? 2ull : 0ull) | (optimizeVertexFetch ? 4ull : 0ull) |
+        (static_cast<uint64_t>(cacheSize) << 8) | (thresholdBits << 32);
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    TriangleAdjacency adjacency = buildTriangleAdjacency(indices, vertexCount);
+    std::vector<uint32_t> liveTriangles = adjacency.counts;
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEndStack;
+    std::vector<uint32_t> candidates;
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t cursor = 1;
+    int64_t fanningVertex = 0;
+
+    while (fanningVertex >= 0) {
+        candidates.clear();
+
+        for (uint32_t i = adjacency.offsets[fanningVertex]; i < adjacency.offsets[fanningVertex + 1]; ++i) {
+            uint32_t triangle = adjacency.triangles[i];
+            if (emitted[triangle]) {
+                continue;
+            }
+
+            for (int corner = 0; corner < 3; ++corner) {
+                uint32_t vertex = indices[triangle * 3 + corner];
+                result.push_back(vertex);
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+
+                if (timestamp - cacheTimestamps[vertex] > cacheSize) {
+                    cacheTimestamps[vertex] = timestamp++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // Prefer the candidate that stays in the cache longest while its remaining fan still fits.
+        int64_t nextVertex = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (timestamp - cacheTimestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = timestamp - cacheTimestamps[vertex];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+
+        if (nextVertex < 0) {
+            while (!deadEndStack.empty()) {
+                uint32_t vertex = deadEndStack.back();
+                deadEndStack.pop_back();
+                if (liveTriangles[vertex] > 0) {
+                    nextVertex = vertex;
+                    break;
+                }
+            }
+        }
+
+        if (nextVertex < 0) {
+            while (cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0) {
+                    nextVertex = cursor;
+                    break;
+                }
+                cursor++;
+            }
+        }
+
+        fanningVertex = nextVertex;
+    }
+
+    indices = std::move(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex3D_PBR>& vertices, uint32_t cacheSize, float threshold) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    std::vector<uint32_t> boundaries = findCacheFlushBoundaries(indices, vertices.size(), cacheSize);
+    if (boundaries.size() < 2) {
+        return;
+    }
+    boundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+    glm::vec3 meshCentroid{ 0.0f };
+    for (const Vertex3D_PBR& vertex : vertices) {
+        meshCentroid += vertex.pos;
+    }
+    meshCentroid /= static_cast<float>(std::max<size_t>(vertices.size(), 1));
+
+    size_t clusterCount = boundaries.size() - 1;
+    std::vector<float> sortKeys(clusterCount);
+
+    for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+        glm::vec3 centroid{ 0.0f };
+        glm::vec3 normal{ 0.0f };
+        float area = 0.0f;
+
+        for (uint32_t triangle = boundaries[cluster]; triangle < boundaries[cluster + 1]; ++triangle) {
+            const glm::vec3& a = vertices[indices[triangle * 3 + 0]].pos;
+            const glm::vec3& b = vertices[indices[triangle * 3 + 1]].pos;
+            const glm::vec3& c = vertices[indices[triangle * 3 + 2]].pos;
+
+            glm::vec3 areaNormal = glm::cross(b - a, c - a);
+            float triangleArea = glm::length(areaNormal);
+
+            centroid += (a + b + c) * (triangleArea / 3.0f);
+            normal += areaNormal;
+            area += triangleArea;
+        }
+
+        centroid = area > 0.0f ? centroid / area : centroid;
+        float normalLength = glm::length(normal);
+        normal = normalLength > 0.0f ? normal / normalLength : normal;
+
+        sortKeys[cluster] = glm::dot(centroid - meshCentroid, normal);
+    }
+
+    std::vector<uint32_t> clusterOrder(clusterCount);
+    std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](uint32_t left, uint32_t right) { return sortKeys[left] > sortKeys[right]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t cluster : clusterOrder) {
+        result.insert(result.end(), indices.begin() + boundaries[cluster] * 3, indices.begin() + boundaries[cluster + 1] * 3);
+    }
+
+    float originalAcmr = 0.0f;
+    float resultAcmr = 0.0f;
+    float atvr = 0.0f;
+    analyzeVertexCache(indices, vertices.size(), cacheSize, originalAcmr, atvr);
+    analyzeVertexCache(result, vertices.size(), cacheSize, resultAcmr, atvr);
+
+    if (resultAcmr <= originalAcmr * threshold) {
+        indices = std::move(result);
+    }
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices) {
+    constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(vertices.size(), unused);
+    std::vector<Vertex3D_PBR> result;
+    result.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = static_cast<uint32_t>(result.size());
+            result.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(result);
+}
+
+std::vector<uint32_t> MeshOptimizer::buildPositionRemap(const std::vector<Vertex3D_PBR>& vertices) {
+    std::vector<uint32_t> remap(vertices.size());
+    IndexTripletMap firstWithPosition(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const glm::vec3& position = vertices[i].pos;
+        remap[i] = firstWithPosition.findOrInsert(ObjLoader::attributeKey(position.x), ObjLoader::attributeKey(position.y), ObjLoader::attributeKey(position.z), static_cast<uint32_t>(i)).first;
+    }
+    return remap;
+}
+
+void MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize, float& acmr, float& atvr) {
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    uint32_t timestamp = cacheSize + 1;
+    size_t transformedVertices = 0;
+    size_t uniqueVertices = 0;
+
+    for (uint32_t index : indices) {
+        if (timestamp - cacheTimestamps[index] > cacheSize) {
+            cacheTimestamps[index] = timestamp++;
+            transformedVertices++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+    }
+
+    size_t triangleCount = indices.size() / 3;
+    acmr = triangleCount > 0 ? static_cast<float>(transformedVertices) / triangleCount : 0.0f;
+    atvr = uniqueVertices > 0 ? static_cast<float>(transformedVertices) / uniqueVertices : 0.0f;
+}
+
+float MeshOptimizer::analyzeOverdraw(const std::vector<uint32_t>& indices, const std::vector<Vertex3D_PBR>& vertices) {
+    constexpr int resolution = 256;
+    if (indices.empty() || vertices.empty()) {
+        return 0.0f;
+    }
+
+    glm::vec3 boundsMin = vertices[0].pos;
+    glm::vec3 boundsMax = vertices[0].pos;
+    for (const Vertex3D_PBR& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+    glm::vec3 extent = boundsMax - boundsMin;
+    float scale = static_cast<float>(resolution) / std::max({ extent.x, extent.y, extent.z, 1e-6f });
+
+    size_t shadedPixels = 0;
+    size_t coveredPixels = 0;
+    std::vector<float> depthBuffer(resolution * resolution);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int direction = 0; direction < 2; ++direction) {
+            std::fill(depthBuffer.begin(), depthBuffer.end(), std::numeric_limits<float>::max());
+
+            auto project = [&](const glm::vec3& position) {
+                glm::vec3 local = (position - boundsMin) * scale;
+                glm::vec3 projected{ local[(axis + 1) % 3], local[(axis + 2) % 3], local[axis] };
+                if (direction == 1) {
+                    projected.z = -projected.z;
+                }
+                return projected;
+            };
+
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                rasterizeTriangle(project(vertices[indices[i]].pos), project(vertices[indices[i + 1]].pos), project(vertices[indices[i + 2]].pos),
+                    resolution, depthBuffer, shadedPixels);
+            }
+
+            for (float depth : depthBuffer) {
+                if (depth != std::numeric_limits<float>::max()) {
+                    coveredPixels++;
+                }
+            }
+        }
+    }
+
+    return coveredPixels > 0 ? static_cast<float>(shadedPixels) / coveredPixels : 0.0f;
+}
+
+MeshOptimizerStats MeshOptimizer::analyze(const std::vector<uint32_t>& indices, const std::vector<Vertex3D_PBR>& vertices, uint32_t cacheSize) {
+    MeshOptimizerStats stats{};
+    analyzeVertexCache(indices, vertices.size(), cacheSize, stats.acmr, stats.atvr);
+    stats.overdraw = analyzeOverdraw(indices, vertices);
+    return stats;
+}
+
+void MeshOptimizer::optimize(const std::string& name, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const MeshOptimizerOptions& options) {
+    MeshOptimizerStats before = analyze(indices, vertices, options.cacheSize);
+
+    if (options.optimizeVertexCache) {
+        optimizeVertexCache(indices, vertices.size(), options.cacheSize);
+    }
+    if (options.optimizeOverdraw) {
+        optimizeOverdraw(indices, vertices, options.cacheSize, options.overdrawThreshold);
+    }
+    if (options.optimizeVertexFetch) {
+        optimizeVertexFetch(vertices, indices);
+    }
+
+    MeshOptimizerStats after = analyze(indices, vertices, options.cacheSize);
+
+    std::cout << "Optimized " << name << ": ACMR " << before.acmr << " -> " << after.acmr
+        << ", ATVR " << before.atvr << " -> " << after.atvr
+        << ", overdraw " << before.overdraw << " -> " << after.overdraw << std::endl;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <Vertex.h>
+
+struct MeshOptimizerOptions {
+    bool optimizeVertexCache = true;
+    bool optimizeOverdraw = true;
+    bool optimizeVertexFetch = true;
+    // The overdraw pass may raise ACMR by at most this factor over the vertex cache order.
+    float overdrawThreshold = 1.05f;
+    uint32_t cacheSize = 16;
+
+    uint64_t getKey() const;
+};
+
+struct MeshOptimizerStats {
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+    float overdraw = 0.0f;
+};
+
+namespace MeshOptimizer {
+    // Tipsify (Sander et al. 2007) triangle reordering for a FIFO post-transform cache.
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize);
+
+    // Splits the cache-ordered triangles into clusters at cache flushes and sorts the clusters so
+    // outward-facing ones far from the centre draw first, keeping the result only when ACMR stays
+    // within threshold of the input order.
+    void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex3D_PBR>& vertices, uint32_t cacheSize, float threshold);
+
+    // Renumbers vertices in first-use order of the index buffer and drops unreferenced ones.
+    void optimizeVertexFetch(std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices);
+
+    // Maps every vertex to the first vertex with the same position, joining the surface back up
+    // across UV and normal seams for adjacency queries.
+    std::vector<uint32_t> buildPositionRemap(const std::vector<Vertex3D_PBR>& vertices);
+
+    // ACMR: transformed vertices per triangle, ATVR: transformed vertices per unique vertex,
+    // both for a FIFO cache of cacheSize entries.
+    void analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize, float& acmr, float& atvr);
+
+    // Shaded pixels over covered pixels for orthographic views along the six axis directions,
+    // rasterized in index order with depth testing and no culling.
+    float analyzeOverdraw(const std::vector<uint32_t>& indices, const std::vector<Vertex3D_PBR>& vertices);
+
+    MeshOptimizerStats analyze(const std::vector<uint32_t>& indices, const std::vector<Vertex3D_PBR>& vertices, uint32_t cacheSize);
+
+    void optimize(const std::string& name, std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const MeshOptimizerOptions& options);
+}
@@ -0,0 +1,286 @@
+#include "MeshSimplifier.h"
+#include <meshes/MeshOptimizer.h>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+namespace {
+    struct Quadric {
+        double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+        double a11 = 0, a12 = 0, a13 = 0;
+        double a22 = 0, a23 = 0;
+        double a33 = 0;
+        double weight = 0;
+
+        void addPlane(const glm::dvec3& normal, double distance, double planeWeight) {
+            a00 += planeWeight * normal.x * normal.x;
+            a01 += planeWeight * normal.x * normal.y;
+            a02 += planeWeight * normal.x * normal.z;
+            a03 += planeWeight * normal.x * distance;
+            a11 += planeWeight * normal.y * normal.y;
+            a12 += planeWeight * normal.y * normal.z;
+            a13 += planeWeight * normal.y * distance;
+            a22 += planeWeight * normal.z * normal.z;
+            a23 += planeWeight * normal.z * distance;
+            a33 += planeWeight * distance * distance;
+            weight += planeWeight;
+        }
+
+        Quadric& operator+=(const Quadric& other) {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+            a11 += other.a11; a12 += other.a12; a13 += other.a13;
+            a22 += other.a22; a23 += other.a23;
+            a33 += other.a33;
+            weight += other.weight;
+            return *this;
+        }
+
+        // Mean squared distance of position to the accumulated planes.
+        double evaluate(const glm::vec3& position) const {
+            double x = position.x, y = position.y, z = position.z;
+            double error = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+                + a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+                + a22 * z * z + 2 * a23 * z
+                + a33;
+            return weight > 0 ? std::max(error, 0.0) / weight : 0.0;
+        }
+    };
+
+    struct Collapse {
+        double cost;
+        uint32_t from;
+        uint32_t to;
+        uint32_t fromVersion;
+        uint32_t toVersion;
+
+        bool operator>(const Collapse& other) const { return cost > other.cost; }
+    };
+
+    // Locks vertices that share their position with another vertex (UV or normal seams) and
+    // vertices on open borders, where moving them would tear or shrink the surface.
+    std::vector<bool> findLockedVertices(const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> positionIds = MeshOptimizer::buildPositionRemap(vertices);
+        std::vector<uint32_t> positionUseCount(vertices.size(), 0);
+        for (uint32_t positionId : positionIds) {
+            positionUseCount[positionId]++;
+        }
+
+        std::vector<bool> locked(vertices.size(), false);
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            locked[i] = positionUseCount[positionIds[i]] > 1;
+        }
+
+        std::unordered_map<uint64_t, uint32_t> edgeUseCount;
+        edgeUseCount.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int edge = 0; edge < 3; ++edge) {
+                uint32_t a = positionIds[indices[i + edge]];
+                uint32_t b = positionIds[indices[i + (edge + 1) % 3]];
+                uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                edgeUseCount[key]++;
+            }
+        }
+
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int edge = 0; edge < 3; ++edge) {
+                uint32_t a = positionIds[indices[i + edge]];
+                uint32_t b = positionIds[indices[i + (edge + 1) % 3]];
+                uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                if (edgeUseCount[key] == 1) {
+                    locked[indices[i + edge]] = true;
+                    locked[indices[i + (edge + 1) % 3]] = true;
+                }
+            }
+        }
+
+        return locked;
+    }
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float maxError, float& resultError) {
+    resultError = 0.0f;
+
+    size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> triangles(indices.begin(), indices.begin() + triangleCount * 3);
+    std::vector<bool> triangleRemoved(triangleCount, false);
+    std::vector<bool> vertexRemoved(vertices.size(), false);
+    std::vector<uint32_t> versions(vertices.size(), 0);
+    std::vector<bool> locked = findLockedVertices(vertices, triangles);
+
+    std::vector<Quadric> quadrics(vertices.size());
+    std::vector<std::vector<uint32_t>> vertexTriangles(vertices.size());
+
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        const glm::vec3& a = vertices[triangles[triangle * 3 + 0]].pos;
+        const glm::vec3& b = vertices[triangles[triangle * 3 + 1]].pos;
+        const glm::vec3& c = vertices[triangles[triangle * 3 + 2]].pos;
+
+        glm::dvec3 normal = glm::cross(glm::dvec3(b - a), glm::dvec3(c - a));
+        double doubleArea = glm::length(normal);
+        if (doubleArea > 0.0) {
+            normal /= doubleArea;
+            double distance = -glm::dot(normal, glm::dvec3(a));
+            for (int corner = 0; corner < 3; ++corner) {
+                quadrics[triangles[triangle * 3 + corner]].addPlane(normal, distance, doubleArea * 0.5);
+            }
+        }
+
+        for (int corner = 0; corner < 3; ++corner) {
+            vertexTriangles[triangles[triangle * 3 + corner]].push_back(static_cast<uint32_t>(triangle));
+        }
+    }
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+    auto pushCollapse = [&](uint32_t from, uint32_t to) {
+        if (from == to || locked[from]) {
+            return;
+        }
+        Quadric combined = quadrics[from];
+        combined += quadrics[to];
+        collapses.push(Collapse{ combined.evaluate(vertices[to].pos), from, to, versions[from], versions[to] });
+    };
+
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        for (int corner = 0; corner < 3; ++corner) {
+            uint32_t a = triangles[triangle * 3 + corner];
+            uint32_t b = triangles[triangle * 3 + (corner + 1) % 3];
+            pushCollapse(a, b);
+            pushCollapse(b, a);
+        }
+    }
+
+    size_t liveTriangleCount = triangleCount;
+    double maxCost = static_cast<double>(maxError) * maxError;
+    double largestCost = 0.0;
+
+    while (liveTriangleCount * 3 > targetIndexCount && !collapses.empty()) {
+        Collapse collapse = collapses.top();
+        collapses.pop();
+
+        if (collapse.cost > maxCost) {
+            break;
+        }
+        if (vertexRemoved[collapse.from] || vertexRemoved[collapse.to] ||
+            versions[collapse.from] != collapse.fromVersion || versions[collapse.to] != collapse.toVersion) {
+            continue;
+        }
+
+        // Reject collapses that would flip a surviving triangle.
+        bool flips = false;
+        for (uint32_t triangle : vertexTriangles[collapse.from]) {
+            if (triangleRemoved[triangle]) {
+                continue;
+            }
+            uint32_t* corners = &triangles[triangle * 3];
+            if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+                continue;
+            }
+
+            glm::vec3 positions[3];
+            glm::vec3 movedPositions[3];
+            for (int corner = 0; corner < 3; ++corner) {
+                positions[corner] = vertices[corners[corner]].pos;
+                movedPositions[corner] = corners[corner] == collapse.from ? vertices[collapse.to].pos : positions[corner];
+            }
+
+            glm::vec3 normal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+            glm::vec3 movedNormal = glm::cross(movedPositions[1] - movedPositions[0], movedPositions[2] - movedPositions[0]);
+            if (glm::dot(normal, movedNormal) <= 0.0f) {
+                flips = true;
+                break;
+            }
+        }
+        if (flips) {
+            continue;
+        }
+
+        for (uint32_t triangle : vertexTriangles[collapse.from]) {
+            if (triangleRemoved[triangle]) {
+                continue;
+            }
+            uint32_t* corners = &triangles[triangle * 3];
+            if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+                triangleRemoved[triangle] = true;
+                liveTriangleCount--;
+                continue;
+            }
+            for (int corner = 0; corner < 3; ++corner) {
+                if (corners[corner] == collapse.from) {
+                    corners[corner] = collapse.to;
+                }
+            }
+            vertexTriangles[collapse.to].push_back(triangle);
+        }
+
+        vertexRemoved[collapse.from] = true;
+        vertexTriangles[collapse.from].clear();
+        quadrics[collapse.to] += quadrics[collapse.from];
+        versions[collapse.to]++;
+        largestCost = std::max(largestCost, collapse.cost);
+
+        auto& remaining = vertexTriangles[collapse.to];
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](uint32_t triangle) { return triangleRemoved[triangle]; }), remaining.end());
+
+        for (uint32_t triangle : remaining) {
+            for (int corner = 0; corner < 3; ++corner) {
+                uint32_t neighbour = triangles[triangle * 3 + corner];
+                if (neighbour != collapse.to) {
+                    pushCollapse(neighbour, collapse.to);
+                    pushCollapse(collapse.to, neighbour);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(liveTriangleCount * 3);
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        if (!triangleRemoved[triangle]) {
+            result.insert(result.end(), triangles.begin() + triangle * 3, triangles.begin() + triangle * 3 + 3);
+        }
+    }
+
+    resultError = static_cast<float>(std::sqrt(largestCost));
+    return result;
+}
+
+std::vector<MeshLod> MeshSimplifier::buildLodChain(const std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const MeshLodOptions& options, uint32_t cacheSize) {
+    std::vector<MeshLod> lods{ MeshLod{ 0, static_cast<uint32_t>(indices.size()), 0.0f } };
+    if (options.maxLodCount < 2 || vertices.empty()) {
+        return lods;
+    }
+
+    glm::vec3 boundsMin = vertices[0].pos;
+    glm::vec3 boundsMax = vertices[0].pos;
+    for (const Vertex3D_PBR& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+    float maxError = options.maxRelativeError * glm::length(boundsMax - boundsMin) * 0.5f;
+
+    std::vector<uint32_t> previousLevel = indices;
+    float accumulatedError = 0.0f;
+
+    while (lods.size() < options.maxLodCount) {
+        size_t targetIndexCount = static_cast<size_t>(previousLevel.size() / 3 * options.reductionPerLevel) * 3;
+
+        float levelError = 0.0f;
+        std::vector<uint32_t> level = simplify(vertices, previousLevel, targetIndexCount, maxError - accumulatedError, levelError);
+
+        // Give up once a level no longer removes a meaningful share of the triangles.
+        if (level.empty() || level.size() > previousLevel.size() * 9 / 10) {
+            break;
+        }
+
+        MeshOptimizer::optimizeVertexCache(level, vertices.size(), cacheSize);
+        accumulatedError += levelError;
+
+        lods.push_back(MeshLod{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(level.size()), accumulatedError });
+        indices.insert(indices.end(), level.begin(), level.end());
+        previousLevel = std::move(level);
+    }
+
+    return lods;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <Vertex.h>
+#include <meshes/MeshLod.h>
+
+namespace MeshSimplifier {
+    // Quadric-error half-edge collapse: every removed vertex collapses onto a neighbouring
+    // vertex, so the result indexes the same vertex buffer. Vertices on borders and attribute
+    // seams stay locked. Returns the simplified index list and its error in object units.
+    std::vector<uint32_t> simplify(const std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float maxError, float& resultError);
+
+    // Appends up to options.maxLodCount - 1 coarser levels to indices, each cache-optimized, and
+    // returns the level table including level 0 (the indices passed in).
+    std::vector<MeshLod> buildLodChain(const std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, const MeshLodOptions& options, uint32_t cacheSize);
+}
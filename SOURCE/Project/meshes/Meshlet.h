@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// A cluster of up to MeshletOptions::maxTriangles triangles stored as a contiguous range of the
+// index buffer, so survivors of culling can be drawn with ordinary indexed draws.
+struct Meshlet {
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    glm::vec3 center{ 0.0f };
+    float radius = 0.0f;
+    // Average triangle normal. The cluster faces away from the camera when
+    // dot(center - camera, coneAxis) >= coneCutoff * length(center - camera) + radius.
+    // Clusters whose normals spread over more than a hemisphere have a zero axis and never cull.
+    glm::vec3 coneAxis{ 0.0f };
+    float coneCutoff = 1.0f;
+};
+
+struct MeshletOptions {
+    bool buildMeshlets = true;
+    uint32_t maxVertices = 64;
+    uint32_t maxTriangles = 124;
+
+    uint64_t getKey() const {
+        return static_cast<uint64_t>(buildMeshlets) | (static_cast<uint64_t>(maxVertices) << 1) | (static_cast<uint64_t>(maxTriangles) << 17);
+    }
+};
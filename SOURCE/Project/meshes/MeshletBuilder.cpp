@@ -0,0 +1,193 @@
+#include "MeshletBuilder.h"
+#include <meshes/MeshOptimizer.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // How many new vertices a fully perpendicular normal is worth when growing a cluster.
+    constexpr float coneWeight = 2.0f;
+}
+
+void MeshletBuilder::computeBounds(const std::vector<Vertex3D_PBR>& vertices, const uint32_t* indices, Meshlet& meshlet) {
+    glm::vec3 boundsMin = vertices[indices[0]].pos;
+    glm::vec3 boundsMax = boundsMin;
+    for (uint32_t i = 1; i < meshlet.indexCount; ++i) {
+        boundsMin = glm::min(boundsMin, vertices[indices[i]].pos);
+        boundsMax = glm::max(boundsMax, vertices[indices[i]].pos);
+    }
+
+    meshlet.center = (boundsMin + boundsMax) * 0.5f;
+    meshlet.radius = 0.0f;
+    for (uint32_t i = 0; i < meshlet.indexCount; ++i) {
+        meshlet.radius = std::max(meshlet.radius, glm::length(vertices[indices[i]].pos - meshlet.center));
+    }
+
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.indexCount / 3);
+    glm::vec3 normalSum{ 0.0f };
+    for (uint32_t i = 0; i + 2 < meshlet.indexCount; i += 3) {
+        const glm::vec3& a = vertices[indices[i + 0]].pos;
+        const glm::vec3& b = vertices[indices[i + 1]].pos;
+        const glm::vec3& c = vertices[indices[i + 2]].pos;
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float length = glm::length(normal);
+        if (length > 0.0f) {
+            normals.push_back(normal / length);
+            normalSum += normals.back();
+        }
+    }
+
+    meshlet.coneAxis = glm::vec3{ 0.0f };
+    meshlet.coneCutoff = 1.0f;
+
+    float axisLength = glm::length(normalSum);
+    if (axisLength < 1e-6f) {
+        return;
+    }
+
+    glm::vec3 axis = normalSum / axisLength;
+    float minDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        minDot = std::min(minDot, glm::dot(axis, normal));
+    }
+
+    // A spread beyond 90 degrees always contains a normal facing the camera.
+    if (minDot <= 0.0f) {
+        return;
+    }
+
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+std::vector<Meshlet> MeshletBuilder::build(const std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, uint32_t indexOffset, uint32_t indexCount, const MeshletOptions& options, uint32_t cacheSize) {
+    std::vector<Meshlet> meshlets;
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || options.maxTriangles == 0 || options.maxVertices < 3) {
+        return meshlets;
+    }
+
+    const uint32_t* source = indices.data() + indexOffset;
+
+    // Adjacency runs over welded positions so clusters grow across UV seams; the vertex limit
+    // still counts real vertices.
+    std::vector<uint32_t> positionIds = MeshOptimizer::buildPositionRemap(vertices);
+
+    std::vector<uint32_t> triangleOffsets(vertices.size() + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        triangleOffsets[positionIds[source[i]] + 1]++;
+    }
+    for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+        triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+    }
+
+    std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+    std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        vertexTriangles[cursor[positionIds[source[i]]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<glm::vec3> triangleNormals(triangleCount);
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        const glm::vec3& a = vertices[source[triangle * 3 + 0]].pos;
+        const glm::vec3& b = vertices[source[triangle * 3 + 1]].pos;
+        const glm::vec3& c = vertices[source[triangle * 3 + 2]].pos;
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float length = glm::length(normal);
+        triangleNormals[triangle] = length > 0.0f ? normal / length : glm::vec3{ 0.0f };
+    }
+
+    std::vector<bool> assigned(triangleCount, false);
+    // Index of the meshlet that last took each vertex, so membership tests are O(1) without clearing.
+    std::vector<uint32_t> vertexMeshlet(vertices.size(), UINT32_MAX);
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> meshletTriangles;
+    std::vector<uint32_t> reordered;
+    reordered.reserve(triangleCount * 3);
+
+    // Seeds are taken in the existing (cache and overdraw optimized) order, so the meshlet order
+    // keeps the coarse front-to-back ordering of the input.
+    for (size_t seed = 0; seed < triangleCount; ++seed) {
+        if (assigned[seed]) {
+            continue;
+        }
+
+        uint32_t meshletIndex = static_cast<uint32_t>(meshlets.size());
+        meshletVertices.clear();
+        meshletTriangles.clear();
+
+        glm::vec3 meshletNormal{ 0.0f };
+
+        auto addTriangle = [&](uint32_t triangle) {
+            assigned[triangle] = true;
+            meshletNormal += triangleNormals[triangle];
+            meshletTriangles.push_back(triangle);
+            for (int corner = 0; corner < 3; ++corner) {
+                uint32_t vertex = source[triangle * 3 + corner];
+                if (vertexMeshlet[vertex] != meshletIndex) {
+                    vertexMeshlet[vertex] = meshletIndex;
+                    meshletVertices.push_back(vertex);
+                }
+            }
+        };
+
+        addTriangle(static_cast<uint32_t>(seed));
+
+        // Grow across shared vertices. Candidates are scored by the vertices they add plus how far
+        // their normal leans away from the cluster's, which keeps the normal cones tight.
+        while (meshletTriangles.size() < options.maxTriangles) {
+            uint32_t bestTriangle = UINT32_MAX;
+            float bestScore = std::numeric_limits<float>::max();
+            float normalLength = glm::length(meshletNormal);
+            glm::vec3 averageNormal = normalLength > 0.0f ? meshletNormal / normalLength : glm::vec3{ 0.0f };
+
+            for (uint32_t vertex : meshletVertices) {
+                uint32_t position = positionIds[vertex];
+                for (uint32_t i = triangleOffsets[position]; i < triangleOffsets[position + 1]; ++i) {
+                    uint32_t triangle = vertexTriangles[i];
+                    if (assigned[triangle]) {
+                        continue;
+                    }
+
+                    uint32_t newVertices = 0;
+                    for (int corner = 0; corner < 3; ++corner) {
+                        newVertices += vertexMeshlet[source[triangle * 3 + corner]] != meshletIndex ? 1 : 0;
+                    }
+                    if (meshletVertices.size() + newVertices > options.maxVertices) {
+                        continue;
+                    }
+
+                    float score = static_cast<float>(newVertices) + coneWeight * (1.0f - glm::dot(triangleNormals[triangle], averageNormal));
+                    if (score < bestScore || (score == bestScore && triangle < bestTriangle)) {
+                        bestTriangle = triangle;
+                        bestScore = score;
+                    }
+                }
+            }
+
+            if (bestTriangle == UINT32_MAX) {
+                break;
+            }
+            addTriangle(bestTriangle);
+        }
+
+        std::vector<uint32_t> meshletIndices;
+        meshletIndices.reserve(meshletTriangles.size() * 3);
+        for (uint32_t triangle : meshletTriangles) {
+            meshletIndices.insert(meshletIndices.end(), source + triangle * 3, source + triangle * 3 + 3);
+        }
+        MeshOptimizer::optimizeVertexCache(meshletIndices, vertices.size(), cacheSize);
+
+        Meshlet meshlet{};
+        meshlet.indexOffset = indexOffset + static_cast<uint32_t>(reordered.size());
+        meshlet.indexCount = static_cast<uint32_t>(meshletIndices.size());
+        computeBounds(vertices, meshletIndices.data(), meshlet);
+        meshlets.push_back(meshlet);
+
+        reordered.insert(reordered.end(), meshletIndices.begin(), meshletIndices.end());
+    }
+
+    std::copy(reordered.begin(), reordered.end(), indices.begin() + indexOffset);
+    return meshlets;
+}
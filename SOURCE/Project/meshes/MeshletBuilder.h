@@ -0,0 +1,14 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <Vertex.h>
+#include <meshes/Meshlet.h>
+
+namespace MeshletBuilder {
+    // Partitions the triangles in indices[indexOffset, indexOffset + indexCount) into meshlets by
+    // growing each cluster across shared vertices, rewrites that range in meshlet order (each
+    // meshlet cache-optimized) and returns the meshlets with their culling bounds.
+    std::vector<Meshlet> build(const std::vector<Vertex3D_PBR>& vertices, std::vector<uint32_t>& indices, uint32_t indexOffset, uint32_t indexCount, const MeshletOptions& options, uint32_t cacheSize);
+
+    void computeBounds(const std::vector<Vertex3D_PBR>& vertices, const uint32_t* indices, Meshlet& meshlet);
+}
@@ -0,0 +1,410 @@
+#include "ObjStreamLoader.h"
+#include <io/TextScan.h>
+#include <meshes/IndexTripletMap.h>
+#include <meshes/TangentGenerator.h>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <array>
+#include <unordered_map>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace {
+    enum AttributeKind {
+        PositionAttribute = 0,
+        TexCoordAttribute = 1,
+        NormalAttribute = 2,
+        AttributeKindCount = 3
+    };
+
+    constexpr size_t pageReadSize = 64 * 1024;
+    constexpr size_t minPageReadSize = 4 * 1024;
+
+    // Returns the attribute kind of a line that starts at the first non-blank character, or
+    // AttributeKindCount when it is not a v, vt or vn line.
+    AttributeKind getAttributeKind(const char* line, const char* end) {
+        if (end - line < 2 || line[0] != 'v') {
+            return AttributeKindCount;
+        }
+        if (TextScan::isBlank(line[1])) {
+            return PositionAttribute;
+        }
+        if (line[1] == 't') {
+            return TexCoordAttribute;
+        }
+        if (line[1] == 'n') {
+            return NormalAttribute;
+        }
+        return AttributeKindCount;
+    }
+
+    glm::vec3 parseAttribute(AttributeKind kind, const char* line, const char* end) {
+        glm::vec3 value{ 0.0f };
+        const char* p = line + (kind == PositionAttribute ? 1 : 2);
+        p = TextScan::parseFloat(p, end, value.x);
+        p = TextScan::parseFloat(p, end, value.y);
+        if (kind == TexCoordAttribute) {
+            value.y = 1.0f - value.y;
+        }
+        else {
+            TextScan::parseFloat(p, end, value.z);
+        }
+        return value;
+    }
+
+    // Reads the file from startOffset in window-sized pieces and calls function(lineStart, lineEnd,
+    // lineOffset) for every line, without the line break. Stops early when function returns false.
+    // A line that does not fit in the window is an error.
+    template <typename Function>
+    bool forEachLine(std::ifstream& file, uint64_t startOffset, std::vector<char>& window, uint64_t& bytesRead, Function&& function) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(startOffset));
+
+        uint64_t windowOffset = startOffset;
+        size_t carried = 0;
+
+        while (true) {
+            size_t requested = window.size() - carried;
+            file.read(window.data() + carried, static_cast<std::streamsize>(requested));
+            size_t readCount = static_cast<size_t>(file.gcount());
+            bytesRead += readCount;
+
+            const char* begin = window.data();
+            const char* end = begin + carried + readCount;
+            const char* lineStart = begin;
+
+            while (const char* newline = static_cast<const char*>(std::memchr(lineStart, '\n', end - lineStart))) {
+                if (!function(lineStart, newline, windowOffset + (lineStart - begin))) {
+                    return true;
+                }
+                lineStart = newline + 1;
+            }
+
+            size_t remainder = static_cast<size_t>(end - lineStart);
+            if (readCount < requested) {
+                if (remainder > 0) {
+                    function(lineStart, end, windowOffset + (lineStart - begin));
+                }
+                return true;
+            }
+            if (remainder == window.size()) {
+                std::cerr << "OBJ line at offset " << windowOffset << " is longer than the " << window.size() << " byte read window" << std::endl;
+                return false;
+            }
+
+            std::memmove(window.data(), lineStart, remainder);
+            windowOffset += static_cast<uint64_t>(lineStart - begin);
+            carried = remainder;
+        }
+    }
+
+    // Fixed number of attribute pages, replaced with the clock algorithm. Each page holds
+    // attributePageSize consecutive attributes of one kind and is re-read from the file on a miss.
+    class AttributePageCache {
+    public:
+        AttributePageCache(const std::string& filename, const std::array<std::vector<uint64_t>, AttributeKindCount>& pageOffsets, const std::array<uint64_t, AttributeKindCount>& attributeCounts, size_t slotCount)
+            : m_File(filename, std::ios::binary), m_PageOffsets(pageOffsets), m_AttributeCounts(attributeCounts), m_Slots(slotCount), m_ReadWindow(pageReadSize) {
+            m_SlotByKey.reserve(slotCount);
+        }
+
+        bool isOpen() const { return m_File.is_open(); }
+
+        const glm::vec3* get(AttributeKind kind, uint64_t index, ObjLoader::ObjStreamStats& stats) {
+            uint64_t page = index / ObjLoader::attributePageSize;
+            uint64_t key = page * AttributeKindCount + kind;
+
+            auto it = m_SlotByKey.find(key);
+            if (it != m_SlotByKey.end()) {
+                Slot& slot = m_Slots[it->second];
+                slot.referenced = true;
+                ++stats.pageHits;
+                return &slot.values[index % ObjLoader::attributePageSize];
+            }
+
+            ++stats.pageMisses;
+            size_t slotIndex = findVictim();
+            Slot& slot = m_Slots[slotIndex];
+            if (slot.key != emptyKey) {
+                m_SlotByKey.erase(slot.key);
+            }
+
+            slot.key = emptyKey;
+            if (!loadPage(kind, page, slot.values, stats)) {
+                return nullptr;
+            }
+            slot.key = key;
+            slot.referenced = true;
+            m_SlotByKey.emplace(key, slotIndex);
+
+            size_t offset = static_cast<size_t>(index % ObjLoader::attributePageSize);
+            return offset < slot.values.size() ? &slot.values[offset] : nullptr;
+        }
+
+    private:
+        static constexpr uint64_t emptyKey = UINT64_MAX;
+
+        struct Slot {
+            uint64_t key = emptyKey;
+            bool referenced = false;
+            std::vector<glm::vec3> values;
+        };
+
+        size_t findVictim() {
+            while (true) {
+                Slot& slot = m_Slots[m_ClockHand];
+                size_t candidate = m_ClockHand;
+                m_ClockHand = (m_ClockHand + 1) % m_Slots.size();
+                if (slot.key == emptyKey || !slot.referenced) {
+                    return candidate;
+                }
+                slot.referenced = false;
+            }
+        }
+
+        bool loadPage(AttributeKind kind, uint64_t page, std::vector<glm::vec3>& values, ObjLoader::ObjStreamStats& stats) {
+            values.clear();
+            values.reserve(ObjLoader::attributePageSize);
+
+            const std::vector<uint64_t>& offsets = m_PageOffsets[kind];
+            if (page >= offsets.size()) {
+                return false;
+            }
+            size_t pageCount = static_cast<size_t>(std::min<uint64_t>(ObjLoader::attributePageSize, m_AttributeCounts[kind] - page * ObjLoader::attributePageSize));
+
+            // Pages are usually contiguous runs of lines, so reading just up to the next page start
+            // avoids pulling in a full window on every miss.
+            if (page + 1 < offsets.size()) {
+                m_ReadWindow.resize(static_cast<size_t>(std::clamp<uint64_t>(offsets[page + 1] - offsets[page] + 1, minPageReadSize, pageReadSize)));
+            }
+            else {
+                m_ReadWindow.resize(pageReadSize);
+            }
+
+            return forEachLine(m_File, offsets[page], m_ReadWindow, stats.bytesRead, [&](const char* line, const char* end, uint64_t) {
+                line = TextScan::skipBlanks(line, end);
+                if (getAttributeKind(line, end) == kind) {
+                    values.push_back(parseAttribute(kind, line, end));
+                }
+                return values.size() < pageCount;
+            });
+        }
+
+        std::ifstream m_File;
+        const std::array<std::vector<uint64_t>, AttributeKindCount>& m_PageOffsets;
+        const std::array<uint64_t, AttributeKindCount>& m_AttributeCounts;
+        std::vector<Slot> m_Slots;
+        std::unordered_map<uint64_t, size_t> m_SlotByKey;
+        size_t m_ClockHand = 0;
+        std::vector<char> m_ReadWindow;
+    };
+
+    size_t getIndexTripletMapBytes(size_t expectedCount) {
+        size_t capacity = 16;
+        while (capacity < expectedCount * 2) {
+            capacity *= 2;
+        }
+        return capacity * 16;
+    }
+}
+
+namespace ObjLoader {
+    bool streamObjFile(const std::string& filename, const ObjStreamOptions& options, const ObjBlockSink& sink, ObjStreamStats* pStats) {
+        ObjStreamStats stats{};
+
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Could not open the file: " << filename << std::endl;
+            return false;
+        }
+        file.seekg(0, std::ios::end);
+        stats.fileSize = static_cast<uint64_t>(file.tellg());
+
+        size_t maxBlockVertices = std::max<size_t>(options.maxBlockVertices, 3);
+        size_t maxBlockIndices = std::max<size_t>(options.maxBlockTriangles, 1) * 3;
+
+        std::vector<char> window(std::max<size_t>(options.windowSize, pageReadSize));
+
+        // First pass: count attributes and faces and remember where every attribute page starts.
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::array<std::vector<uint64_t>, AttributeKindCount> pageOffsets;
+        std::array<uint64_t, AttributeKindCount> attributeCounts{};
+
+        bool scanned = forEachLine(file, 0, window, stats.bytesRead, [&](const char* line, const char* end, uint64_t offset) {
+            line = TextScan::skipBlanks(line, end);
+            AttributeKind kind = getAttributeKind(line, end);
+            if (kind != AttributeKindCount) {
+                if (attributeCounts[kind] % attributePageSize == 0) {
+                    pageOffsets[kind].push_back(offset);
+                }
+                ++attributeCounts[kind];
+            }
+            else if (line < end && *line == 'f') {
+                ++stats.triangleCount;
+            }
+            return true;
+        });
+        if (!scanned) {
+            return false;
+        }
+
+        stats.positionCount = attributeCounts[PositionAttribute];
+        stats.texCoordCount = attributeCounts[TexCoordAttribute];
+        stats.normalCount = attributeCounts[NormalAttribute];
+        stats.firstPassMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        // Everything but the page cache has a fixed size; the cache gets the rest of the ceiling.
+        size_t fixedBytes = window.size() + pageReadSize
+            + maxBlockVertices * (sizeof(Vertex3D_PBR) + sizeof(glm::vec3))
+            + maxBlockIndices * sizeof(uint32_t)
+            + getIndexTripletMapBytes(maxBlockVertices);
+        for (const auto& offsets : pageOffsets) {
+            fixedBytes += offsets.size() * sizeof(uint64_t);
+        }
+
+        size_t pageBytes = attributePageSize * sizeof(glm::vec3) + 64;
+        if (options.memoryCeiling < fixedBytes + pageBytes) {
+            std::cerr << "Memory ceiling of " << options.memoryCeiling << " bytes is below the " << fixedBytes + pageBytes
+                << " bytes needed to stream " << filename << std::endl;
+            return false;
+        }
+        stats.pageCacheSlots = (options.memoryCeiling - fixedBytes) / pageBytes;
+        stats.reservedBytes = fixedBytes + stats.pageCacheSlots * pageBytes;
+
+        AttributePageCache pageCache(filename, pageOffsets, attributeCounts, stats.pageCacheSlots);
+        if (!pageCache.isOpen()) {
+            std::cerr << "Could not open the file: " << filename << std::endl;
+            return false;
+        }
+
+        // Second pass: build blocks face by face.
+        startTime = std::chrono::high_resolution_clock::now();
+
+        ObjMeshBlock block;
+        block.vertices.reserve(maxBlockVertices);
+        block.indices.reserve(maxBlockIndices);
+        IndexTripletMap blockVertices(maxBlockVertices);
+
+        bool sinkAccepted = true;
+        auto flushBlock = [&]() {
+            if (block.indices.empty()) {
+                return true;
+            }
+
+            TangentGenerator::generate(block.vertices, block.indices);
+
+            stats.vertexCount += block.vertices.size();
+            ++stats.blockCount;
+            sinkAccepted = sink(block);
+
+            block.vertices.clear();
+            block.indices.clear();
+            blockVertices.clear();
+            return sinkAccepted;
+        };
+
+        bool failed = false;
+        scanned = forEachLine(file, 0, window, stats.bytesRead, [&](const char* line, const char* end, uint64_t) {
+            line = TextScan::skipBlanks(line, end);
+            if (line >= end || *line != 'f') {
+                return true;
+            }
+
+            if (block.vertices.size() + 3 > maxBlockVertices || block.indices.size() + 3 > maxBlockIndices) {
+                if (!flushBlock()) {
+                    return false;
+                }
+            }
+
+            int corners[3][3];
+            const char* p = line + 1;
+            for (int i = 0; i < 3; ++i) {
+                p = TextScan::parseInt(p, end, corners[i][0]);
+                corners[i][1] = 0;
+                corners[i][2] = 0;
+                if (p < end && *p == '/') {
+                    p = TextScan::parseInt(p + 1, end, corners[i][1]);
+                }
+                if (p < end && *p == '/') {
+                    p = TextScan::parseInt(p + 1, end, corners[i][2]);
+                }
+                for (int& index : corners[i]) {
+                    index -= 1;
+                }
+            }
+
+            glm::vec3 positions[3];
+            glm::vec2 texCoords[3];
+            glm::vec3 normals[3];
+
+            for (int i = 0; i < 3; ++i) {
+                const glm::vec3* position = corners[i][0] >= 0 && static_cast<uint64_t>(corners[i][0]) < stats.positionCount
+                    ? pageCache.get(PositionAttribute, corners[i][0], stats) : nullptr;
+                if (position == nullptr) {
+                    std::cerr << "Vertex index out of range: " << corners[i][0] + 1 << std::endl;
+                    failed = true;
+                    return false;
+                }
+                positions[i] = *position;
+
+                texCoords[i] = glm::vec2(0.0f);
+                if (corners[i][1] >= 0) {
+                    const glm::vec3* texCoord = static_cast<uint64_t>(corners[i][1]) < stats.texCoordCount
+                        ? pageCache.get(TexCoordAttribute, corners[i][1], stats) : nullptr;
+                    if (texCoord == nullptr) {
+                        std::cerr << "Texture coordinate index out of range: " << corners[i][1] + 1 << std::endl;
+                        failed = true;
+                        return false;
+                    }
+                    texCoords[i] = glm::vec2(*texCoord);
+                }
+
+                normals[i] = glm::vec3(0.0f);
+                if (corners[i][2] >= 0) {
+                    const glm::vec3* normal = static_cast<uint64_t>(corners[i][2]) < stats.normalCount
+                        ? pageCache.get(NormalAttribute, corners[i][2], stats) : nullptr;
+                    if (normal == nullptr) {
+                        std::cerr << "Normal index out of range: " << corners[i][2] + 1 << std::endl;
+                        failed = true;
+                        return false;
+                    }
+                    normals[i] = *normal;
+                }
+            }
+
+            for (int i = 0; i < 3; ++i) {
+                auto [index, inserted] = blockVertices.findOrInsert(corners[i][0], corners[i][1], corners[i][2], static_cast<uint32_t>(block.vertices.size()));
+                if (inserted) {
+                    Vertex3D_PBR vertex{};
+                    vertex.pos = positions[i];
+                    vertex.normal = normals[i];
+                    vertex.texCoord = texCoords[i];
+                    vertex.color = { 1.0f, 1.0f, 1.0f };
+
+                    block.vertices.push_back(vertex);
+                }
+                block.indices.push_back(index);
+            }
+            return true;
+        });
+
+        if (!scanned || failed || !sinkAccepted || !flushBlock()) {
+            return false;
+        }
+        stats.secondPassMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        uint64_t pageLookups = stats.pageHits + stats.pageMisses;
+        std::cout << "Streamed " << filename << ": " << stats.fileSize << " bytes (" << stats.bytesRead << " read), "
+            << stats.triangleCount << " triangles into " << stats.blockCount << " blocks of " << stats.vertexCount << " vertices, scan "
+            << stats.firstPassMilliseconds << " ms, build " << stats.secondPassMilliseconds << " ms, page cache "
+            << stats.pageCacheSlots << " slots (" << (pageLookups > 0 ? 100.0 * stats.pageHits / pageLookups : 0.0) << "% hits), "
+            << stats.reservedBytes / (1024 * 1024) << " MiB reserved" << std::endl;
+
+        if (pStats != nullptr) {
+            *pStats = stats;
+        }
+        return true;
+    }
+}
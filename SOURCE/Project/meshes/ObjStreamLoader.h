@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <Vertex.h>
+
+namespace ObjLoader {
+    // A self-contained piece of the streamed mesh. Vertices are deduplicated within the block only,
+    // so vertices on block borders appear in both blocks, and every index is below maxBlockVertices.
+    struct ObjMeshBlock {
+        std::vector<Vertex3D_PBR> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    // Receives each block as soon as it is full. The block is reused afterwards, so the sink has to
+    // copy or write out whatever it keeps. Returning false stops the load.
+    using ObjBlockSink = std::function<bool(const ObjMeshBlock& block)>;
+
+    struct ObjStreamOptions {
+        // loadObjFile streams files larger than this instead of mapping and parsing them whole.
+        uint64_t streamThreshold = 512ull * 1024 * 1024;
+        size_t windowSize = 4 * 1024 * 1024;
+        size_t maxBlockVertices = 65535;
+        size_t maxBlockTriangles = 131072;
+        // Upper bound for everything the loader allocates: the read windows, one output block with
+        // its dedup table, and the attribute page cache, which gets whatever is left.
+        size_t memoryCeiling = 256 * 1024 * 1024;
+    };
+
+    struct ObjStreamStats {
+        uint64_t fileSize = 0;
+        uint64_t bytesRead = 0;
+        uint64_t positionCount = 0;
+        uint64_t texCoordCount = 0;
+        uint64_t normalCount = 0;
+        uint64_t triangleCount = 0;
+        uint64_t vertexCount = 0;
+        size_t blockCount = 0;
+        size_t pageCacheSlots = 0;
+        uint64_t pageHits = 0;
+        uint64_t pageMisses = 0;
+        size_t reservedBytes = 0;
+        double firstPassMilliseconds = 0.0;
+        double secondPassMilliseconds = 0.0;
+    };
+
+    // Loads OBJ files larger than memory in two passes over a fixed-size read window. The first pass
+    // records the file offset of every attributePageSize-th v, vt and vn line. The second pass
+    // parses the faces, fetches the attributes they reference through a bounded page cache, and
+    // emits deduplicated vertices into fixed-size blocks handed to sink. Memory use is set by
+    // options, not by the file size; only the page offset table grows, by 8 bytes per
+    // attributePageSize attributes.
+    bool streamObjFile(const std::string& filename, const ObjStreamOptions& options, const ObjBlockSink& sink, ObjStreamStats* pStats = nullptr);
+
+    constexpr size_t attributePageSize = 1024;
+}
@@ -0,0 +1,45 @@
+#include "PackedMesh.h"
+#include <cstring>
+
+void PackedMesh::storeIndices(const uint32_t* indices, size_t indexCount, VkIndexType indexType, void* destination) {
+    if (indexType == VK_INDEX_TYPE_UINT32) {
+        std::memcpy(destination, indices, indexCount * sizeof(uint32_t));
+        return;
+    }
+
+    uint16_t* shortIndices = static_cast<uint16_t*>(destination);
+    for (size_t i = 0; i < indexCount; ++i) {
+        shortIndices[i] = static_cast<uint16_t>(indices[i]);
+    }
+}
+
+bool PackedMesh::pack(const CachedMesh& meshData, PackedMesh& packedMesh) {
+    packedMesh.vertexCount = meshData.getVertexCount();
+    packedMesh.indexCount = meshData.getIndexCount();
+    packedMesh.indexType = getIndexType(packedMesh.vertexCount);
+    packedMesh.indexOffset = getIndexOffset(packedMesh.getVertexDataSize());
+    packedMesh.data.resize(packedMesh.indexOffset + packedMesh.getIndexDataSize());
+
+    // The cache's bounds are exactly the vertex bounds, so the quantization is known before any
+    // vertex is decoded.
+    packedMesh.bounds = meshData.getBounds();
+    GpuVertexFormat<Vertex3D_PBR>::getQuantization(packedMesh.bounds.min, packedMesh.bounds.max, packedMesh.positionScale, packedMesh.positionBias);
+
+    GpuVertex* vertices = reinterpret_cast<GpuVertex*>(packedMesh.data.data());
+    bool decoded = meshData.decodeVertices([&](const Vertex3D_PBR* blockVertices, size_t firstVertex, size_t vertexCount) {
+        GpuVertexFormat<Vertex3D_PBR>::pack(blockVertices, vertexCount, packedMesh.positionScale, packedMesh.positionBias, vertices + firstVertex);
+    });
+
+    uint8_t* indices = packedMesh.data.data() + packedMesh.indexOffset;
+    size_t indexSize = getIndexSize(packedMesh.indexType);
+    decoded = decoded && meshData.decodeIndices([&](const uint32_t* blockIndices, size_t firstIndex, size_t indexCount) {
+        storeIndices(blockIndices, indexCount, packedMesh.indexType, indices + firstIndex * indexSize);
+    });
+    if (!decoded) {
+        return false;
+    }
+
+    packedMesh.lods.assign(meshData.getLods(), meshData.getLods() + meshData.getLodCount());
+    packedMesh.meshlets.assign(meshData.getMeshlets(), meshData.getMeshlets() + meshData.getMeshletCount());
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <glm/glm.hpp>
+#include <Vertex.h>
+#include <meshes/MeshCache.h>
+#include <meshes/VertexQuantization.h>
+
+// A mesh already in the exact bytes its GPU buffers hold: quantized vertices first, then the indices
+// narrowed to 16 bits where the vertex count allows, at a 16-byte aligned offset. The AssetLoader
+// builds it on a worker thread, so the render thread only copies it to staging and records the
+// buffer copies.
+struct PackedMesh {
+    using GpuVertex = GpuVertexFormat<Vertex3D_PBR>::Type;
+
+    std::vector<uint8_t> data;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    size_t indexOffset = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    glm::vec3 positionScale{ 1.0f };
+    glm::vec3 positionBias{ 0.0f };
+
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
+    MeshBounds bounds{};
+
+    const uint8_t* getVertexData() const { return data.data(); }
+    size_t getVertexDataSize() const { return vertexCount * sizeof(GpuVertex); }
+    const uint8_t* getIndexData() const { return data.data() + indexOffset; }
+    size_t getIndexDataSize() const { return indexCount * getIndexSize(indexType); }
+
+    // Meshes that fit get a 16-bit index buffer, halving index fetch bandwidth.
+    static VkIndexType getIndexType(size_t vertexCount) { return vertexCount <= std::numeric_limits<uint16_t>::max() ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32; }
+    static size_t getIndexSize(VkIndexType indexType) { return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t); }
+    static size_t getIndexOffset(size_t vertexDataSize) { return (vertexDataSize + 15) & ~size_t(15); }
+    static void storeIndices(const uint32_t* indices, size_t indexCount, VkIndexType indexType, void* destination);
+
+    // Decodes, quantizes and narrows the cached geometry block by block into packedMesh. Returns
+    // false if the compressed data is corrupt.
+    static bool pack(const CachedMesh& meshData, PackedMesh& packedMesh);
+};
@@ -0,0 +1,282 @@
+#include "TangentGenerator.h"
+#include <threading/ThreadPool.h>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define TANGENT_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr size_t minTrianglesPerBatch = 16384;
+    constexpr size_t minVerticesPerRange = 16384;
+    // Every batch accumulates into a full-size tangent array, so huge meshes use fewer batches
+    // rather than one array per thread.
+    constexpr size_t maxAccumulatorBytes = 256 * 1024 * 1024;
+
+    // One float per triangle of a group of four. Masks are lanes of all ones or all zeros; the
+    // scalar build uses 1.0f and 0.0f and runs the same code lane by lane.
+#ifdef TANGENT_GENERATOR_SSE2
+    struct Float4 {
+        __m128 v;
+    };
+
+    Float4 operator+(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    Float4 operator-(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    Float4 operator*(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+    Float4 operator/(Float4 a, Float4 b) { return { _mm_div_ps(a.v, b.v) }; }
+    Float4 splat(float value) { return { _mm_set1_ps(value) }; }
+    Float4 sqrt4(Float4 a) { return { _mm_sqrt_ps(a.v) }; }
+    Float4 abs4(Float4 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+    Float4 min4(Float4 a, Float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+    Float4 max4(Float4 a, Float4 b) { return { _mm_max_ps(a.v, b.v) }; }
+    Float4 greater(Float4 a, Float4 b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+    Float4 both(Float4 a, Float4 b) { return { _mm_and_ps(a.v, b.v) }; }
+    Float4 select(Float4 mask, Float4 a, Float4 b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+    int getLaneMask(Float4 mask) { return _mm_movemask_ps(mask.v); }
+    void store(Float4 a, float* destination) { _mm_storeu_ps(destination, a.v); }
+
+    Float4 gather(const float* values, const uint32_t* lanes) {
+        return { _mm_set_ps(values[lanes[3]], values[lanes[2]], values[lanes[1]], values[lanes[0]]) };
+    }
+#else
+    struct Float4 {
+        float v[4];
+    };
+
+#define TANGENT_GENERATOR_PER_LANE(name, expression) \
+    Float4 name(Float4 a, Float4 b) { \
+        Float4 result; \
+        for (int lane = 0; lane < 4; ++lane) { \
+            float x = a.v[lane]; \
+            float y = b.v[lane]; \
+            result.v[lane] = (expression); \
+        } \
+        return result; \
+    }
+
+    TANGENT_GENERATOR_PER_LANE(operator+, x + y)
+    TANGENT_GENERATOR_PER_LANE(operator-, x - y)
+    TANGENT_GENERATOR_PER_LANE(operator*, x * y)
+    TANGENT_GENERATOR_PER_LANE(operator/, x / y)
+    TANGENT_GENERATOR_PER_LANE(min4, y < x ? y : x)
+    TANGENT_GENERATOR_PER_LANE(max4, y > x ? y : x)
+    TANGENT_GENERATOR_PER_LANE(greater, x > y ? 1.0f : 0.0f)
+    TANGENT_GENERATOR_PER_LANE(both, x != 0.0f && y != 0.0f ? 1.0f : 0.0f)
+#undef TANGENT_GENERATOR_PER_LANE
+
+    Float4 splat(float value) { return { { value, value, value, value } }; }
+    Float4 sqrt4(Float4 a) { return { { std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) } }; }
+    Float4 abs4(Float4 a) { return { { std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3]) } }; }
+    Float4 select(Float4 mask, Float4 a, Float4 b) {
+        Float4 result;
+        for (int lane = 0; lane < 4; ++lane) {
+            result.v[lane] = mask.v[lane] != 0.0f ? a.v[lane] : b.v[lane];
+        }
+        return result;
+    }
+    int getLaneMask(Float4 mask) {
+        int bits = 0;
+        for (int lane = 0; lane < 4; ++lane) {
+            bits |= mask.v[lane] != 0.0f ? 1 << lane : 0;
+        }
+        return bits;
+    }
+    void store(Float4 a, float* destination) { std::copy(a.v, a.v + 4, destination); }
+
+    Float4 gather(const float* values, const uint32_t* lanes) {
+        return { { values[lanes[0]], values[lanes[1]], values[lanes[2]], values[lanes[3]] } };
+    }
+#endif
+
+    struct Vector4x3 {
+        Float4 x;
+        Float4 y;
+        Float4 z;
+    };
+
+    Vector4x3 operator-(const Vector4x3& a, const Vector4x3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    Vector4x3 operator*(const Vector4x3& a, Float4 scale) { return { a.x * scale, a.y * scale, a.z * scale }; }
+    Float4 dot(const Vector4x3& a, const Vector4x3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    // Removes the component along normal and normalizes what is left. Lanes that end up zero stay
+    // zero, as in MikkTSpace.
+    Vector4x3 projectAndNormalize(const Vector4x3& vector, const Vector4x3& normal) {
+        Vector4x3 projected = vector - normal * dot(normal, vector);
+        Float4 lengthSquared = dot(projected, projected);
+        Float4 scale = select(greater(lengthSquared, splat(std::numeric_limits<float>::min())), splat(1.0f) / sqrt4(lengthSquared), splat(1.0f));
+        return projected * scale;
+    }
+
+    // Abramowitz and Stegun 4.4.46, accurate to 2e-8 over [-1, 1].
+    Float4 acos4(Float4 x) {
+        Float4 a = abs4(x);
+        Float4 polynomial = splat(-0.0012624911f);
+        for (float coefficient : { 0.0066700901f, -0.0170881256f, 0.0308918810f, -0.0501743046f, 0.0889789874f, -0.2145988016f, 1.5707963050f }) {
+            polynomial = polynomial * a + splat(coefficient);
+        }
+        Float4 result = sqrt4(splat(1.0f) - a) * polynomial;
+        return select(greater(splat(0.0f), x), splat(glm::pi<float>()) - result, result);
+    }
+
+    struct SoaVertices {
+        const float* position[3];
+        const float* normal[3];
+        const float* texCoord[2];
+    };
+
+    Vector4x3 gatherVector(const float* const* components, const uint32_t* lanes) {
+        return { gather(components[0], lanes), gather(components[1], lanes), gather(components[2], lanes) };
+    }
+
+    // Adds the angle-weighted tangents of four triangles to accumulator, whose x, y and z arrays
+    // follow each other. corners[c] holds corner c of each triangle; only the first laneCount
+    // lanes are real. Returns how many of those are degenerate.
+    size_t accumulateTriangles(const SoaVertices& soa, const uint32_t corners[3][4], size_t laneCount, float* accumulator, size_t vertexCount) {
+        Vector4x3 positions[3];
+        Vector4x3 normals[3];
+        Float4 u[3];
+        Float4 v[3];
+        for (int c = 0; c < 3; ++c) {
+            positions[c] = gatherVector(soa.position, corners[c]);
+            normals[c] = gatherVector(soa.normal, corners[c]);
+            u[c] = gather(soa.texCoord[0], corners[c]);
+            v[c] = gather(soa.texCoord[1], corners[c]);
+        }
+
+        Vector4x3 edge1 = positions[1] - positions[0];
+        Vector4x3 edge2 = positions[2] - positions[0];
+        Float4 deltaU1 = u[1] - u[0];
+        Float4 deltaV1 = v[1] - v[0];
+        Float4 deltaU2 = u[2] - u[0];
+        Float4 deltaV2 = v[2] - v[0];
+
+        // dP/du scaled by twice the signed UV area; only its direction is kept, flipped where the
+        // UVs are mirrored. Zero UV area or a zero direction marks the triangle degenerate.
+        Float4 area = deltaU1 * deltaV2 - deltaV1 * deltaU2;
+        Vector4x3 direction = edge1 * deltaV2 - edge2 * deltaV1;
+        Float4 lengthSquared = dot(direction, direction);
+        Float4 minValue = splat(std::numeric_limits<float>::min());
+        Float4 valid = both(greater(abs4(area), minValue), greater(lengthSquared, minValue));
+        Float4 sign = select(greater(splat(0.0f), area), splat(-1.0f), splat(1.0f));
+        Vector4x3 faceTangent = direction * select(valid, sign / sqrt4(lengthSquared), splat(0.0f));
+
+        float weighted[3][4];
+        for (int c = 0; c < 3; ++c) {
+            const Vector4x3& normal = normals[c];
+            Vector4x3 tangent = projectAndNormalize(faceTangent, normal);
+            Vector4x3 toPrevious = projectAndNormalize(positions[(c + 2) % 3] - positions[c], normal);
+            Vector4x3 toNext = projectAndNormalize(positions[(c + 1) % 3] - positions[c], normal);
+            Float4 angle = acos4(min4(max4(dot(toPrevious, toNext), splat(-1.0f)), splat(1.0f)));
+
+            store(tangent.x * angle, weighted[0]);
+            store(tangent.y * angle, weighted[1]);
+            store(tangent.z * angle, weighted[2]);
+            for (size_t lane = 0; lane < laneCount; ++lane) {
+                uint32_t vertex = corners[c][lane];
+                accumulator[vertex] += weighted[0][lane];
+                accumulator[vertexCount + vertex] += weighted[1][lane];
+                accumulator[2 * vertexCount + vertex] += weighted[2][lane];
+            }
+        }
+
+        int realLanes = (1 << laneCount) - 1;
+        int validLanes = getLaneMask(valid) & realLanes;
+        size_t validCount = 0;
+        for (; validLanes != 0; validLanes &= validLanes - 1) {
+            ++validCount;
+        }
+        return laneCount - validCount;
+    }
+}
+
+TangentStats TangentGenerator::generate(std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    TangentStats stats{};
+    size_t vertexCount = vertices.size();
+    size_t triangleCount = indices.size() / 3;
+    stats.triangleCount = triangleCount;
+    if (vertexCount == 0) {
+        return stats;
+    }
+
+    ThreadPool& threadPool = ThreadPool::getShared();
+
+    std::vector<float> soaData(vertexCount * 8);
+    float* pSoa = soaData.data();
+    SoaVertices soa{
+        { pSoa, pSoa + vertexCount, pSoa + 2 * vertexCount },
+        { pSoa + 3 * vertexCount, pSoa + 4 * vertexCount, pSoa + 5 * vertexCount },
+        { pSoa + 6 * vertexCount, pSoa + 7 * vertexCount }
+    };
+    threadPool.parallelFor(vertexCount, minVerticesPerRange, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Vertex3D_PBR& vertex = vertices[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                pSoa[axis * vertexCount + i] = vertex.pos[axis];
+                pSoa[(3 + axis) * vertexCount + i] = vertex.normal[axis];
+            }
+            pSoa[6 * vertexCount + i] = vertex.texCoord.x;
+            pSoa[7 * vertexCount + i] = vertex.texCoord.y;
+        }
+    });
+
+    size_t accumulatorBytes = vertexCount * 3 * sizeof(float);
+    size_t batchCount = std::min(threadPool.getThreadCount(), (triangleCount + minTrianglesPerBatch - 1) / minTrianglesPerBatch);
+    batchCount = std::max<size_t>(1, std::min(batchCount, maxAccumulatorBytes / accumulatorBytes));
+
+    std::vector<std::vector<float>> accumulators(batchCount);
+    std::vector<size_t> degenerateCounts(batchCount, 0);
+    threadPool.parallelFor(batchCount, 1, [&](size_t begin, size_t end) {
+        for (size_t batch = begin; batch < end; ++batch) {
+            std::vector<float>& accumulator = accumulators[batch];
+            accumulator.assign(vertexCount * 3, 0.0f);
+
+            size_t firstTriangle = triangleCount * batch / batchCount;
+            size_t lastTriangle = triangleCount * (batch + 1) / batchCount;
+            for (size_t triangle = firstTriangle; triangle < lastTriangle; triangle += 4) {
+                size_t laneCount = std::min<size_t>(4, lastTriangle - triangle);
+                uint32_t corners[3][4];
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    // Spare lanes repeat the first triangle and are not written back.
+                    const uint32_t* source = &indices[(triangle + (lane < laneCount ? lane : 0)) * 3];
+                    for (int c = 0; c < 3; ++c) {
+                        corners[c][lane] = source[c];
+                    }
+                }
+                degenerateCounts[batch] += accumulateTriangles(soa, corners, laneCount, accumulator.data(), vertexCount);
+            }
+        }
+    });
+
+    threadPool.parallelFor(vertexCount, minVerticesPerRange, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 sum{ 0.0f };
+            for (const std::vector<float>& accumulator : accumulators) {
+                sum += glm::vec3{ accumulator[i], accumulator[vertexCount + i], accumulator[2 * vertexCount + i] };
+            }
+
+            const glm::vec3& n = vertices[i].normal;
+            glm::vec3 t = sum - n * glm::dot(n, sum);
+            if (glm::dot(t, t) < 1e-12f) {
+                // No usable UVs: any direction perpendicular to the normal will do.
+                t = glm::cross(n, std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+                if (glm::dot(t, t) < 1e-12f) {
+                    t = glm::vec3(1.0f, 0.0f, 0.0f);
+                }
+            }
+            vertices[i].tangent = glm::normalize(t);
+        }
+    });
+
+    for (size_t count : degenerateCounts) {
+        stats.degenerateTriangleCount += count;
+    }
+    stats.threadCount = batchCount;
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return stats;
+}
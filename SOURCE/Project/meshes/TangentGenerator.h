@@ -0,0 +1,28 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <Vertex.h>
+
+struct TangentStats {
+    size_t triangleCount = 0;
+    // Triangles with collinear texture coordinates or positions, which add nothing to the tangents.
+    size_t degenerateTriangleCount = 0;
+    size_t threadCount = 0;
+    double milliseconds = 0.0;
+
+    double getTrianglesPerSecondPerThread() const { return milliseconds > 0.0 ? triangleCount / (milliseconds * 0.001) / threadCount : 0.0; }
+};
+
+namespace TangentGenerator {
+    // Writes the MikkTSpace tangent of every vertex: each triangle's dP/du direction, projected into
+    // the vertex's tangent plane and normalized, weighted by the triangle's angle at the vertex.
+    // Handedness is not handled: Vertex3D_PBR stores no bitangent sign and the shader always builds
+    // the bitangent as cross(N, T), so on mirrored UVs the tangent matches MikkTSpace but normal
+    // maps come out flipped along the bitangent. Vertices without a usable triangle get an
+    // arbitrary direction perpendicular to the normal.
+    //
+    // Positions, normals and texture coordinates are copied into separate arrays first, and the
+    // triangles are processed four at a time in SIMD lanes, in one batch per thread with its own
+    // accumulator, so no two threads ever add to the same tangent.
+    TangentStats generate(std::vector<Vertex3D_PBR>& vertices, const std::vector<uint32_t>& indices);
+}
@@ -0,0 +1,266 @@
+#include "TriangleBvh.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+    constexpr uint32_t binCount = 16;
+    constexpr size_t maxLeafTriangles = 4;
+    // Leaves that the heuristic prefers are still capped, so a cluster of coincident triangles
+    // cannot turn into one huge leaf.
+    constexpr size_t maxPreferredLeafTriangles = 16;
+    // Deeper subtrees become leaves, which bounds the traversal stack.
+    constexpr size_t maxDepth = 64;
+
+    float getSurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3{ 0.0f });
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    struct Bin {
+        glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+        glm::vec3 boundsMax{ -std::numeric_limits<float>::max() };
+        size_t triangleCount = 0;
+    };
+
+    // Returns the ray's entry distance into the box, or infinity if it misses within [tMin, tMax].
+    float intersectBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec3& origin, const glm::vec3& inverseDirection, float tMin, float tMax) {
+        glm::vec3 t0 = (boundsMin - origin) * inverseDirection;
+        glm::vec3 t1 = (boundsMax - origin) * inverseDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, tMin));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+        return entry <= exit ? entry : std::numeric_limits<float>::infinity();
+    }
+}
+
+void TriangleBvh::build(const glm::vec3* positions, const uint32_t* indices, size_t indexOffset, size_t indexCount) {
+    m_Nodes.clear();
+    m_Triangles.clear();
+
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    std::vector<BuildTriangle> triangles(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        const uint32_t* triangle = indices + indexOffset + i * 3;
+        const glm::vec3& a = positions[triangle[0]];
+        const glm::vec3& b = positions[triangle[1]];
+        const glm::vec3& c = positions[triangle[2]];
+
+        triangles[i].boundsMin = glm::min(a, glm::min(b, c));
+        triangles[i].boundsMax = glm::max(a, glm::max(b, c));
+        triangles[i].centroid = (a + b + c) / 3.0f;
+        triangles[i].index = static_cast<uint32_t>(i);
+    }
+
+    m_Nodes.reserve(triangleCount * 2);
+    m_Nodes.push_back({});
+    subdivide(0, triangles, 0, triangleCount);
+
+    m_Triangles.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        const uint32_t* triangle = indices + indexOffset + triangles[i].index * 3;
+        const glm::vec3& a = positions[triangle[0]];
+        m_Triangles[i].v0 = a;
+        m_Triangles[i].edge1 = positions[triangle[1]] - a;
+        m_Triangles[i].edge2 = positions[triangle[2]] - a;
+    }
+}
+
+void TriangleBvh::subdivide(uint32_t rootIndex, std::vector<BuildTriangle>& triangles, size_t rootBegin, size_t rootEnd) {
+    struct Task {
+        uint32_t nodeIndex;
+        size_t begin;
+        size_t end;
+        size_t depth;
+    };
+    std::vector<Task> tasks{ { rootIndex, rootBegin, rootEnd, 0 } };
+
+    while (!tasks.empty()) {
+        Task task = tasks.back();
+        tasks.pop_back();
+
+        glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+        glm::vec3 boundsMax{ -std::numeric_limits<float>::max() };
+        glm::vec3 centroidMin = boundsMin;
+        glm::vec3 centroidMax = boundsMax;
+        for (size_t i = task.begin; i < task.end; ++i) {
+            boundsMin = glm::min(boundsMin, triangles[i].boundsMin);
+            boundsMax = glm::max(boundsMax, triangles[i].boundsMax);
+            centroidMin = glm::min(centroidMin, triangles[i].centroid);
+            centroidMax = glm::max(centroidMax, triangles[i].centroid);
+        }
+
+        Node& node = m_Nodes[task.nodeIndex];
+        node.boundsMin = boundsMin;
+        node.boundsMax = boundsMax;
+        node.firstIndex = static_cast<uint32_t>(task.begin);
+        node.triangleCount = static_cast<uint32_t>(task.end - task.begin);
+
+        size_t count = task.end - task.begin;
+        if (count <= maxLeafTriangles || task.depth + 1 >= maxDepth) {
+            continue;
+        }
+
+        // Binned SAH over all three axes; the cost of a leaf is its triangle count and the cost
+        // of a split is one traversal step plus each side's count weighted by its area.
+        float parentArea = std::max(getSurfaceArea(boundsMin, boundsMax), std::numeric_limits<float>::min());
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            float extent = centroidMax[axis] - centroidMin[axis];
+            if (!(extent > 0.0f)) {
+                continue;
+            }
+
+            float binScale = binCount / extent;
+            Bin bins[binCount];
+            for (size_t i = task.begin; i < task.end; ++i) {
+                uint32_t bin = std::min(binCount - 1, static_cast<uint32_t>((triangles[i].centroid[axis] - centroidMin[axis]) * binScale));
+                bins[bin].boundsMin = glm::min(bins[bin].boundsMin, triangles[i].boundsMin);
+                bins[bin].boundsMax = glm::max(bins[bin].boundsMax, triangles[i].boundsMax);
+                ++bins[bin].triangleCount;
+            }
+
+            float rightArea[binCount];
+            size_t rightCount[binCount];
+            Bin right{};
+            for (uint32_t bin = binCount - 1; bin > 0; --bin) {
+                right.boundsMin = glm::min(right.boundsMin, bins[bin].boundsMin);
+                right.boundsMax = glm::max(right.boundsMax, bins[bin].boundsMax);
+                right.triangleCount += bins[bin].triangleCount;
+                rightArea[bin] = getSurfaceArea(right.boundsMin, right.boundsMax);
+                rightCount[bin] = right.triangleCount;
+            }
+
+            Bin left{};
+            for (uint32_t split = 1; split < binCount; ++split) {
+                left.boundsMin = glm::min(left.boundsMin, bins[split - 1].boundsMin);
+                left.boundsMax = glm::max(left.boundsMax, bins[split - 1].boundsMax);
+                left.triangleCount += bins[split - 1].triangleCount;
+                if (left.triangleCount == 0 || rightCount[split] == 0) {
+                    continue;
+                }
+
+                float cost = 1.0f + (getSurfaceArea(left.boundsMin, left.boundsMax) * left.triangleCount + rightArea[split] * rightCount[split]) / parentArea;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        size_t middle;
+        if (bestAxis >= 0) {
+            if (bestCost >= static_cast<float>(count) && count <= maxPreferredLeafTriangles) {
+                continue;
+            }
+
+            float binScale = binCount / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+            auto it = std::partition(triangles.begin() + task.begin, triangles.begin() + task.end, [&](const BuildTriangle& triangle) {
+                return std::min(binCount - 1, static_cast<uint32_t>((triangle.centroid[bestAxis] - centroidMin[bestAxis]) * binScale)) < bestSplit;
+            });
+            middle = static_cast<size_t>(it - triangles.begin());
+        }
+        else {
+            // Every centroid coincides; split the list in half so leaves stay small.
+            middle = task.begin + count / 2;
+        }
+
+        uint32_t leftIndex = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.push_back({});
+        m_Nodes.push_back({});
+
+        Node& parent = m_Nodes[task.nodeIndex];
+        parent.firstIndex = leftIndex;
+        parent.triangleCount = 0;
+
+        tasks.push_back({ leftIndex, task.begin, middle, task.depth + 1 });
+        tasks.push_back({ leftIndex + 1, middle, task.end, task.depth + 1 });
+    }
+}
+
+bool TriangleBvh::isOccluded(const glm::vec3& origin, const glm::vec3& direction, float tMin, float tMax) const {
+    if (m_Nodes.empty()) {
+        return false;
+    }
+
+    glm::vec3 inverseDirection;
+    for (int axis = 0; axis < 3; ++axis) {
+        inverseDirection[axis] = 1.0f / (direction[axis] != 0.0f ? direction[axis] : 1e-30f);
+    }
+
+    if (intersectBounds(m_Nodes[0].boundsMin, m_Nodes[0].boundsMax, origin, inverseDirection, tMin, tMax) == std::numeric_limits<float>::infinity()) {
+        return false;
+    }
+
+    uint32_t stack[maxDepth];
+    size_t stackSize = 0;
+    uint32_t nodeIndex = 0;
+
+    while (true) {
+        const Node& node = m_Nodes[nodeIndex];
+        if (node.triangleCount > 0) {
+            for (uint32_t i = 0; i < node.triangleCount; ++i) {
+                // Moller-Trumbore, accepting both windings.
+                const Triangle& triangle = m_Triangles[node.firstIndex + i];
+                glm::vec3 p = glm::cross(direction, triangle.edge2);
+                float determinant = glm::dot(triangle.edge1, p);
+                if (determinant == 0.0f) {
+                    continue;
+                }
+
+                float inverseDeterminant = 1.0f / determinant;
+                glm::vec3 s = origin - triangle.v0;
+                float u = glm::dot(s, p) * inverseDeterminant;
+                if (!(u >= 0.0f && u <= 1.0f)) {
+                    continue;
+                }
+
+                glm::vec3 q = glm::cross(s, triangle.edge1);
+                float v = glm::dot(direction, q) * inverseDeterminant;
+                if (!(v >= 0.0f && u + v <= 1.0f)) {
+                    continue;
+                }
+
+                float t = glm::dot(triangle.edge2, q) * inverseDeterminant;
+                if (t > tMin && t < tMax) {
+                    return true;
+                }
+            }
+        }
+        else {
+            // Visit the nearer child first and keep the other for later.
+            const Node& left = m_Nodes[node.firstIndex];
+            const Node& right = m_Nodes[node.firstIndex + 1];
+            float leftEntry = intersectBounds(left.boundsMin, left.boundsMax, origin, inverseDirection, tMin, tMax);
+            float rightEntry = intersectBounds(right.boundsMin, right.boundsMax, origin, inverseDirection, tMin, tMax);
+            bool hitLeft = leftEntry != std::numeric_limits<float>::infinity();
+            bool hitRight = rightEntry != std::numeric_limits<float>::infinity();
+
+            if (hitLeft && hitRight) {
+                uint32_t nearIndex = leftEntry <= rightEntry ? node.firstIndex : node.firstIndex + 1;
+                uint32_t farIndex = leftEntry <= rightEntry ? node.firstIndex + 1 : node.firstIndex;
+                stack[stackSize++] = farIndex;
+                nodeIndex = nearIndex;
+                continue;
+            }
+            if (hitLeft || hitRight) {
+                nodeIndex = hitLeft ? node.firstIndex : node.firstIndex + 1;
+                continue;
+            }
+        }
+
+        if (stackSize == 0) {
+            return false;
+        }
+        nodeIndex = stack[--stackSize];
+    }
+}
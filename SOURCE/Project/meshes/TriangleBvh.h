@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Bounding volume hierarchy over a triangle list for ray queries on the CPU, built with the
+// binned surface area heuristic. Leaves keep their triangles as one edge-precomputed array in leaf
+// order, so traversal reads nodes and triangles sequentially. The queries are const and can run
+// from any number of threads at once.
+class TriangleBvh {
+public:
+    // Builds over the triangles in indices[indexOffset, indexOffset + indexCount).
+    void build(const glm::vec3* positions, const uint32_t* indices, size_t indexOffset, size_t indexCount);
+
+    // True if the ray hits any triangle, from either side, at a distance in (tMin, tMax).
+    // direction need not be normalized; distances are in units of its length.
+    bool isOccluded(const glm::vec3& origin, const glm::vec3& direction, float tMin, float tMax) const;
+
+    size_t getTriangleCount() const { return m_Triangles.size(); }
+    size_t getNodeCount() const { return m_Nodes.size(); }
+
+private:
+    // An inner node's children are stored next to each other, the first at firstIndex. A leaf
+    // holds triangleCount triangles starting at firstIndex.
+    struct Node {
+        glm::vec3 boundsMin;
+        uint32_t firstIndex;
+        glm::vec3 boundsMax;
+        uint32_t triangleCount;
+    };
+
+    struct Triangle {
+        glm::vec3 v0;
+        glm::vec3 edge1;
+        glm::vec3 edge2;
+    };
+
+    struct BuildTriangle {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        glm::vec3 centroid;
+        uint32_t index;
+    };
+
+    void subdivide(uint32_t nodeIndex, std::vector<BuildTriangle>& triangles, size_t begin, size_t end);
+
+    std::vector<Node> m_Nodes;
+    std::vector<Triangle> m_Triangles;
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include "Vertex.h"
+
+namespace VertexQuantization {
+    inline glm::vec2 encodeOctahedral(const glm::vec3& direction) {
+        glm::vec3 n = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+        if (n.z < 0.0f) {
+            return {
+                (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+            };
+        }
+        return { n.x, n.y };
+    }
+
+    inline glm::vec3 decodeOctahedral(const glm::vec2& encoded) {
+        glm::vec3 n{ encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+        float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    inline Vertex3D_PBR_Compact compress(const Vertex3D_PBR& vertex, const glm::vec3& positionScale, const glm::vec3& positionBias) {
+        Vertex3D_PBR_Compact compact{};
+
+        glm::vec3 normalized = (vertex.pos - positionBias) / positionScale;
+        compact.pos[0] = glm::packUnorm1x16(normalized.x);
+        compact.pos[1] = glm::packUnorm1x16(normalized.y);
+        compact.pos[2] = glm::packUnorm1x16(normalized.z);
+        compact.pos[3] = glm::packUnorm1x16(vertex.color.r);
+
+        compact.texCoord[0] = glm::packHalf1x16(vertex.texCoord.x);
+        compact.texCoord[1] = glm::packHalf1x16(vertex.texCoord.y);
+
+        glm::vec2 normal = encodeOctahedral(vertex.normal);
+        compact.normal[0] = glm::packSnorm1x16(normal.x);
+        compact.normal[1] = glm::packSnorm1x16(normal.y);
+
+        glm::vec2 tangent = encodeOctahedral(vertex.tangent);
+        compact.tangent[0] = glm::packSnorm1x16(tangent.x);
+        compact.tangent[1] = glm::packSnorm1x16(tangent.y);
+
+        return compact;
+    }
+}
+
+// Maps a CPU vertex type to the layout uploaded to the GPU. Types without a compact form upload
+// as they are, with an identity position scale and bias. pack() writes each vertex once, in order,
+// so the destination can be mapped staging memory.
+template <typename VertexType>
+struct GpuVertexFormat {
+    using Type = VertexType;
+
+    static void getQuantization(const VertexType*, size_t, glm::vec3& positionScale, glm::vec3& positionBias) {
+        positionScale = glm::vec3{ 1.0f };
+        positionBias = glm::vec3{ 0.0f };
+    }
+
+    static void pack(const VertexType* vertices, size_t vertexCount, const glm::vec3&, const glm::vec3&, Type* destination) {
+        std::memcpy(destination, vertices, vertexCount * sizeof(Type));
+    }
+};
+
+template <>
+struct GpuVertexFormat<Vertex3D_PBR> {
+    using Type = Vertex3D_PBR_Compact;
+
+    // Flat axes (a quad, a plane) keep a non-zero scale so the division stays finite.
+    static void getQuantization(const glm::vec3& boundsMin, const glm::vec3& boundsMax, glm::vec3& positionScale, glm::vec3& positionBias) {
+        positionBias = boundsMin;
+        positionScale = glm::max(boundsMax - boundsMin, glm::vec3{ 1e-6f });
+    }
+
+    static void getQuantization(const Vertex3D_PBR* vertices, size_t vertexCount, glm::vec3& positionScale, glm::vec3& positionBias) {
+        glm::vec3 boundsMin{ 0.0f };
+        glm::vec3 boundsMax{ 0.0f };
+        if (vertexCount > 0) {
+            boundsMin = boundsMax = vertices[0].pos;
+            for (size_t i = 1; i < vertexCount; ++i) {
+                boundsMin = glm::min(boundsMin, vertices[i].pos);
+                boundsMax = glm::max(boundsMax, vertices[i].pos);
+            }
+        }
+        getQuantization(boundsMin, boundsMax, positionScale, positionBias);
+    }
+
+    static void pack(const Vertex3D_PBR* vertices, size_t vertexCount, const glm::vec3& positionScale, const glm::vec3& positionBias, Type* destination) {
+        for (size_t i = 0; i < vertexCount; ++i) {
+            destination[i] = VertexQuantization::compress(vertices[i], positionScale, positionBias);
+        }
+    }
+};
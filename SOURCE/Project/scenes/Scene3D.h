@@ -32,8 +32,8 @@ void Scene3D<VertexType>::createScene(const VkDevice& device, const VkPhysicalDe
         3, 0, 4
     };
 
-    meshPyramid.setVertices(pyramidVertices);
-    meshPyramid.setIndices(pyramidIndices);
+    meshPyramid.setVertices(std::move(pyramidVertices));
+    meshPyramid.setIndices(std::move(pyramidIndices));
 
     meshPyramid.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -29.5f, 0.5f, 0 }) * glm::scale(glm::mat4(1.0f), { 2.0f, 2.0f, 2.0f });
 
@@ -53,8 +53,8 @@ void Scene3D<VertexType>::createScene(const VkDevice& device, const VkPhysicalDe
         0, 2, 3
     };
 
-    meshSquare.setVertices(squareVertices);
-    meshSquare.setIndices(squareIndices);
+    meshSquare.setVertices(std::move(squareVertices));
+    meshSquare.setIndices(std::move(squareIndices));
 
     meshSquare.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -32.5f, 0.5f, 0 }) * glm::scale(glm::mat4(1.0f), { 2.0f, 2.0f, 2.0f });
 
@@ -95,8 +95,8 @@ void Scene3D<VertexType>::createScene(const VkDevice& device, const VkPhysicalDe
         0, 5, 1
     };
 
-    meshCube.setVertices(cubeVertices);
-    meshCube.setIndices(cubeIndices);
+    meshCube.setVertices(std::move(cubeVertices));
+    meshCube.setIndices(std::move(cubeIndices));
 
     meshCube.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -26.5f, 0.5f, 0 }) * glm::scale(glm::mat4(1.0f), { 2.0f, 2.0f, 2.0f });
 
@@ -1,5 +1,10 @@
     #pragma once
 #include "SceneBase.h"
+#include <chrono>
+#include <meshes/MeshAssetRegistry.h>
+#include <assets/AssetLoader.h>
+#include <texture/TextureCache.h>
+#include <texture/SamplerCache.h>
 
 template <typename VertexType>
 class Scene3D_PBR : public SceneBase<VertexType> {
@@ -7,81 +12,113 @@ public:
     void createScene(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, QueueFamilyIndices queueFamily, const VkQueue& graphicsQueue, MaterialManager& materialManager);
     void draw(Camera& camera, CommandBuffer& commandBuffer, GraphicsPipeline& graphicsPipeline, SwapChain& swapChain, int imageIndex, int renderMode);
     void update(float deltaTime) override;
+    void cleanUp(const VkDevice& device);
+
+private:
+    // Meshes and materials start out with placeholders and are filled in by processLoadedAssets()
+    // as the AssetLoader finishes them, so the scene renders from the first frame.
+    struct PendingMaterial {
+        std::shared_ptr<Material> material;
+        std::vector<std::string> texturePaths;
+        std::vector<std::shared_future<std::shared_ptr<const TextureImage>>> images;
+    };
+
+    // What each material slot holds, in binding order: albedo, normal, specular, gloss.
+    static constexpr TextureRole materialTextureRoles[] = { TextureRole::Color, TextureRole::Normal, TextureRole::Mask, TextureRole::Mask };
+    static TextureRole getTextureRole(size_t slot) { return slot < std::size(materialTextureRoles) ? materialTextureRoles[slot] : TextureRole::Color; }
+
+    struct PendingMesh {
+        size_t meshIndex;
+        std::string objPath;
+        MeshProcessingOptions options;
+        std::shared_future<std::shared_ptr<const PackedMesh>> meshData;
+    };
+
+    void createPlaceholders();
+    std::shared_ptr<Material> createStreamedMaterial(MaterialManager& materialManager, const std::vector<std::string>& texturePaths);
+    void addStreamedMesh(Mesh<VertexType>& mesh, const std::string& objPath, const MeshProcessingOptions& options = {});
+
+    // Creates GPU resources for everything the workers have finished. Called at the start of draw(),
+    // after the previous frame's fence, so material descriptor sets are no longer in use.
+    void processLoadedAssets();
+
+    VkDevice m_Device{};
+    VkPhysicalDevice m_PhysDevice{};
+    VkCommandPool m_CommandPool{};
+    QueueFamilyIndices m_QueueFamily{};
+    VkQueue m_GraphicsQueue{};
+
+    AssetLoader m_AssetLoader;
+    TextureCache m_TextureCache;
+    MeshAssetRegistry m_MeshAssets;
+
+    std::vector<std::shared_ptr<Texture>> m_pPlaceholderTextures;
+    std::shared_ptr<MeshAsset<VertexType>> m_pPlaceholderMesh;
+
+    std::vector<PendingMaterial> m_PendingMaterials;
+    std::vector<PendingMesh> m_PendingMeshes;
+    std::chrono::high_resolution_clock::time_point m_LoadStartTime{};
+    size_t m_MaterialTextureCount = 0;
+    double m_TextureUploadMilliseconds = 0.0;
 };
 
 template <typename VertexType>
 void Scene3D_PBR<VertexType>::createScene(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, QueueFamilyIndices queueFamily, const VkQueue& graphicsQueue, MaterialManager& materialManager) {
-    auto texture = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/vehicle/vehicle_diffuse.png");
-    auto texture2 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/vehicle/vehicle_normal.png");
-    auto texture3 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/vehicle/vehicle_specular.png");
-    auto texture4 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/vehicle/vehicle_gloss.png");
+    m_Device = device;
+    m_PhysDevice = physDevice;
+    m_CommandPool = commandPool;
+    m_QueueFamily = queueFamily;
+    m_GraphicsQueue = graphicsQueue;
+    m_LoadStartTime = std::chrono::high_resolution_clock::now();
 
-    auto myMaterial = materialManager.createMaterial(device, { texture, texture2, texture3, texture4 });
+    m_MeshAssets.initialize(device, physDevice, queueFamily, graphicsQueue);
+    m_TextureCache.initialize(device, physDevice, commandPool, graphicsQueue);
+    // Models tend to ship their own copies of flat normal, black and white maps; with hashing on,
+    // those share one texture. TextureContentCheck lists which images under models/ would.
+    m_TextureCache.setContentHashing(true);
+    createPlaceholders();
+    m_AssetLoader.setBlockCompression(Texture::supportsBlockCompression(physDevice));
+    m_AssetLoader.beginBatch();
 
-    auto brickTexture = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/bricks/Bricks_diffuse.png");
-    auto brickTexture2 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/bricks/Bricks_normal_small.png");
-    auto brickTexture3 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/bricks/Bricks_specular.png");
-    auto brickTexture4 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/bricks/Bricks_gloss.png");
+    auto myMaterial = createStreamedMaterial(materialManager, {
+        "models/vehicle/vehicle_diffuse.png", "models/vehicle/vehicle_normal.png", "models/vehicle/vehicle_specular.png", "models/vehicle/vehicle_gloss.png" });
 
-    auto myBrickMaterial = materialManager.createMaterial(device, { brickTexture, brickTexture2, brickTexture3, brickTexture4 });
+    auto myBrickMaterial = createStreamedMaterial(materialManager, {
+        "models/bricks/Bricks_diffuse.png", "models/bricks/Bricks_normal_small.png", "models/bricks/Bricks_specular.png", "models/bricks/Bricks_gloss.png" });
 
-    auto defaultTexture = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/uv_grid/uv_grid.png");
-    auto defaultTexture2 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/uv_grid/defaultNormal.png");
-    auto defaultTexture3 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/uv_grid/defaultBlack.png");
-    auto defaultTexture4 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/uv_grid/uv_grid.png");
+    auto mydefaultTextureMaterial = createStreamedMaterial(materialManager, {
+        "models/uv_grid/uv_grid.png", "models/uv_grid/defaultNormal.png", "models/uv_grid/defaultBlack.png", "models/uv_grid/uv_grid.png" });
 
-    auto mydefaultTextureMaterial = materialManager.createMaterial(device, { defaultTexture, defaultTexture2, defaultTexture3, defaultTexture4 });
+    auto myDirtTextureMaterial = createStreamedMaterial(materialManager, {
+        "models/dirt/Dirt wet_4K_Diffuse_small.png", "models/dirt/Dirt wet_4K_Normal_small.png", "models/dirt/Dirt wet_4K_Specular_small.png", "models/dirt/Dirt wet_4K_Gloss_small.png" });
 
-    auto dirtTexture = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/dirt/Dirt wet_4K_Diffuse_small.png");
-    auto dirtTexture2 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/dirt/Dirt wet_4K_Normal_small.png");
-    auto dirtTexture3 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/dirt/Dirt wet_4K_Specular_small.png");
-    auto dirtTexture4 = std::make_shared<Texture>(device, physDevice, commandPool, graphicsQueue, "models/dirt/Dirt wet_4K_Gloss_small.png");
-
-    auto myDirtTextureMaterial = materialManager.createMaterial(device, { dirtTexture, dirtTexture2, dirtTexture3, dirtTexture4 });
 
+    // Must match the preset in models/cook.txt, or the cooked mesh is rebuilt on first load.
+    const MeshProcessingOptions cubeProcessingOptions = MeshProcessingOptions::createMinimal();
 
     Mesh<VertexType> vehicle;
-    std::vector<VertexType> vehicleVertices;
-    std::vector<uint32_t> vehicleIndices;
 
-    if (ObjLoader::loadObjFile("models/vehicle.obj", vehicleVertices, vehicleIndices)) {
-        vehicle.setVertices(vehicleVertices);
-        vehicle.setIndices(vehicleIndices);
-        vehicle.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { 0.5f, 0.5f, 0 }) *
-            glm::scale(glm::mat4(1.0f), { 0.2f, 0.2f, 0.2f });
-        vehicle.m_pMaterial = myMaterial;
+    vehicle.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { 0.5f, 0.5f, 0 }) *
+        glm::scale(glm::mat4(1.0f), { 0.2f, 0.2f, 0.2f });
+    vehicle.m_pMaterial = myMaterial;
 
-        addMesh(vehicle, device, physDevice, queueFamily, graphicsQueue);
-    }
+    addStreamedMesh(vehicle, "models/vehicle.obj");
 
     {
         Mesh<VertexType> square;
-        std::vector<VertexType> squareVertices;
-        std::vector<uint32_t> squareIndices;
 
-        if (ObjLoader::loadObjFile("models/square.obj", squareVertices, squareIndices)) {
-            square.setVertices(squareVertices);
-            square.setIndices(squareIndices);
-            square.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -10.5f, 0.5, 0 }) * rotate(glm::mat4(1.0f), glm::pi<float>(), glm::vec3(0.0f, 0.0f, 1.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.2f, 0.2f, 0.2f));
-            square.m_pMaterial = myBrickMaterial;
+        square.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -10.5f, 0.5, 0 }) * rotate(glm::mat4(1.0f), glm::pi<float>(), glm::vec3(0.0f, 0.0f, 1.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.2f, 0.2f, 0.2f));
+        square.m_pMaterial = myBrickMaterial;
 
-            addMesh(square, device, physDevice, queueFamily, graphicsQueue);
-        }
+        addStreamedMesh(square, "models/square.obj", cubeProcessingOptions);
 
 
         Mesh<VertexType> sphere2;
-        std::vector<VertexType> sphere2Vertices;
-        std::vector<uint32_t> sphere2Indices;
 
-        if (ObjLoader::loadObjFile("models/sphere.obj", sphere2Vertices, sphere2Indices)) {
+        sphere2.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -13.5f, 0.5f, 0 });
+        sphere2.m_pMaterial = myDirtTextureMaterial;
 
-            sphere2.setVertices(sphere2Vertices);
-            sphere2.setIndices(sphere2Indices);
-            sphere2.m_ModelMatrix = glm::translate(glm::mat4(1.0f), { -13.5f, 0.5f, 0 });
-            sphere2.m_pMaterial = myDirtTextureMaterial;
-
-            addMesh(sphere2, device, physDevice, queueFamily, graphicsQueue);
-        }
+        addStreamedMesh(sphere2, "models/sphere.obj");
     }
 
 
@@ -93,45 +130,37 @@ void Scene3D_PBR<VertexType>::createScene(const VkDevice& device, const VkPhysic
     //bouncy balls
     {
         const int numberOfBouncyBalls = 10;
-        std::vector<VertexType> sphereVertices;
-        std::vector<uint32_t> sphereIndices;
+        const float radius = 10.0f;
+        const btVector3 center(18.0f, 30.3f, 0.0f);
 
-        if (ObjLoader::loadObjFile("models/sphere.obj", sphereVertices, sphereIndices)) {
-            const float radius = 10.0f;
-            const btVector3 center(18.0f, 30.3f, 0.0f);
-
-            for (int i = 0; i < numberOfBouncyBalls; ++i)
-            {
-                Mesh<VertexType> sphere;
-
-                sphere.setVertices(sphereVertices);
-                sphere.setIndices(sphereIndices);
+        for (int i = 0; i < numberOfBouncyBalls; ++i)
+        {
+            Mesh<VertexType> sphere;
 
-                float angle = i * (2 * float(M_PI) / numberOfBouncyBalls);
+            float angle = i * (2 * float(M_PI) / numberOfBouncyBalls);
 
 
-                float yVariation = static_cast<float>(i * 2);
+            float yVariation = static_cast<float>(i * 2);
 
-                btVector3 initialPosition = center + btVector3(radius * cos(angle), yVariation, radius * sin(angle));
-                btQuaternion initialRotation(0, 0, 0, 1);
-                btTransform initialTransform(initialRotation, initialPosition);
+            btVector3 initialPosition = center + btVector3(radius * cos(angle), yVariation, radius * sin(angle));
+            btQuaternion initialRotation(0, 0, 0, 1);
+            btTransform initialTransform(initialRotation, initialPosition);
 
-                sphere.createPhysicsBody(physicsEngine, 1.f, glm::vec3(2.0f, 2.0f, 2.0f), ShapeType::Sphere, true, 0.9f);
+            sphere.createPhysicsBody(physicsEngine, 1.f, glm::vec3(2.0f, 2.0f, 2.0f), ShapeType::Sphere, true, 0.9f);
 
-                sphere.m_pPhysicsBody->setWorldTransform(initialTransform);
-                sphere.m_ModelMatrix = glm::scale(glm::mat4(1.0f), { 1.0f, 1.0f, 1.0f });
-                sphere.m_pMaterial = mydefaultTextureMaterial;
+            sphere.m_pPhysicsBody->setWorldTransform(initialTransform);
+            sphere.m_ModelMatrix = glm::scale(glm::mat4(1.0f), { 1.0f, 1.0f, 1.0f });
+            sphere.m_pMaterial = mydefaultTextureMaterial;
 
-                addMesh(sphere, device, physDevice, queueFamily, graphicsQueue);
-            }
+            addStreamedMesh(sphere, "models/sphere.obj");
         }
 
         Mesh<VertexType> square2;
         std::vector<VertexType> square2Vertices{
-        {glm::vec3{-0.5f, 0.0f, -0.5f}, glm::vec3{1.f, 0.f, 1.f}, glm::vec2{0.f, 0.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
-        {glm::vec3{0.5f, 0.0f, -0.5f}, glm::vec3{0.f, 1.f, 1.f}, glm::vec2{1.f, 0.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
-        {glm::vec3{0.5f, 0.0f,  0.5f}, glm::vec3{0.f, 0.f, 1.f}, glm::vec2{1.f, 1.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
-        {glm::vec3{-0.5f, 0.0f,  0.5f}, glm::vec3{1.f, 1.f, 0.f}, glm::vec2{0.f, 1.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
+        {glm::vec3{-0.5f, 0.0f, -0.5f}, glm::vec3{1.f, 1.f, 1.f}, glm::vec2{0.f, 0.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
+        {glm::vec3{0.5f, 0.0f, -0.5f}, glm::vec3{1.f, 1.f, 1.f}, glm::vec2{1.f, 0.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
+        {glm::vec3{0.5f, 0.0f,  0.5f}, glm::vec3{1.f, 1.f, 1.f}, glm::vec2{1.f, 1.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
+        {glm::vec3{-0.5f, 0.0f,  0.5f}, glm::vec3{1.f, 1.f, 1.f}, glm::vec2{0.f, 1.f}, glm::vec3{0.f, 1.f, 0.f}, glm::vec3{1.f, 0.f, 0.f}},
         };
 
         std::vector<uint32_t> square2Indices{
@@ -139,8 +168,8 @@ void Scene3D_PBR<VertexType>::createScene(const VkDevice& device, const VkPhysic
             0, 2, 3
         };
 
-        square2.setVertices(square2Vertices);
-        square2.setIndices(square2Indices);
+        square2.setVertices(std::move(square2Vertices));
+        square2.setIndices(std::move(square2Indices));
 
         btVector3 initialPosition(15.0f, -1.0f, 0);
         btQuaternion initialRotation(0, 0, 0, 1);
@@ -159,66 +188,55 @@ void Scene3D_PBR<VertexType>::createScene(const VkDevice& device, const VkPhysic
     // wall and ball
     {
         Mesh<VertexType> sphere;
-        std::vector<VertexType> sphereVertices;
-        std::vector<uint32_t> sphereIndices;
 
 
-        if (ObjLoader::loadObjFile("models/sphere.obj", sphereVertices, sphereIndices)) {
-            sphere.setVertices(sphereVertices);
-            sphere.setIndices(sphereIndices);
+        btVector3 initialPosition(-80.5f, 6.3f, 1);
+        btQuaternion initialRotation(0, 0, 0, 1);
+        btTransform initialTransform(initialRotation, initialPosition);
 
-            btVector3 initialPosition(-80.5f, 6.3f, 1);
-            btQuaternion initialRotation(0, 0, 0, 1);
-            btTransform initialTransform(initialRotation, initialPosition);
+        sphere.createPhysicsBody(physicsEngine, 10.f, glm::vec3(2.0f, 2.0f, 2.0f), ShapeType::Sphere, false);
 
-            sphere.createPhysicsBody(physicsEngine, 10.f, glm::vec3(2.0f, 2.0f, 2.0f), ShapeType::Sphere, false);
+        sphere.m_pPhysicsBody->setWorldTransform(initialTransform);
+        sphere.m_ModelMatrix = glm::scale(glm::mat4(1.0f), { 1.0f, 1.0f, 1.0f });
+        sphere.m_pMaterial = myDirtTextureMaterial;
 
-            sphere.m_pPhysicsBody->setWorldTransform(initialTransform);
-            sphere.m_ModelMatrix = glm::scale(glm::mat4(1.0f), { 1.0f, 1.0f, 1.0f });
-            sphere.m_pMaterial = myDirtTextureMaterial;
-
-            addMesh(sphere, device, physDevice, queueFamily, graphicsQueue);
-        }
+        addStreamedMesh(sphere, "models/sphere.obj");
 
         const int numberOfCubesPerSide = 5;
         const float cubeSize = 0.1f;
         const float spacing = 0.81f;
 
-        std::vector<VertexType> cubeVertices;
-        std::vector<uint32_t> cubeIndices;
-
-        if (ObjLoader::loadObjFile("models/square.obj", cubeVertices, cubeIndices)) {
-            for (int x = 0; x < numberOfCubesPerSide; ++x) {
-                for (int y = 0; y < numberOfCubesPerSide; ++y) {
-                    for (int z = 0; z < numberOfCubesPerSide; ++z) {
-                        Mesh<VertexType> smallCube;
-
-                        smallCube.setVertices(cubeVertices);
-                        smallCube.setIndices(cubeIndices);
+        for (int x = 0; x < numberOfCubesPerSide; ++x) {
+            for (int y = 0; y < numberOfCubesPerSide; ++y) {
+                for (int z = 0; z < numberOfCubesPerSide; ++z) {
+                    Mesh<VertexType> smallCube;
 
-                        float xOffset = x * (cubeSize + spacing);
-                        float yOffset = 4.5f + y * (cubeSize + spacing);
-                        float zOffset = -1 + z * (cubeSize + spacing);
-                        btVector3 initialPosition(xOffset, yOffset, zOffset);
-                        btQuaternion initialRotation(0, 0, 0, 1);
-                        btTransform initialTransform(initialRotation, initialPosition);
+                    float xOffset = x * (cubeSize + spacing);
+                    float yOffset = 4.5f + y * (cubeSize + spacing);
+                    float zOffset = -1 + z * (cubeSize + spacing);
+                    btVector3 initialPosition(xOffset, yOffset, zOffset);
+                    btQuaternion initialRotation(0, 0, 0, 1);
+                    btTransform initialTransform(initialRotation, initialPosition);
 
-                        smallCube.createPhysicsBody(physicsEngine, 0.7f, glm::vec3(cubeSize * 9.1f, cubeSize * 9.1f, cubeSize * 9.1f), ShapeType::Box, false);
-                        smallCube.m_pPhysicsBody->setWorldTransform(initialTransform);
+                    smallCube.createPhysicsBody(physicsEngine, 0.7f, glm::vec3(cubeSize * 9.1f, cubeSize * 9.1f, cubeSize * 9.1f), ShapeType::Box, false);
+                    smallCube.m_pPhysicsBody->setWorldTransform(initialTransform);
 
-                        smallCube.m_ModelMatrix = glm::scale(glm::mat4(1.0f), { cubeSize, cubeSize, cubeSize });
-                        smallCube.m_pMaterial = myBrickMaterial;
+                    smallCube.m_ModelMatrix = glm::scale(glm::mat4(1.0f), { cubeSize, cubeSize, cubeSize });
+                    smallCube.m_pMaterial = myBrickMaterial;
 
-                        addMesh(smallCube, device, physDevice, queueFamily, graphicsQueue);
-                    }
+                    addStreamedMesh(smallCube, "models/square.obj", cubeProcessingOptions);
                 }
             }
         }
     }
+
+    m_AssetLoader.submitBatch();
 }
 
 template <typename VertexType>
 void Scene3D_PBR<VertexType>::draw(Camera& camera, CommandBuffer& commandBuffer, GraphicsPipeline& graphicsPipeline, SwapChain& swapChain, int imageIndex, int renderMode) {
+    processLoadedAssets();
+
     UniformBufferObject3D_PBR ubo3D{};
     ubo3D.viewProjection = camera.getViewProjection(0.1f, 200.f);
     ubo3D.viewPosition = glm::vec4(camera.getOrigin(), 1.0f);
@@ -227,9 +245,20 @@ void Scene3D_PBR<VertexType>::draw(Camera& camera, CommandBuffer& commandBuffer,
     graphicsPipeline.bind(commandBuffer.getVkCommandBuffer(), swapChain, imageIndex);
     graphicsPipeline.updateUBO(imageIndex, &ubo3D, sizeof(ubo3D));
 
+    float lodPixelScale = swapChain.getSwapChainExtent().height * 0.5f / std::tan(glm::radians(camera.getFovAngle()) * 0.5f);
+    Frustum frustum = Frustum::fromViewProjection(ubo3D.viewProjection);
+
     for (auto& mesh : m_Meshes) {
+        mesh.selectLod(camera.getOrigin(), lodPixelScale);
+        mesh.cull(frustum, camera.getOrigin());
+        if (mesh.isCulled()) {
+            continue;
+        }
+
         PushConstantsPBR meshPushConstant{};
         meshPushConstant.model = mesh.m_ModelMatrix;
+        meshPushConstant.positionScale = glm::vec4(mesh.getPositionScale(), 0.0f);
+        meshPushConstant.positionBias = glm::vec4(mesh.getPositionBias(), 0.0f);
         meshPushConstant.renderMode = renderMode;
 
         graphicsPipeline.updatePushConstrant(commandBuffer.getVkCommandBuffer(), &meshPushConstant, sizeof(meshPushConstant));
@@ -305,3 +334,125 @@ void Scene3D_PBR<VertexType>::update(float deltaTime) {
         m_Meshes[2].m_ModelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(-23.5f, 0.5f, 0.0f)) * glm::rotate(glm::mat4(1.0f), m_RotationAngle, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::scale(glm::mat4(1.0f), { 1.0f, 1.0f, 1.0f });
     }
 }
+
+template <typename VertexType>
+void Scene3D_PBR<VertexType>::createPlaceholders() {
+    // Flat grey albedo, an unperturbed normal, no specular and medium gloss, in material binding order.
+    const TextureImage placeholderImages[] = {
+        TextureImage::createSolidColor(128, 128, 128),
+        TextureImage::createSolidColor(128, 128, 255, 255, TextureFormat::R8G8B8A8Unorm),
+        TextureImage::createSolidColor(0, 0, 0, 255, TextureFormat::R8G8B8A8Unorm),
+        TextureImage::createSolidColor(128, 128, 128, 255, TextureFormat::R8G8B8A8Unorm)
+    };
+    for (const TextureImage& image : placeholderImages) {
+        m_pPlaceholderTextures.push_back(std::make_shared<Texture>(m_Device, m_PhysDevice, m_CommandPool, m_GraphicsQueue, image));
+    }
+
+    // A unit cube stands in for meshes that are still loading.
+    const glm::vec3 faceNormals[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    const glm::vec2 faceCorners[] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+    std::vector<VertexType> vertices;
+    std::vector<uint32_t> indices;
+    for (const glm::vec3& normal : faceNormals) {
+        glm::vec3 tangent = std::abs(normal.y) > 0.5f ? glm::vec3{ 1, 0, 0 } : glm::cross(glm::vec3{ 0, 1, 0 }, normal);
+        glm::vec3 bitangent = glm::cross(normal, tangent);
+
+        uint32_t firstVertex = static_cast<uint32_t>(vertices.size());
+        for (const glm::vec2& corner : faceCorners) {
+            glm::vec3 position = normal * 0.5f + tangent * (corner.x - 0.5f) + bitangent * (corner.y - 0.5f);
+            vertices.push_back({ position, glm::vec3{ 1.f }, corner, normal, tangent });
+        }
+        indices.insert(indices.end(), { firstVertex, firstVertex + 1, firstVertex + 2, firstVertex, firstVertex + 2, firstVertex + 3 });
+    }
+
+    m_pPlaceholderMesh = std::make_shared<MeshAsset<VertexType>>(m_Device, m_PhysDevice, m_QueueFamily, m_GraphicsQueue, vertices, indices);
+}
+
+template <typename VertexType>
+std::shared_ptr<Material> Scene3D_PBR<VertexType>::createStreamedMaterial(MaterialManager& materialManager, const std::vector<std::string>& texturePaths) {
+    PendingMaterial pending{};
+    pending.material = materialManager.createMaterial(m_Device, m_pPlaceholderTextures);
+    pending.texturePaths = texturePaths;
+    for (size_t slot = 0; slot < texturePaths.size(); ++slot) {
+        pending.images.push_back(m_AssetLoader.loadImage(texturePaths[slot], getTextureRole(slot)));
+    }
+
+    m_PendingMaterials.push_back(std::move(pending));
+    return m_PendingMaterials.back().material;
+}
+
+template <typename VertexType>
+void Scene3D_PBR<VertexType>::addStreamedMesh(Mesh<VertexType>& mesh, const std::string& objPath, const MeshProcessingOptions& options) {
+    m_PendingMeshes.push_back({ m_Meshes.size(), objPath, options, m_AssetLoader.loadObj(objPath, options) });
+
+    mesh.setAsset(m_pPlaceholderMesh);
+    addMesh(mesh, m_Device, m_PhysDevice, m_QueueFamily, m_GraphicsQueue);
+}
+
+template <typename VertexType>
+void Scene3D_PBR<VertexType>::processLoadedAssets() {
+    if (m_PendingMaterials.empty() && m_PendingMeshes.empty()) {
+        return;
+    }
+
+    for (auto it = m_PendingMaterials.begin(); it != m_PendingMaterials.end();) {
+        bool ready = std::all_of(it->images.begin(), it->images.end(), [](const auto& image) { return AssetLoader::isReady(image); });
+        if (!ready) {
+            ++it;
+            continue;
+        }
+
+        // Textures that failed to load keep their placeholder.
+        auto uploadStartTime = std::chrono::high_resolution_clock::now();
+        std::vector<std::shared_ptr<Texture>> textures = m_pPlaceholderTextures;
+        for (size_t i = 0; i < it->images.size() && i < textures.size(); ++i) {
+            if (auto image = it->images[i].get()) {
+                textures[i] = m_TextureCache.add(it->texturePaths[i], getTextureRole(i), m_AssetLoader.getBlockCompression(), *image);
+                ++m_MaterialTextureCount;
+            }
+        }
+        m_TextureUploadMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - uploadStartTime).count();
+        it->material->setTextures(m_Device, textures);
+        it = m_PendingMaterials.erase(it);
+    }
+
+    for (auto it = m_PendingMeshes.begin(); it != m_PendingMeshes.end();) {
+        if (!AssetLoader::isReady(it->meshData)) {
+            ++it;
+            continue;
+        }
+
+        if (auto meshData = it->meshData.get()) {
+            m_Meshes[it->meshIndex].setAsset(m_MeshAssets.addObj(it->objPath, it->options, *meshData));
+        }
+        it = m_PendingMeshes.erase(it);
+    }
+
+    if (m_PendingMaterials.empty() && m_PendingMeshes.empty()) {
+        std::cout << "Scene3D_PBR assets streamed in " << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_LoadStartTime).count()
+            << " ms on " << ThreadPool::getShared().getThreadCount() << " worker threads, " << m_MaterialTextureCount << " material textures set up in "
+            << m_TextureUploadMilliseconds << " ms on the render thread" << std::endl;
+        m_AssetLoader.printImageStatistics();
+        m_TextureCache.printStatistics();
+        SamplerCache::getShared().printStatistics();
+        m_MeshAssets.printStatistics();
+        m_AssetLoader.clear();
+    }
+}
+
+template <typename VertexType>
+void Scene3D_PBR<VertexType>::cleanUp(const VkDevice& device) {
+    m_PendingMaterials.clear();
+    m_PendingMeshes.clear();
+    m_AssetLoader.clear();
+
+    SceneBase<VertexType>::cleanUp(device);
+    m_MeshAssets.cleanup();
+
+    for (const auto& texture : m_pPlaceholderTextures) {
+        texture->cleanup();
+    }
+    m_pPlaceholderTextures.clear();
+    m_pPlaceholderMesh.reset();
+}
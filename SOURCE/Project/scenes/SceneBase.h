@@ -31,7 +31,9 @@ protected:
 
 template <typename VertexType>
 void SceneBase<VertexType>::addMesh(Mesh<VertexType>& mesh, const VkDevice& device, const VkPhysicalDevice& physDevice, QueueFamilyIndices queueFamily, VkQueue graphicsQueue) {
-    mesh.initialize(device, physDevice, queueFamily, graphicsQueue, mesh.getVertices(), mesh.getIndices());
+    if (!mesh.getAsset()) {
+        mesh.initialize(device, physDevice, queueFamily, graphicsQueue, mesh.getVertices(), mesh.getIndices());
+    }
     m_Meshes.push_back(std::move(mesh));
 }
 
@@ -10,6 +10,8 @@ layout(set = 0, binding = 0) uniform UniformBufferObject {
 
 layout(push_constant) uniform PushConstants {
     mat4 model;
+    vec4 positionScale;
+    vec4 positionBias;
     int renderMode;
 } push;
 
@@ -18,11 +20,12 @@ layout(set = 1, binding = 1) uniform sampler2D normalSample;
 layout(set = 1, binding = 2) uniform sampler2D specularSample;
 layout(set = 1, binding = 3) uniform sampler2D roughnessSample;
 
-layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 inWorldPosition;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec3 inTangent;
 layout(location = 4) in vec2 inUV;
+// Ambient occlusion baked per vertex when the mesh was processed.
+layout(location = 5) in float inOcclusion;
 
 layout(location = 0) out vec4 outColor;
 
@@ -67,11 +70,12 @@ vec3 cookTorranceBRDF(vec3 N, vec3 V, vec3 L, vec3 F0, float roughness) {
 
 void main() {
     vec3 diffuse = texture(diffuseSample, inUV).rgb;
-    vec3 normalMap = texture(normalSample, inUV).rgb;
+    vec2 normalMap = texture(normalSample, inUV).rg * 2.0 - 1.0;
     vec3 specularColor = texture(specularSample, inUV).rgb;
     float roughness = texture(roughnessSample, inUV).r;
 
-    vec3 normal = normalize(normalMap * 2.0 - 1.0);
+    // Normal maps may be BC5, which keeps only X and Y; Z is rebuilt from the unit length.
+    vec3 normal = normalize(vec3(normalMap, sqrt(max(1.0 - dot(normalMap, normalMap), 0.0))));
     vec3 T = normalize(inTangent - inNormal * dot(inNormal, inTangent));
     vec3 B = normalize(cross(inNormal, T));
     mat3 TBN = mat3(T, B, inNormal);
@@ -87,7 +91,7 @@ void main() {
     float NdotL = max(dot(normal, lightDir), 0.0);
     vec3 diffuseLighting = diffuse * lightColor * NdotL;
 
-    vec3 ambient = ambientLight * diffuse;
+    vec3 ambient = ambientLight * diffuse * inOcclusion;
 
     vec3 finalColor;
     switch (push.renderMode) {
@@ -10,31 +10,39 @@ layout(set = 0, binding = 0) uniform UniformBufferObject
 layout(push_constant) uniform PushConstants
 {
     mat4 model;
+    vec4 positionScale;
+    vec4 positionBias;
     int renderMode;
 } push;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;   
+layout(location = 0) in vec4 inPosition;
 layout(location = 2) in vec2 inUV;
-layout(location = 3) in vec3 inNormal;
-layout(location = 4) in vec3 inTangent;
+layout(location = 3) in vec2 inNormal;
+layout(location = 4) in vec2 inTangent;
 
-layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 outWorldPosition;
 layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec3 outTangent;
 layout(location = 4) out vec2 outUV;
+layout(location = 5) out float outOcclusion;
 
-void main() {
-    fragColor = inColor;
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
 
-    outWorldPosition = vec3(push.model * vec4(inPosition, 1.0));
+void main() {
+    vec3 position = inPosition.xyz * push.positionScale.xyz + push.positionBias.xyz;
+    outWorldPosition = vec3(push.model * vec4(position, 1.0));
     
     mat3 normalMatrix = transpose(inverse(mat3(push.model)));
-    outNormal = normalize(normalMatrix * inNormal);
-    outTangent = normalize(normalMatrix * inTangent);
+    outNormal = normalize(normalMatrix * decodeOctahedral(inNormal));
+    outTangent = normalize(normalMatrix * decodeOctahedral(inTangent));
 
     outUV = inUV;
+    outOcclusion = inPosition.w;
 
     gl_Position = ubo.viewProjection * vec4(outWorldPosition, 1.0);
 }
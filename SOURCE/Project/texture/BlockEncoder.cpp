@@ -0,0 +1,426 @@
+#include "BlockEncoder.h"
+#include <threading/ThreadPool.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr size_t minBlockRowsPerRange = 8;
+
+    // BC7 interpolation weights for 4-bit indices, out of 64.
+    constexpr int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    // Share of color1 in each of the four BC1 colors.
+    constexpr float bc1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+    struct Block {
+        float texels[16][4];
+    };
+
+    // Edge blocks repeat the last row and column, which keeps them out of the endpoint fit.
+    void loadBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block& block) {
+        for (uint32_t y = 0; y < 4; ++y) {
+            uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; ++x) {
+                uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                const uint8_t* texel = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+                for (int channel = 0; channel < 4; ++channel) {
+                    block.texels[y * 4 + x][channel] = texel[channel];
+                }
+            }
+        }
+    }
+
+    // Endpoints at the extremes of the texels' projection onto their principal axis, found by
+    // power iteration on the covariance of the first channelCount channels.
+    void fitEndpoints(const Block& block, int channelCount, float endpoint0[4], float endpoint1[4]) {
+        float mean[4]{};
+        for (const float* texel : block.texels) {
+            for (int channel = 0; channel < channelCount; ++channel) {
+                mean[channel] += texel[channel] / 16.0f;
+            }
+        }
+
+        float covariance[4][4]{};
+        for (const float* texel : block.texels) {
+            for (int i = 0; i < channelCount; ++i) {
+                for (int j = 0; j < channelCount; ++j) {
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+                }
+            }
+        }
+
+        int largest = 0;
+        for (int channel = 1; channel < channelCount; ++channel) {
+            largest = covariance[channel][channel] > covariance[largest][largest] ? channel : largest;
+        }
+        float axis[4]{};
+        for (int channel = 0; channel < channelCount; ++channel) {
+            axis[channel] = covariance[largest][channel];
+        }
+
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            float next[4]{};
+            float scale = 0.0f;
+            for (int i = 0; i < channelCount; ++i) {
+                for (int j = 0; j < channelCount; ++j) {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+                scale = std::max(scale, std::abs(next[i]));
+            }
+            if (!(scale > 0.0f)) {
+                break;
+            }
+            for (int channel = 0; channel < channelCount; ++channel) {
+                axis[channel] = next[channel] / scale;
+            }
+        }
+
+        float length = 0.0f;
+        for (int channel = 0; channel < channelCount; ++channel) {
+            length += axis[channel] * axis[channel];
+        }
+        length = std::sqrt(length);
+        for (int channel = 0; channel < channelCount; ++channel) {
+            axis[channel] = length > 0.0f ? axis[channel] / length : 0.0f;
+        }
+
+        float minProjection = std::numeric_limits<float>::max();
+        float maxProjection = -std::numeric_limits<float>::max();
+        for (const float* texel : block.texels) {
+            float projection = 0.0f;
+            for (int channel = 0; channel < channelCount; ++channel) {
+                projection += (texel[channel] - mean[channel]) * axis[channel];
+            }
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        for (int channel = 0; channel < channelCount; ++channel) {
+            endpoint0[channel] = std::clamp(mean[channel] + axis[channel] * minProjection, 0.0f, 255.0f);
+            endpoint1[channel] = std::clamp(mean[channel] + axis[channel] * maxProjection, 0.0f, 255.0f);
+        }
+    }
+
+    // Least-squares endpoints for fixed indices; weights[i] is texel i's share of endpoint1.
+    bool solveEndpoints(const Block& block, int channelCount, const float weights[16], float endpoint0[4], float endpoint1[4]) {
+        float aa = 0.0f;
+        float ab = 0.0f;
+        float bb = 0.0f;
+        float ax[4]{};
+        float bx[4]{};
+        for (int i = 0; i < 16; ++i) {
+            float b = weights[i];
+            float a = 1.0f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (int channel = 0; channel < channelCount; ++channel) {
+                ax[channel] += a * block.texels[i][channel];
+                bx[channel] += b * block.texels[i][channel];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (!(std::abs(determinant) > 1e-6f)) {
+            return false;
+        }
+        for (int channel = 0; channel < channelCount; ++channel) {
+            endpoint0[channel] = std::clamp((bb * ax[channel] - ab * bx[channel]) / determinant, 0.0f, 255.0f);
+            endpoint1[channel] = std::clamp((aa * bx[channel] - ab * ax[channel]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    uint16_t packRgb565(const float color[4]) {
+        int r = std::clamp(static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+        int g = std::clamp(static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+        int b = std::clamp(static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void unpackRgb565(uint16_t packed, int color[3]) {
+        int r = packed >> 11;
+        int g = (packed >> 5) & 63;
+        int b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // Picks the nearest of the four colors for each texel and returns the squared error.
+    float findBc1Indices(const Block& block, uint16_t color0, uint16_t color1, uint32_t& indices) {
+        int palette[4][3];
+        unpackRgb565(color0, palette[0]);
+        unpackRgb565(color1, palette[1]);
+        for (int channel = 0; channel < 3; ++channel) {
+            palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+            palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+        }
+
+        indices = 0;
+        float error = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            float bestError = std::numeric_limits<float>::max();
+            uint32_t bestIndex = 0;
+            for (uint32_t index = 0; index < 4; ++index) {
+                float texelError = 0.0f;
+                for (int channel = 0; channel < 3; ++channel) {
+                    float difference = block.texels[i][channel] - palette[index][channel];
+                    texelError += difference * difference;
+                }
+                if (texelError < bestError) {
+                    bestError = texelError;
+                    bestIndex = index;
+                }
+            }
+            indices |= bestIndex << (2 * i);
+            error += bestError;
+        }
+        return error;
+    }
+
+    void encodeBc1(const Block& block, uint8_t* destination) {
+        float endpoint0[4];
+        float endpoint1[4];
+        fitEndpoints(block, 3, endpoint0, endpoint1);
+
+        uint16_t color0 = packRgb565(endpoint1);
+        uint16_t color1 = packRgb565(endpoint0);
+        uint32_t indices;
+        float error = findBc1Indices(block, color0, color1, indices);
+
+        float weights[16];
+        for (int i = 0; i < 16; ++i) {
+            weights[i] = bc1Weights[(indices >> (2 * i)) & 3];
+        }
+        if (solveEndpoints(block, 3, weights, endpoint0, endpoint1)) {
+            uint16_t refined0 = packRgb565(endpoint0);
+            uint16_t refined1 = packRgb565(endpoint1);
+            uint32_t refinedIndices;
+            if (findBc1Indices(block, refined0, refined1, refinedIndices) < error) {
+                color0 = refined0;
+                color1 = refined1;
+                indices = refinedIndices;
+            }
+        }
+
+        // color0 > color1 selects the four-color mode; swapping the colors swaps indices 0 and 1
+        // and 2 and 3. Equal colors decode in the three-color mode, where only index 0 is safe.
+        if (color0 < color1) {
+            std::swap(color0, color1);
+            indices ^= 0x55555555u;
+        }
+        if (color0 == color1) {
+            indices = 0;
+        }
+
+        std::memcpy(destination, &color0, sizeof(color0));
+        std::memcpy(destination + 2, &color1, sizeof(color1));
+        std::memcpy(destination + 4, &indices, sizeof(indices));
+    }
+
+    // Uses the eight-value mode between the channel's extremes.
+    void encodeBc4(const Block& block, int channel, uint8_t* destination) {
+        float minValue = 255.0f;
+        float maxValue = 0.0f;
+        for (const float* texel : block.texels) {
+            minValue = std::min(minValue, texel[channel]);
+            maxValue = std::max(maxValue, texel[channel]);
+        }
+
+        int value0 = static_cast<int>(maxValue + 0.5f);
+        int value1 = static_cast<int>(minValue + 0.5f);
+        uint64_t bits = static_cast<uint64_t>(value0) | (static_cast<uint64_t>(value1) << 8);
+
+        if (value0 > value1) {
+            float palette[8] = { static_cast<float>(value0), static_cast<float>(value1) };
+            for (int index = 2; index < 8; ++index) {
+                palette[index] = ((8 - index) * value0 + (index - 1) * value1) / 7.0f;
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                uint64_t bestIndex = 0;
+                float bestError = std::numeric_limits<float>::max();
+                for (int index = 0; index < 8; ++index) {
+                    float error = std::abs(block.texels[i][channel] - palette[index]);
+                    if (error < bestError) {
+                        bestError = error;
+                        bestIndex = index;
+                    }
+                }
+                bits |= bestIndex << (16 + 3 * i);
+            }
+        }
+
+        std::memcpy(destination, &bits, sizeof(bits));
+    }
+
+    // A BC7 endpoint is seven bits per channel plus a p-bit shared by its channels.
+    struct Bc7Endpoint {
+        int values[4];
+        int pBit;
+
+        int get(int channel) const { return (values[channel] << 1) | pBit; }
+    };
+
+    Bc7Endpoint quantizeBc7Endpoint(const float endpoint[4]) {
+        Bc7Endpoint best{};
+        float bestError = std::numeric_limits<float>::max();
+        for (int pBit = 0; pBit < 2; ++pBit) {
+            Bc7Endpoint candidate{};
+            candidate.pBit = pBit;
+            float error = 0.0f;
+            for (int channel = 0; channel < 4; ++channel) {
+                candidate.values[channel] = std::clamp(static_cast<int>((endpoint[channel] - pBit) * 0.5f + 0.5f), 0, 127);
+                float difference = endpoint[channel] - candidate.get(channel);
+                error += difference * difference;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    float findBc7Indices(const Block& block, const Bc7Endpoint& endpoint0, const Bc7Endpoint& endpoint1, uint8_t indices[16]) {
+        int palette[16][4];
+        for (int index = 0; index < 16; ++index) {
+            for (int channel = 0; channel < 4; ++channel) {
+                palette[index][channel] = ((64 - bc7Weights[index]) * endpoint0.get(channel) + bc7Weights[index] * endpoint1.get(channel) + 32) >> 6;
+            }
+        }
+
+        float error = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            float bestError = std::numeric_limits<float>::max();
+            for (uint8_t index = 0; index < 16; ++index) {
+                float texelError = 0.0f;
+                for (int channel = 0; channel < 4; ++channel) {
+                    float difference = block.texels[i][channel] - palette[index][channel];
+                    texelError += difference * difference;
+                }
+                if (texelError < bestError) {
+                    bestError = texelError;
+                    indices[i] = index;
+                }
+            }
+            error += bestError;
+        }
+        return error;
+    }
+
+    struct BitWriter {
+        uint8_t* destination;
+        uint32_t position = 0;
+
+        void write(uint32_t value, uint32_t bitCount) {
+            for (uint32_t bit = 0; bit < bitCount; ++bit, ++position) {
+                destination[position / 8] |= static_cast<uint8_t>(((value >> bit) & 1) << (position % 8));
+            }
+        }
+    };
+
+    // Mode 6: one subset, RGBA endpoints and 4-bit indices. destination has to be zeroed.
+    void encodeBc7(const Block& block, uint8_t* destination) {
+        float endpoint0[4];
+        float endpoint1[4];
+        fitEndpoints(block, 4, endpoint0, endpoint1);
+
+        Bc7Endpoint endpoints[2] = { quantizeBc7Endpoint(endpoint0), quantizeBc7Endpoint(endpoint1) };
+        uint8_t indices[16];
+        float error = findBc7Indices(block, endpoints[0], endpoints[1], indices);
+
+        float weights[16];
+        for (int i = 0; i < 16; ++i) {
+            weights[i] = bc7Weights[indices[i]] / 64.0f;
+        }
+        if (solveEndpoints(block, 4, weights, endpoint0, endpoint1)) {
+            Bc7Endpoint refined[2] = { quantizeBc7Endpoint(endpoint0), quantizeBc7Endpoint(endpoint1) };
+            uint8_t refinedIndices[16];
+            if (findBc7Indices(block, refined[0], refined[1], refinedIndices) < error) {
+                std::copy(refined, refined + 2, endpoints);
+                std::copy(refinedIndices, refinedIndices + 16, indices);
+            }
+        }
+
+        // The first index is stored without its top bit, so it has to be below 8.
+        if (indices[0] >= 8) {
+            std::swap(endpoints[0], endpoints[1]);
+            for (uint8_t& index : indices) {
+                index = static_cast<uint8_t>(15 - index);
+            }
+        }
+
+        BitWriter writer{ destination };
+        writer.write(1u << 6, 7);
+        for (int channel = 0; channel < 4; ++channel) {
+            writer.write(endpoints[0].values[channel], 7);
+            writer.write(endpoints[1].values[channel], 7);
+        }
+        writer.write(endpoints[0].pBit, 1);
+        writer.write(endpoints[1].pBit, 1);
+        writer.write(indices[0], 3);
+        for (int i = 1; i < 16; ++i) {
+            writer.write(indices[i], 4);
+        }
+    }
+}
+
+void BlockEncoder::encode(const TextureImage& source, TextureFormat format, TextureImage& destination) {
+    if (!TextureFormats::isBlockCompressed(format)) {
+        destination = source;
+        destination.format = format;
+        return;
+    }
+
+    destination.width = source.width;
+    destination.height = source.height;
+    destination.format = format;
+    destination.mipLevels.clear();
+
+    size_t totalSize = 0;
+    for (const TextureMipLevel& level : source.mipLevels) {
+        totalSize += TextureFormats::getLevelSize(format, level.width, level.height);
+    }
+    destination.pixels.assign(totalSize, 0);
+
+    size_t blockSize = TextureFormats::getBlockSize(format);
+    size_t offset = 0;
+    for (const TextureMipLevel& level : source.mipLevels) {
+        size_t size = TextureFormats::getLevelSize(format, level.width, level.height);
+        destination.mipLevels.push_back({ level.width, level.height, offset, size });
+
+        const uint8_t* pixels = source.pixels.data() + level.offset;
+        uint8_t* blocks = destination.pixels.data() + offset;
+        uint32_t blocksX = (level.width + 3) / 4;
+        uint32_t blocksY = (level.height + 3) / 4;
+
+        ThreadPool::getShared().parallelFor(blocksY, minBlockRowsPerRange, [&](size_t begin, size_t end) {
+            Block block;
+            for (size_t blockY = begin; blockY < end; ++blockY) {
+                for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+                    loadBlock(pixels, level.width, level.height, blockX, static_cast<uint32_t>(blockY), block);
+                    uint8_t* destinationBlock = blocks + (blockY * blocksX + blockX) * blockSize;
+                    switch (format) {
+                    case TextureFormat::Bc1RgbSrgb:
+                        encodeBc1(block, destinationBlock);
+                        break;
+                    case TextureFormat::Bc4Unorm:
+                        encodeBc4(block, 0, destinationBlock);
+                        break;
+                    case TextureFormat::Bc5Unorm:
+                        encodeBc4(block, 0, destinationBlock);
+                        encodeBc4(block, 1, destinationBlock + 8);
+                        break;
+                    default:
+                        encodeBc7(block, destinationBlock);
+                        break;
+                    }
+                }
+            }
+        });
+        offset += size;
+    }
+}
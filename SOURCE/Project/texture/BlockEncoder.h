@@ -0,0 +1,12 @@
+#pragma once
+#include "TextureImage.h"
+
+namespace BlockEncoder {
+    // Compresses every mip level of an uncompressed RGBA8 image into format, block rows spread over
+    // the shared thread pool. BC1 and BC7 fit endpoints along the principal axis of each block's
+    // colors and refine them once by least squares; BC7 uses mode 6 only, a single subset with
+    // 4-bit indices and alpha. BC4 keeps the red channel and BC5 red and green. sRGB formats are
+    // encoded on the stored values, as GPUs decode the endpoints before converting to linear.
+    // An uncompressed format just copies the image.
+    void encode(const TextureImage& source, TextureFormat format, TextureImage& destination);
+}
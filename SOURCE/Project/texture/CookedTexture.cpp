@@ -0,0 +1,322 @@
+#include "CookedTexture.h"
+#include <io/AssetPack.h>
+#include <io/SourceStamp.h>
+#include <io/TemporaryFile.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace {
+    constexpr uint8_t ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    constexpr char sourceStampKey[] = "VulkanLab.source";
+    constexpr char writerKey[] = "KTXwriter";
+    constexpr char writerValue[] = "AssetCooker";
+
+    struct Ktx2Header {
+        uint8_t identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct Ktx2LevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    struct CookedSourceInfo {
+        uint64_t modifiedTime;
+        uint64_t size;
+        uint64_t contentHash;
+        uint32_t version;
+        uint32_t padding;
+    };
+
+    uint64_t alignOffset(uint64_t offset, uint64_t alignment) {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Basic data format descriptor: four 8-bit channels for the uncompressed formats, one sample per
+    // 64-bit block channel for the block-compressed ones.
+    std::vector<uint32_t> createDataFormatDescriptor(TextureFormat format) {
+        constexpr uint32_t modelRgbsda = 1;
+        constexpr uint32_t modelBc1a = 128;
+        constexpr uint32_t modelBc4 = 131;
+        constexpr uint32_t modelBc5 = 132;
+        constexpr uint32_t modelBc7 = 134;
+        constexpr uint32_t channelLinear = 0x10;
+
+        struct Sample {
+            uint32_t channelType;
+            uint32_t bitOffset;
+            uint32_t bitLength;
+            uint32_t upper;
+        };
+        Sample samples[4]{};
+        size_t sampleCount = 1;
+        uint32_t colorModel = modelRgbsda;
+        uint32_t blockDimensions = 0;
+        bool srgb = TextureFormats::isSrgb(format);
+
+        switch (format) {
+        case TextureFormat::Bc1RgbSrgb:
+            colorModel = modelBc1a;
+            samples[0] = { 0, 0, 64, 0xFFFFFFFFu };
+            break;
+        case TextureFormat::Bc4Unorm:
+            colorModel = modelBc4;
+            samples[0] = { 0, 0, 64, 0xFFFFFFFFu };
+            break;
+        case TextureFormat::Bc5Unorm:
+            colorModel = modelBc5;
+            samples[0] = { 0, 0, 64, 0xFFFFFFFFu };
+            samples[1] = { 1, 64, 64, 0xFFFFFFFFu };
+            sampleCount = 2;
+            break;
+        case TextureFormat::Bc7Unorm:
+        case TextureFormat::Bc7Srgb:
+            colorModel = modelBc7;
+            samples[0] = { 0, 0, 128, 0xFFFFFFFFu };
+            break;
+        default:
+            // Alpha stays linear in sRGB images.
+            for (uint32_t channel = 0; channel < 3; ++channel) {
+                samples[channel] = { channel, channel * 8, 8, 255 };
+            }
+            samples[3] = { 15 | (srgb ? channelLinear : 0), 24, 8, 255 };
+            sampleCount = 4;
+            break;
+        }
+        if (TextureFormats::isBlockCompressed(format)) {
+            blockDimensions = 3 | (3 << 8);
+        }
+
+        uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(sampleCount);
+        std::vector<uint32_t> words = {
+            4 + blockSize,
+            0,
+            2 | (blockSize << 16),
+            colorModel | (1 << 8) | ((srgb ? 2u : 1u) << 16),
+            blockDimensions,
+            static_cast<uint32_t>(TextureFormats::getBlockSize(format)),
+            0,
+        };
+        for (size_t i = 0; i < sampleCount; ++i) {
+            const Sample& sample = samples[i];
+            words.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (sample.channelType << 24));
+            words.push_back(0);
+            words.push_back(0);
+            words.push_back(sample.upper);
+        }
+        return words;
+    }
+
+    void appendKeyValue(std::vector<char>& data, const char* key, const void* value, uint32_t valueSize) {
+        uint32_t length = static_cast<uint32_t>(std::strlen(key) + 1 + valueSize);
+        size_t offset = data.size();
+        data.resize(alignOffset(offset + sizeof(length) + length, 4));
+        std::memcpy(data.data() + offset, &length, sizeof(length));
+        std::memcpy(data.data() + offset + sizeof(length), key, std::strlen(key) + 1);
+        std::memcpy(data.data() + offset + sizeof(length) + std::strlen(key) + 1, value, valueSize);
+    }
+
+    // infoOffset receives the position of info relative to data.
+    bool findSourceInfo(const char* data, uint32_t size, CookedSourceInfo& info, uint32_t& infoOffset) {
+        uint32_t offset = 0;
+        while (offset + sizeof(uint32_t) <= size) {
+            uint32_t length;
+            std::memcpy(&length, data + offset, sizeof(length));
+            const char* entry = data + offset + sizeof(length);
+            if (length > size - offset - sizeof(length)) {
+                return false;
+            }
+            if (length == sizeof(sourceStampKey) + sizeof(info) && std::memcmp(entry, sourceStampKey, sizeof(sourceStampKey)) == 0) {
+                std::memcpy(&info, entry + sizeof(sourceStampKey), sizeof(info));
+                infoOffset = offset + sizeof(length) + sizeof(sourceStampKey);
+                return true;
+            }
+            offset = static_cast<uint32_t>(alignOffset(offset + sizeof(length) + length, 4));
+        }
+        return false;
+    }
+
+    // Validates the file and returns its header and level index, or false if it is not a cooked
+    // texture for the current source in a format usable for role.
+    bool readIndex(const std::string& sourcePath, TextureRole role, const AssetFile& file, Ktx2Header& header, std::vector<Ktx2LevelIndex>& levels) {
+        if (file.getSize() < sizeof(Ktx2Header)) {
+            return false;
+        }
+        std::memcpy(&header, file.getData(), sizeof(header));
+
+        if (std::memcmp(header.identifier, ktx2Identifier, sizeof(ktx2Identifier)) != 0 || !TextureFormats::isUsableAs(static_cast<TextureFormat>(header.vkFormat), role) ||
+            header.supercompressionScheme != 0 || header.levelCount == 0 || header.pixelWidth == 0 || header.pixelHeight == 0 ||
+            header.levelCount > (file.getSize() - sizeof(Ktx2Header)) / sizeof(Ktx2LevelIndex) ||
+            header.kvdByteOffset > file.getSize() || header.kvdByteLength > file.getSize() - header.kvdByteOffset) {
+            return false;
+        }
+
+        CookedSourceInfo info{};
+        uint32_t infoOffset = 0;
+        if (!findSourceInfo(file.getData() + header.kvdByteOffset, header.kvdByteLength, info, infoOffset) || info.version != CookedTexture::version) {
+            return false;
+        }
+        SourceStamp sourceStamp{ info.modifiedTime, info.size, info.contentHash };
+        uint64_t touchedTime = 0;
+        if (!sourceStamp.matches(sourcePath, &touchedTime)) {
+            return false;
+        }
+        if (touchedTime != 0 && !file.isPacked()) {
+            SourceStamp::writeModifiedTime(CookedTexture::getCookedPath(sourcePath, role), header.kvdByteOffset + infoOffset + offsetof(CookedSourceInfo, modifiedTime), touchedTime);
+        }
+
+        levels.resize(header.levelCount);
+        std::memcpy(levels.data(), file.getData() + sizeof(Ktx2Header), levels.size() * sizeof(Ktx2LevelIndex));
+
+        uint32_t width = header.pixelWidth;
+        uint32_t height = header.pixelHeight;
+        for (const Ktx2LevelIndex& level : levels) {
+            if (level.byteLength != TextureFormats::getLevelSize(static_cast<TextureFormat>(header.vkFormat), width, height) ||
+                level.byteOffset > file.getSize() || level.byteLength > file.getSize() - level.byteOffset) {
+                return false;
+            }
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        return true;
+    }
+}
+
+std::string CookedTexture::getCookedPath(const std::string& sourcePath, TextureRole role) {
+    if (role == TextureRole::Color) {
+        return sourcePath + ".ktx2";
+    }
+    return sourcePath + "." + TextureFormats::getRoleName(role) + ".ktx2";
+}
+
+bool CookedTexture::open(const std::string& sourcePath, TextureRole role, bool blockCompression, TextureImage& image) {
+    AssetFile file;
+    if (!file.open(getCookedPath(sourcePath, role))) {
+        return false;
+    }
+
+    Ktx2Header header{};
+    std::vector<Ktx2LevelIndex> levels;
+    if (!readIndex(sourcePath, role, file, header, levels) || (!blockCompression && TextureFormats::isBlockCompressed(static_cast<TextureFormat>(header.vkFormat)))) {
+        return false;
+    }
+
+    size_t totalSize = 0;
+    for (const Ktx2LevelIndex& level : levels) {
+        totalSize += static_cast<size_t>(level.byteLength);
+    }
+
+    image.width = header.pixelWidth;
+    image.height = header.pixelHeight;
+    image.format = static_cast<TextureFormat>(header.vkFormat);
+    image.pixels.resize(totalSize);
+    image.mipLevels.clear();
+
+    size_t offset = 0;
+    uint32_t width = header.pixelWidth;
+    uint32_t height = header.pixelHeight;
+    for (const Ktx2LevelIndex& level : levels) {
+        std::memcpy(image.pixels.data() + offset, file.getData() + level.byteOffset, static_cast<size_t>(level.byteLength));
+        image.mipLevels.push_back({ width, height, offset, static_cast<size_t>(level.byteLength) });
+        offset += static_cast<size_t>(level.byteLength);
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    return true;
+}
+
+bool CookedTexture::isUpToDate(const std::string& sourcePath, TextureRole role, TextureFormat format) {
+    AssetFile file;
+    if (!file.open(getCookedPath(sourcePath, role), false)) {
+        return false;
+    }
+
+    Ktx2Header header{};
+    std::vector<Ktx2LevelIndex> levels;
+    return readIndex(sourcePath, role, file, header, levels) && header.vkFormat == static_cast<uint32_t>(format);
+}
+
+bool CookedTexture::write(const std::string& sourcePath, TextureRole role, const TextureImage& image) {
+    SourceStamp sourceStamp{};
+    if (!SourceStamp::read(sourcePath, sourceStamp) || image.mipLevels.empty()) {
+        return false;
+    }
+
+    CookedSourceInfo info{ sourceStamp.modifiedTime, sourceStamp.size, sourceStamp.contentHash, version, 0 };
+    std::vector<uint32_t> dataFormatDescriptor = createDataFormatDescriptor(image.format);
+    std::vector<char> keyValueData;
+    appendKeyValue(keyValueData, writerKey, writerValue, sizeof(writerValue));
+    appendKeyValue(keyValueData, sourceStampKey, &info, sizeof(info));
+
+    Ktx2Header header{};
+    std::memcpy(header.identifier, ktx2Identifier, sizeof(ktx2Identifier));
+    header.vkFormat = static_cast<uint32_t>(image.format);
+    header.typeSize = 1;
+    header.pixelWidth = image.width;
+    header.pixelHeight = image.height;
+    header.faceCount = 1;
+    header.levelCount = image.getMipLevelCount();
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + header.levelCount * sizeof(Ktx2LevelIndex));
+    header.dfdByteLength = static_cast<uint32_t>(dataFormatDescriptor.size() * sizeof(uint32_t));
+    header.kvdByteOffset = header.dfdByteOffset + header.dfdByteLength;
+    header.kvdByteLength = static_cast<uint32_t>(keyValueData.size());
+
+    // KTX2 stores the smallest level first; level data is aligned to the texel or block size,
+    // which is a multiple of 4 for every format used here.
+    uint64_t levelAlignment = TextureFormats::getBlockSize(image.format);
+    std::vector<Ktx2LevelIndex> levels(header.levelCount);
+    uint64_t offset = alignOffset(header.kvdByteOffset + header.kvdByteLength, 16);
+    for (size_t level = levels.size(); level-- > 0;) {
+        levels[level].byteOffset = offset;
+        levels[level].byteLength = image.mipLevels[level].size;
+        levels[level].uncompressedByteLength = image.mipLevels[level].size;
+        offset = alignOffset(offset + levels[level].byteLength, levelAlignment);
+    }
+
+    std::string cookedPath = getCookedPath(sourcePath, role);
+    std::string temporaryPath = TemporaryFile::getPath(cookedPath);
+    bool written = false;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        const char padding[16]{};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(Ktx2LevelIndex));
+        file.write(reinterpret_cast<const char*>(dataFormatDescriptor.data()), header.dfdByteLength);
+        file.write(keyValueData.data(), keyValueData.size());
+
+        uint64_t position = header.kvdByteOffset + header.kvdByteLength;
+        for (size_t level = levels.size(); level-- > 0;) {
+            file.write(padding, levels[level].byteOffset - position);
+            file.write(reinterpret_cast<const char*>(image.pixels.data() + image.mipLevels[level].offset), image.mipLevels[level].size);
+            position = levels[level].byteOffset + levels[level].byteLength;
+        }
+
+        file.close();
+        written = file.good();
+    }
+    return TemporaryFile::commit(temporaryPath, cookedPath, written);
+}
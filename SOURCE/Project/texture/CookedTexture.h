@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "TextureImage.h"
+
+// Cooked textures are KTX2 files written next to their source, one per role the source is used in:
+// <source>.ktx2 for color and <source>.<role>.ktx2 otherwise. They hold the full mip chain,
+// block-compressed in the role's format unless the cooker was told not to, and record the source
+// they were built from in a key/value entry, so they are rebuilt only when the source content changes.
+class CookedTexture {
+public:
+    static constexpr uint32_t version = 3;
+
+    // Reads the cooked file for sourcePath and role if it exists, was written by this version,
+    // still matches the source and, when blockCompression is false, is not block-compressed.
+    static bool open(const std::string& sourcePath, TextureRole role, bool blockCompression, TextureImage& image);
+    static bool isUpToDate(const std::string& sourcePath, TextureRole role, TextureFormat format);
+    static bool write(const std::string& sourcePath, TextureRole role, const TextureImage& image);
+
+    static std::string getCookedPath(const std::string& sourcePath, TextureRole role);
+};
@@ -14,6 +14,15 @@ Material::Material(const VkDevice& device, const std::vector<std::shared_ptr<Tex
         throw std::runtime_error("Failed to allocate descriptor sets!");
     }
 
+    writeDescriptorSet(device);
+}
+
+void Material::setTextures(const VkDevice& device, const std::vector<std::shared_ptr<Texture>>& textures) {
+    m_pTextures = textures;
+    writeDescriptorSet(device);
+}
+
+void Material::writeDescriptorSet(const VkDevice& device) {
     std::vector<VkWriteDescriptorSet> descriptorWrites;
     descriptorWrites.reserve(m_pTextures.size());
 
@@ -9,10 +9,16 @@ public:
     Material(const VkDevice& device, const std::vector<std::shared_ptr<Texture>>& textures, VkDescriptorSetLayout descriptorSetLayout, VkDescriptorPool descriptorPool);
     ~Material() = default;
 
+    // Points the descriptor set at new textures, e.g. once streamed textures replace placeholders.
+    // The set must not be in use by a command buffer that is still executing.
+    void setTextures(const VkDevice& device, const std::vector<std::shared_ptr<Texture>>& textures);
+
     void cleanup(const VkDevice& device);
     VkDescriptorSet getDescriptorSet() const { return m_DescriptorSet; }
 
 private:
+    void writeDescriptorSet(const VkDevice& device);
+
     std::vector<std::shared_ptr<Texture>> m_pTextures;
     VkDescriptorSet m_DescriptorSet{};
     VkDescriptorSetLayout m_DescriptorSetLayout{};
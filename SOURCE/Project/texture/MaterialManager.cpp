@@ -1,7 +1,7 @@
 #include "MaterialManager.h"
 #include <stdexcept>
 
-void MaterialManager::createMaterialPool(const VkDevice& device, int maxMaterialCount, int maxTexturesPerMaterial) {
+void MaterialManager::createMaterialPool(const VkDevice& device, int maxMaterialCount, int maxTexturesPerMaterial, VkSampler immutableSampler) {
     if (m_DescriptorPool != VK_NULL_HANDLE && m_DescriptorSetLayout != VK_NULL_HANDLE) {
         return;
     }
@@ -15,6 +15,7 @@ void MaterialManager::createMaterialPool(const VkDevice& device, int maxMaterial
         binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         binding.descriptorCount = 1;
         binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        binding.pImmutableSamplers = immutableSampler != VK_NULL_HANDLE ? &immutableSampler : nullptr;
         bindings.push_back(binding);
     }
 
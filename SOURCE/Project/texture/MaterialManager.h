@@ -9,7 +9,9 @@ public:
     MaterialManager() = default;
     ~MaterialManager() = default;
 
-    void createMaterialPool(const VkDevice& device, int maxMaterialCount, int maxTexturesPerMaterial);
+    // With an immutableSampler every binding samples through it, and the sampler in each texture's
+    // descriptor info is ignored.
+    void createMaterialPool(const VkDevice& device, int maxMaterialCount, int maxTexturesPerMaterial, VkSampler immutableSampler = VK_NULL_HANDLE);
     std::shared_ptr<Material> createMaterial(const VkDevice& device, const std::vector<std::shared_ptr<Texture>>& textures);
 
     VkDescriptorSetLayout getMaterialSetLayout() const { return m_DescriptorSetLayout; }
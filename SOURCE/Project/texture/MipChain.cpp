@@ -0,0 +1,94 @@
+#include "MipChain.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    constexpr size_t linearToSrgbTableSize = 4096;
+
+    struct SrgbTables {
+        std::array<float, 256> toLinear{};
+        std::array<uint8_t, linearToSrgbTableSize> toSrgb{};
+
+        SrgbTables() {
+            for (size_t i = 0; i < toLinear.size(); ++i) {
+                float value = static_cast<float>(i) / 255.0f;
+                toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+            for (size_t i = 0; i < toSrgb.size(); ++i) {
+                float value = static_cast<float>(i) / (linearToSrgbTableSize - 1);
+                float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                toSrgb[i] = static_cast<uint8_t>(std::clamp(encoded * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    };
+
+    const SrgbTables& getSrgbTables() {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    void downsample(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination, uint32_t width, uint32_t height, bool srgb) {
+        const SrgbTables& tables = getSrgbTables();
+
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint8_t* row0 = source + static_cast<size_t>(std::min(2 * y, sourceHeight - 1)) * sourceWidth * 4;
+            const uint8_t* row1 = source + static_cast<size_t>(std::min(2 * y + 1, sourceHeight - 1)) * sourceWidth * 4;
+
+            for (uint32_t x = 0; x < width; ++x) {
+                size_t x0 = static_cast<size_t>(std::min(2 * x, sourceWidth - 1)) * 4;
+                size_t x1 = static_cast<size_t>(std::min(2 * x + 1, sourceWidth - 1)) * 4;
+                uint8_t* texel = destination + (static_cast<size_t>(y) * width + x) * 4;
+
+                size_t channel = 0;
+                if (srgb) {
+                    for (; channel < 3; ++channel) {
+                        float sum = tables.toLinear[row0[x0 + channel]] + tables.toLinear[row0[x1 + channel]] +
+                            tables.toLinear[row1[x0 + channel]] + tables.toLinear[row1[x1 + channel]];
+                        texel[channel] = tables.toSrgb[static_cast<size_t>(sum * 0.25f * (linearToSrgbTableSize - 1) + 0.5f)];
+                    }
+                }
+                for (; channel < 4; ++channel) {
+                    texel[channel] = static_cast<uint8_t>((row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel] + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+uint32_t MipChain::getLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levelCount = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+        ++levelCount;
+    }
+    return levelCount;
+}
+
+void MipChain::build(TextureImage& image) {
+    uint32_t levelCount = getLevelCount(image.width, image.height);
+    bool srgb = TextureFormats::isSrgb(image.format);
+
+    image.mipLevels.resize(1);
+    image.mipLevels[0] = { image.width, image.height, 0, static_cast<size_t>(image.width) * image.height * 4 };
+
+    size_t totalSize = 0;
+    for (uint32_t level = 0, width = image.width, height = image.height; level < levelCount; ++level) {
+        totalSize += static_cast<size_t>(width) * height * 4;
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    image.pixels.resize(totalSize);
+
+    for (uint32_t level = 1; level < levelCount; ++level) {
+        const TextureMipLevel& previous = image.mipLevels.back();
+
+        TextureMipLevel mipLevel{};
+        mipLevel.width = std::max(previous.width / 2, 1u);
+        mipLevel.height = std::max(previous.height / 2, 1u);
+        mipLevel.offset = previous.offset + previous.size;
+        mipLevel.size = static_cast<size_t>(mipLevel.width) * mipLevel.height * 4;
+
+        downsample(image.pixels.data() + previous.offset, previous.width, previous.height, image.pixels.data() + mipLevel.offset, mipLevel.width, mipLevel.height, srgb);
+        image.mipLevels.push_back(mipLevel);
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include "TextureImage.h"
+
+namespace MipChain {
+    // Number of levels down to 1x1 for the given base size.
+    uint32_t getLevelCount(uint32_t width, uint32_t height);
+
+    // Replaces the levels below the base level of an uncompressed image with a full chain. Each
+    // level is a 2x2 box filter of the one above it. Color in sRGB images is averaged in linear
+    // space; alpha and the channels of every other image are averaged as stored.
+    void build(TextureImage& image);
+}
@@ -0,0 +1,53 @@
+#include "SamplerCache.h"
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+SamplerCache& SamplerCache::getShared() {
+    static SamplerCache sharedCache;
+    return sharedCache;
+}
+
+bool SamplerCache::isSameSampler(const VkSamplerCreateInfo& a, const VkSamplerCreateInfo& b) {
+    return a.flags == b.flags && a.magFilter == b.magFilter && a.minFilter == b.minFilter && a.mipmapMode == b.mipmapMode &&
+        a.addressModeU == b.addressModeU && a.addressModeV == b.addressModeV && a.addressModeW == b.addressModeW &&
+        a.mipLodBias == b.mipLodBias && a.anisotropyEnable == b.anisotropyEnable && a.maxAnisotropy == b.maxAnisotropy &&
+        a.compareEnable == b.compareEnable && a.compareOp == b.compareOp && a.minLod == b.minLod && a.maxLod == b.maxLod &&
+        a.borderColor == b.borderColor && a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+}
+
+VkSampler SamplerCache::getSampler(const VkDevice& device, const VkSamplerCreateInfo& createInfo) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ++m_RequestCount;
+
+    for (const Entry& entry : m_Entries) {
+        if (entry.device == device && isSameSampler(entry.createInfo, createInfo)) {
+            return entry.sampler;
+        }
+    }
+
+    VkSampler sampler{ VK_NULL_HANDLE };
+    if (vkCreateSampler(device, &createInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create texture sampler!");
+    }
+
+    Entry entry{ device, createInfo, sampler };
+    entry.createInfo.pNext = nullptr;
+    m_Entries.push_back(entry);
+    return sampler;
+}
+
+void SamplerCache::cleanup(const VkDevice& device) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const Entry& entry : m_Entries) {
+        if (entry.device == device) {
+            vkDestroySampler(device, entry.sampler, nullptr);
+        }
+    }
+    m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), [&](const Entry& entry) { return entry.device == device; }), m_Entries.end());
+}
+
+void SamplerCache::printStatistics() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::cout << "Samplers: " << m_Entries.size() << " created for " << m_RequestCount << " requests" << std::endl;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+// Creates one VkSampler per distinct VkSamplerCreateInfo and device and hands the same handle to
+// everyone who asks for those settings, since drivers cap the number of live samplers. Samplers
+// live until cleanup() is called for their device, which has to happen before the device is
+// destroyed. Extension structs chained through pNext are not part of the key and not supported.
+class SamplerCache {
+public:
+    SamplerCache() = default;
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+
+    VkSampler getSampler(const VkDevice& device, const VkSamplerCreateInfo& createInfo);
+
+    // Destroys every sampler created for device; handles handed out before become invalid.
+    void cleanup(const VkDevice& device);
+
+    // Logs how many samplers exist and how many requests they served.
+    void printStatistics() const;
+
+    static SamplerCache& getShared();
+
+private:
+    struct Entry {
+        VkDevice device;
+        VkSamplerCreateInfo createInfo;
+        VkSampler sampler;
+    };
+
+    static bool isSameSampler(const VkSamplerCreateInfo& a, const VkSamplerCreateInfo& b);
+
+    mutable std::mutex m_Mutex;
+    // A handful of samplers at most, so a linear search beats hashing every field.
+    std::vector<Entry> m_Entries;
+    uint32_t m_RequestCount = 0;
+};
@@ -1,52 +1,174 @@
 #include "Texture.h"
 #include <buffers/DataBuffer.h>
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb/stb_image.h"
 #include "CommandPool.h"
+#include "MipChain.h"
+#include "SamplerCache.h"
+#include <algorithm>
 
 Texture::Texture(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const std::string& texturePath)
     : m_Device(device), m_CommandPool(commandPool)
 {
-    createTextureImage(device, physDevice, commandPool, graphicsQueue, texturePath);
+    TextureImage image{};
+    if (!TextureImage::loadFromFile(texturePath, TextureRole::Color, false, image)) {
+        throw std::runtime_error("Failed to load texture image!");
+    }
+    createTextureImage(device, physDevice, commandPool, graphicsQueue, image);
+}
+
+Texture::Texture(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const TextureImage& image)
+    : m_Device(device), m_CommandPool(commandPool)
+{
+    createTextureImage(device, physDevice, commandPool, graphicsQueue, image);
 }
 
 Texture::~Texture() {
     cleanup();
 }
 
-void Texture::createTextureImage(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const std::string& texturePath) {
-    glm::ivec2 imageSize{};
-    int channelCount{};
-
-    stbi_uc* pixelsPtr = stbi_load(texturePath.c_str(), &imageSize.x, &imageSize.y, &channelCount, STBI_rgb_alpha);
-    if (!pixelsPtr) {
-        throw std::runtime_error("Failed to load texture image!");
+void Texture::createTextureImage(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const TextureImage& image) {
+    // Images without their lower levels get a full chain: blitted on the GPU where the format
+    // can be linearly filtered by blits, otherwise box-filtered on the CPU before the upload.
+    // Block-compressed images come with whatever chain they were encoded with.
+    VkFormat format = static_cast<VkFormat>(image.format);
+    uint32_t fullLevelCount = MipChain::getLevelCount(image.width, image.height);
+    bool blitMipLevels = false;
+    TextureImage mipmappedImage{};
+    const TextureImage* pImage = &image;
+    if (image.getMipLevelCount() < fullLevelCount && !TextureFormats::isBlockCompressed(image.format)) {
+        blitMipLevels = supportsLinearBlit(physDevice, format);
+        if (!blitMipLevels) {
+            mipmappedImage = image;
+            MipChain::build(mipmappedImage);
+            pImage = &mipmappedImage;
+        }
     }
 
-    VkDeviceSize imageBufferSize = imageSize.x * imageSize.y * 4;
+    VkDeviceSize imageBufferSize = pImage->getSizeInBytes();
     DataBuffer imageStagingBuffer(physDevice, device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, imageBufferSize);
-    imageStagingBuffer.upload(imageBufferSize, pixelsPtr);
-    stbi_image_free(pixelsPtr);
+    imageStagingBuffer.upload(imageBufferSize, const_cast<uint8_t*>(pImage->pixels.data()));
+
+    m_MipLevels = blitMipLevels ? fullLevelCount : pImage->getMipLevelCount();
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (blitMipLevels ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+    createImage(device, physDevice, image.width, image.height, format, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, m_MipLevels);
 
-    createImage(device, physDevice, imageSize.x, imageSize.y, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory);
+    VkMemoryRequirements memoryRequirements{};
+    vkGetImageMemoryRequirements(device, m_TextureImage, &memoryRequirements);
+    m_GpuMemorySize = memoryRequirements.size;
 
     VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
-    transitionImageLayout(commandBuffer, m_TextureImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    copyBufferToImage(commandBuffer, imageStagingBuffer.getVkBuffer(), m_TextureImage, imageSize.x, imageSize.y);
-    transitionImageLayout(commandBuffer, m_TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    transitionImageLayout(commandBuffer, m_TextureImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
+    copyBufferToImage(commandBuffer, imageStagingBuffer.getVkBuffer(), m_TextureImage, *pImage);
+    if (blitMipLevels) {
+        generateMipLevels(commandBuffer, m_TextureImage, image.width, image.height, m_MipLevels);
+    }
+    else {
+        transitionImageLayout(commandBuffer, m_TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_MipLevels);
+    }
     endSingleTimeCommands(device, commandBuffer, graphicsQueue);
 
-    m_DescriptorImageInfo.imageView = createImageView(device, m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
-    createTextureSampler(device, physDevice, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+    // BC4 only stores red; spread it so masks read the same from every channel as uncompressed ones.
+    VkComponentMapping components{};
+    if (image.format == TextureFormat::Bc4Unorm) {
+        components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE };
+    }
+    m_DescriptorImageInfo.imageView = createImageView(device, m_TextureImage, format, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels, components);
+    m_DescriptorImageInfo.sampler = getSampler(device, physDevice);
     m_DescriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
     imageStagingBuffer.cleanup(device);
 }
 
-void Texture::createTextureSampler(const VkDevice& device, const VkPhysicalDevice& physDevice, VkSamplerAddressMode addressMode) {
+bool Texture::supportsLinearBlit(const VkPhysicalDevice& physDevice, VkFormat format) {
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(physDevice, format, &properties);
+
+    VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
+
+bool Texture::supportsBlockCompression(const VkPhysicalDevice& physDevice) {
+    VkPhysicalDeviceFeatures features{};
+    vkGetPhysicalDeviceFeatures(physDevice, &features);
+    if (!features.textureCompressionBC) {
+        return false;
+    }
+
+    for (TextureRole role : { TextureRole::Color, TextureRole::Normal, TextureRole::Mask }) {
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(physDevice, static_cast<VkFormat>(TextureFormats::getCompressedFormat(role)), &properties);
+
+        VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        if ((properties.optimalTilingFeatures & required) != required) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Texture::generateMipLevels(VkCommandBuffer commandBuffer, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels) {
+    // Every level starts in TRANSFER_DST_OPTIMAL. Each one is turned into a blit source once it
+    // is written, and handed to the fragment shader once the next level has been blitted from it.
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    int32_t levelWidth = static_cast<int32_t>(width);
+    int32_t levelHeight = static_cast<int32_t>(height);
+
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        int32_t nextWidth = std::max(levelWidth / 2, 1);
+        int32_t nextHeight = std::max(levelHeight / 2, 1);
+
+        VkImageBlit blit{};
+        blit.srcOffsets[1] = { levelWidth, levelHeight, 1 };
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = level - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = 1;
+        blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.dstSubresource.mipLevel = level;
+        blit.dstSubresource.baseArrayLayer = 0;
+        blit.dstSubresource.layerCount = 1;
+        vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+VkSampler Texture::getSampler(const VkDevice& device, const VkPhysicalDevice& physDevice, VkSamplerAddressMode addressMode) {
     VkPhysicalDeviceProperties properties{};
     vkGetPhysicalDeviceProperties(physDevice, &properties);
 
+    // maxLod is left unclamped so one sampler serves every mip chain length; the image view
+    // limits the levels.
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.magFilter = VK_FILTER_LINEAR;
@@ -59,10 +181,10 @@ void Texture::createTextureSampler(const VkDevice& device, const VkPhysicalDevic
     samplerInfo.anisotropyEnable = VK_TRUE;
     samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_DescriptorImageInfo.sampler) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create texture sampler!");
-    }
+    return SamplerCache::getShared().getSampler(device, samplerInfo);
 }
 
 VkCommandBuffer Texture::beginSingleTimeCommands(const VkDevice& device, const VkCommandPool& commandPool) {
@@ -97,7 +219,7 @@ void Texture::endSingleTimeCommands(const VkDevice& device, VkCommandBuffer comm
     vkFreeCommandBuffers(device, m_CommandPool, 1, &commandBuffer);
 }
 
-void Texture::transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout) {
+void Texture::transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels) {
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
@@ -107,7 +229,7 @@ void Texture::transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image
     barrier.image = image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = mipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
@@ -133,23 +255,29 @@ void Texture::transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image
     vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 }
 
-void Texture::copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) {
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageExtent = { width, height, 1 };
+void Texture::copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, const TextureImage& textureImage) {
+    std::vector<VkBufferImageCopy> regions;
+    regions.reserve(textureImage.mipLevels.size());
+
+    for (size_t level = 0; level < textureImage.mipLevels.size(); ++level) {
+        const TextureMipLevel& mipLevel = textureImage.mipLevels[level];
 
-    vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        VkBufferImageCopy region{};
+        region.bufferOffset = mipLevel.offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = static_cast<uint32_t>(level);
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { mipLevel.width, mipLevel.height, 1 };
+        regions.push_back(region);
+    }
+
+    vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
 }
 
 void Texture::cleanup() {
-    if (m_DescriptorImageInfo.sampler != VK_NULL_HANDLE) {
-        vkDestroySampler(m_Device, m_DescriptorImageInfo.sampler, nullptr);
-        m_DescriptorImageInfo.sampler = VK_NULL_HANDLE;
-    }
+    // The sampler belongs to the SamplerCache.
+    m_DescriptorImageInfo.sampler = VK_NULL_HANDLE;
 
     if (m_DescriptorImageInfo.imageView != VK_NULL_HANDLE) {
         vkDestroyImageView(m_Device, m_DescriptorImageInfo.imageView, nullptr);
@@ -3,22 +3,34 @@
 #include <string>
 #include <glm/ext/vector_int2.hpp>
 #include <buffers/CommandBuffer.h>
+#include "TextureImage.h"
 
 class Texture {
 public:
     Texture(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const std::string& texturePath);
+    Texture(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const TextureImage& image);
     ~Texture();
 
     void cleanup();
 
     const VkDescriptorImageInfo& getDescriptorInfo() const { return m_DescriptorImageInfo; }
+    VkDeviceSize getGpuMemorySize() const { return m_GpuMemorySize; }
+
+    // Whether the device can sample the BC formats TextureFormats::getCompressedFormat picks.
+    static bool supportsBlockCompression(const VkPhysicalDevice& physDevice);
+
+    // The trilinear, anisotropic sampler every texture uses, shared through SamplerCache. It does
+    // not depend on the image, so it can also be baked into descriptor set layouts.
+    static VkSampler getSampler(const VkDevice& device, const VkPhysicalDevice& physDevice, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT);
 
 private:
-    void createTextureImage(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const std::string& texturePath);
-    void createTextureSampler(const VkDevice& device, const VkPhysicalDevice& physDevice, VkSamplerAddressMode addressMode);
+    void createTextureImage(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue, const TextureImage& image);
+
+    void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
+    void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, const TextureImage& textureImage);
+    void generateMipLevels(VkCommandBuffer commandBuffer, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels);
 
-    void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout);
-    void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+    static bool supportsLinearBlit(const VkPhysicalDevice& physDevice, VkFormat format);
 
     VkCommandBuffer beginSingleTimeCommands(const VkDevice& device, const VkCommandPool& commandPool);
     void endSingleTimeCommands(const VkDevice& device, VkCommandBuffer commandBuffer, VkQueue graphicsQueue);
@@ -26,6 +38,8 @@ private:
     VkDescriptorImageInfo m_DescriptorImageInfo{};
     VkImage m_TextureImage{ VK_NULL_HANDLE };
     VkDeviceMemory m_TextureImageMemory{ VK_NULL_HANDLE };
+    uint32_t m_MipLevels = 1;
+    VkDeviceSize m_GpuMemorySize = 0;
 
     VkDevice m_Device;
     VkCommandPool m_CommandPool;
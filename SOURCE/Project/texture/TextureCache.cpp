@@ -0,0 +1,101 @@
+#include "TextureCache.h"
+#include <filesystem>
+#include <iostream>
+
+void TextureCache::initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue) {
+    m_Device = device;
+    m_PhysDevice = physDevice;
+    m_CommandPool = commandPool;
+    m_GraphicsQueue = graphicsQueue;
+}
+
+std::string TextureCache::getKey(const std::string& path, TextureRole role, bool blockCompression) {
+    std::error_code error;
+    std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(path, error);
+    if (error) {
+        canonicalPath = std::filesystem::path(path).lexically_normal();
+    }
+    return canonicalPath.generic_string() + '#' + TextureFormats::getRoleName(role) + (blockCompression ? "#bc" : "");
+}
+
+std::shared_ptr<Texture> TextureCache::findTexture(const std::string& key) {
+    auto it = m_Textures.find(key);
+    if (it == m_Textures.end()) {
+        return nullptr;
+    }
+
+    auto texture = it->second.lock();
+    if (!texture) {
+        m_Textures.erase(it);
+        return nullptr;
+    }
+    ++m_HitCount;
+    m_SavedBytes += texture->getGpuMemorySize();
+    return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::findContent(const TextureContent& content) {
+    auto range = m_ContentTextures.equal_range(content.hash);
+    for (auto it = range.first; it != range.second;) {
+        auto texture = it->second.texture.lock();
+        if (!texture) {
+            it = m_ContentTextures.erase(it);
+            continue;
+        }
+
+        if (it->second.content.matches(content)) {
+            ++m_ContentHitCount;
+            m_SavedBytes += texture->getGpuMemorySize();
+            return texture;
+        }
+        ++it;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Texture> TextureCache::load(const std::string& path, TextureRole role, bool blockCompression) {
+    std::string key = getKey(path, role, blockCompression);
+    if (auto texture = findTexture(key)) {
+        return texture;
+    }
+
+    TextureImage image{};
+    if (!TextureImage::loadFromFile(path, role, blockCompression, image)) {
+        return nullptr;
+    }
+    return createTexture(key, image);
+}
+
+std::shared_ptr<Texture> TextureCache::add(const std::string& path, TextureRole role, bool blockCompression, const TextureImage& image) {
+    std::string key = getKey(path, role, blockCompression);
+    if (auto texture = findTexture(key)) {
+        return texture;
+    }
+    return createTexture(key, image);
+}
+
+std::shared_ptr<Texture> TextureCache::createTexture(const std::string& key, const TextureImage& image) {
+    TextureContent content{};
+    if (m_ContentHashing) {
+        content = TextureContent::describe(image);
+        if (auto texture = findContent(content)) {
+            m_Textures[key] = texture;
+            return texture;
+        }
+    }
+
+    auto texture = std::make_shared<Texture>(m_Device, m_PhysDevice, m_CommandPool, m_GraphicsQueue, image);
+    m_Textures[key] = texture;
+    if (m_ContentHashing) {
+        m_ContentTextures.emplace(content.hash, ContentEntry{ texture, content });
+    }
+
+    ++m_CreateCount;
+    m_UploadedBytes += texture->getGpuMemorySize();
+    return texture;
+}
+
+void TextureCache::printStatistics() const {
+    std::cout << "Textures: " << m_CreateCount << " created (" << m_UploadedBytes / 1024.0 << " KiB on the GPU), " << m_HitCount + m_ContentHitCount
+        << " requests shared one (" << m_ContentHitCount << " by content), saving " << m_SavedBytes / 1024.0 << " KiB of GPU memory" << std::endl;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Texture.h"
+#include "TextureContent.h"
+
+// Creates each texture once per source and decode parameters and hands out shared references to
+// it. Sources are keyed by their canonical path, so "models/a.png" and "models/../models/a.png"
+// share a texture. Entries are weak, so a texture is destroyed as soon as no material uses it
+// anymore and is created again on the next request. With content hashing turned on, images whose
+// TextureContent matches a live texture share it too, whatever path they came from.
+class TextureCache {
+public:
+    void initialize(const VkDevice& device, const VkPhysicalDevice& physDevice, const VkCommandPool& commandPool, const VkQueue& graphicsQueue);
+
+    // Hashing costs two passes over every new image, so it is off unless sources are expected to
+    // repeat under different names.
+    void setContentHashing(bool contentHashing) { m_ContentHashing = contentHashing; }
+
+    // Returns nullptr if the image cannot be loaded.
+    std::shared_ptr<Texture> load(const std::string& path, TextureRole role, bool blockCompression);
+
+    // Uploads an image that was loaded elsewhere, e.g. by an AssetLoader worker, unless a texture
+    // for the same source and parameters is still alive.
+    std::shared_ptr<Texture> add(const std::string& path, TextureRole role, bool blockCompression, const TextureImage& image);
+
+    // Logs how many requests were served from the cache and the GPU memory that saved compared to
+    // creating a texture for every request.
+    void printStatistics() const;
+
+private:
+    static std::string getKey(const std::string& path, TextureRole role, bool blockCompression);
+    struct ContentEntry {
+        std::weak_ptr<Texture> texture;
+        TextureContent content;
+    };
+
+    std::shared_ptr<Texture> findTexture(const std::string& key);
+    std::shared_ptr<Texture> findContent(const TextureContent& content);
+    std::shared_ptr<Texture> createTexture(const std::string& key, const TextureImage& image);
+
+    VkDevice m_Device{};
+    VkPhysicalDevice m_PhysDevice{};
+    VkCommandPool m_CommandPool{};
+    VkQueue m_GraphicsQueue{};
+    bool m_ContentHashing = false;
+
+    std::unordered_map<std::string, std::weak_ptr<Texture>> m_Textures;
+    // Keyed by TextureContent::hash; several entries can share one if their contents differ.
+    std::unordered_multimap<uint64_t, ContentEntry> m_ContentTextures;
+
+    uint32_t m_CreateCount = 0;
+    uint32_t m_HitCount = 0;
+    uint32_t m_ContentHitCount = 0;
+    VkDeviceSize m_UploadedBytes = 0;
+    VkDeviceSize m_SavedBytes = 0;
+};
@@ -0,0 +1,36 @@
+#include "TextureContent.h"
+#include <io/ContentHash.h>
+#include <cstring>
+
+// The second hash mixes every word with its position and sums the results instead of chaining them
+// like hashBytes, so bytes that collide in one are not expected to collide in the other.
+TextureContent TextureContent::describe(const TextureImage& image) {
+    TextureContent content{};
+    content.width = image.width;
+    content.height = image.height;
+    content.format = image.format;
+    content.mipLevelCount = image.getMipLevelCount();
+    content.size = image.pixels.size();
+
+    uint64_t seed = ContentHash::mix((static_cast<uint64_t>(image.width) << 32) | image.height) ^ static_cast<uint64_t>(image.format);
+    content.hash = ContentHash::hashBytes(image.pixels.data(), image.pixels.size(), seed);
+
+    const uint8_t* bytes = image.pixels.data();
+    uint64_t verificationHash = 0;
+    size_t offset = 0;
+    for (; offset + 8 <= content.size; offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, sizeof(word));
+        verificationHash += ContentHash::mix(word ^ ContentHash::mix(offset + 1));
+    }
+    for (; offset < content.size; ++offset) {
+        verificationHash += ContentHash::mix(bytes[offset] ^ ContentHash::mix(offset + 1));
+    }
+    content.verificationHash = verificationHash;
+    return content;
+}
+
+bool TextureContent::matches(const TextureContent& other) const {
+    return width == other.width && height == other.height && format == other.format && mipLevelCount == other.mipLevelCount &&
+        size == other.size && hash == other.hash && verificationHash == other.verificationHash;
+}
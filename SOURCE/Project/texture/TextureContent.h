@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "TextureImage.h"
+
+// Identifies an image's contents whatever path it came from: its size, format and mip count plus
+// two independent hashes of its bytes. hash keys lookups; two images are only the same content when
+// every field matches, so a collision in hash alone never shares a texture.
+struct TextureContent {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    TextureFormat format = TextureFormat::R8G8B8A8Srgb;
+    uint32_t mipLevelCount = 0;
+    size_t size = 0;
+    uint64_t hash = 0;
+    uint64_t verificationHash = 0;
+
+    // Two passes over the bytes.
+    static TextureContent describe(const TextureImage& image);
+    bool matches(const TextureContent& other) const;
+};
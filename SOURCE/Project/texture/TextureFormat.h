@@ -0,0 +1,117 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cctype>
+
+// The formats textures are stored and uploaded in. The values are the matching VkFormat values, so
+// they can be written to KTX2 headers and handed to Vulkan as they are.
+enum class TextureFormat : uint32_t {
+    R8G8B8A8Unorm = 37,
+    R8G8B8A8Srgb = 43,
+    Bc1RgbSrgb = 132,
+    Bc4Unorm = 139,
+    Bc5Unorm = 141,
+    Bc7Unorm = 145,
+    Bc7Srgb = 146,
+};
+
+// What a texture holds, which decides its format: color is stored as sRGB, normals keep only X and Y
+// and masks such as gloss or specular keep only their first channel unless the source has color.
+enum class TextureRole : uint32_t {
+    Color,
+    Normal,
+    Mask,
+};
+
+namespace TextureFormats {
+    inline bool isBlockCompressed(TextureFormat format) {
+        return format != TextureFormat::R8G8B8A8Unorm && format != TextureFormat::R8G8B8A8Srgb;
+    }
+
+    // Bytes per 4x4 block for block-compressed formats, bytes per texel otherwise.
+    inline size_t getBlockSize(TextureFormat format) {
+        switch (format) {
+        case TextureFormat::Bc1RgbSrgb:
+        case TextureFormat::Bc4Unorm:
+            return 8;
+        case TextureFormat::Bc5Unorm:
+        case TextureFormat::Bc7Unorm:
+        case TextureFormat::Bc7Srgb:
+            return 16;
+        default:
+            return 4;
+        }
+    }
+
+    inline size_t getLevelSize(TextureFormat format, uint32_t width, uint32_t height) {
+        if (!isBlockCompressed(format)) {
+            return static_cast<size_t>(width) * height * 4;
+        }
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+    }
+
+    inline bool isSrgb(TextureFormat format) {
+        return format == TextureFormat::R8G8B8A8Srgb || format == TextureFormat::Bc1RgbSrgb || format == TextureFormat::Bc7Srgb;
+    }
+
+    inline TextureFormat getUncompressedFormat(TextureRole role) {
+        return role == TextureRole::Color ? TextureFormat::R8G8B8A8Srgb : TextureFormat::R8G8B8A8Unorm;
+    }
+
+    inline TextureFormat getCompressedFormat(TextureRole role) {
+        switch (role) {
+        case TextureRole::Normal:
+            return TextureFormat::Bc5Unorm;
+        case TextureRole::Mask:
+            return TextureFormat::Bc4Unorm;
+        default:
+            return TextureFormat::Bc7Srgb;
+        }
+    }
+
+    // BC4 keeps only red, which would lose a mask source that has color, such as a colored specular
+    // map. Those are compressed to linear BC7 instead. Other formats keep every channel they need.
+    inline TextureFormat getColorFallback(TextureFormat format) {
+        return format == TextureFormat::Bc4Unorm ? TextureFormat::Bc7Unorm : format;
+    }
+
+    inline bool isUsableAs(TextureFormat format, TextureRole role) {
+        switch (role) {
+        case TextureRole::Normal:
+            return format == TextureFormat::R8G8B8A8Unorm || format == TextureFormat::Bc5Unorm;
+        case TextureRole::Mask:
+            return format == TextureFormat::R8G8B8A8Unorm || format == TextureFormat::Bc4Unorm || format == TextureFormat::Bc7Unorm;
+        default:
+            return format == TextureFormat::R8G8B8A8Srgb || format == TextureFormat::Bc1RgbSrgb || format == TextureFormat::Bc7Srgb;
+        }
+    }
+
+    inline const char* getRoleName(TextureRole role) {
+        switch (role) {
+        case TextureRole::Normal:
+            return "normal";
+        case TextureRole::Mask:
+            return "mask";
+        default:
+            return "color";
+        }
+    }
+
+    // Guesses the role from the file name, e.g. "Bricks_normal_small.png" or "vehicle_gloss.png",
+    // for tools that see textures without their materials.
+    inline TextureRole guessRole(const std::string& path) {
+        std::string name = path.substr(path.find_last_of("/\\") + 1);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (name.find("normal") != std::string::npos) {
+            return TextureRole::Normal;
+        }
+        for (const char* maskName : { "gloss", "specular", "roughness", "metallic", "occlusion" }) {
+            if (name.find(maskName) != std::string::npos) {
+                return TextureRole::Mask;
+            }
+        }
+        return TextureRole::Color;
+    }
+}
@@ -0,0 +1,91 @@
+#include "TextureImage.h"
+#include "CookedTexture.h"
+#include "MipChain.h"
+#include "BlockEncoder.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb/stb_image.h"
+#include <io/AssetPack.h>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+bool TextureImage::loadFromFile(const std::string& path, TextureRole role, bool blockCompression, TextureImage& image, TextureLoadStats* pStats) {
+    TextureLoadStats localStats{};
+    TextureLoadStats& stats = pStats ? *pStats : localStats;
+    stats = {};
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (CookedTexture::open(path, role, blockCompression, image)) {
+        stats.cooked = true;
+        stats.decodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        return true;
+    }
+    bool decoded = decodeFile(path, image, role);
+    auto encodeStartTime = std::chrono::high_resolution_clock::now();
+    stats.decodeMilliseconds = std::chrono::duration<double, std::milli>(encodeStartTime - startTime).count();
+    if (!decoded || !blockCompression) {
+        return decoded;
+    }
+
+    TextureFormat format = TextureFormats::getCompressedFormat(role);
+    if (TextureFormats::getColorFallback(format) != format && !image.isGrayscale()) {
+        format = TextureFormats::getColorFallback(format);
+    }
+
+    MipChain::build(image);
+    TextureImage compressed{};
+    BlockEncoder::encode(image, format, compressed);
+    image = std::move(compressed);
+
+    if (!CookedTexture::write(path, role, image)) {
+        std::cerr << "Could not write cooked texture for " << path << ", it will be compressed again on the next load" << std::endl;
+    }
+    stats.encodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - encodeStartTime).count();
+    return true;
+}
+
+bool TextureImage::decodeFile(const std::string& path, TextureImage& image, TextureRole role) {
+    AssetFile file;
+    return file.open(path) && decodeMemory(file.getData(), file.getSize(), image, role);
+}
+
+bool TextureImage::decodeMemory(const void* pData, size_t size, TextureImage& image, TextureRole role) {
+    int width{};
+    int height{};
+    int channelCount{};
+
+    stbi_uc* pixelsPtr = stbi_load_from_memory(static_cast<const stbi_uc*>(pData), static_cast<int>(size), &width, &height, &channelCount, STBI_rgb_alpha);
+    if (!pixelsPtr) {
+        return false;
+    }
+
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.format = TextureFormats::getUncompressedFormat(role);
+    image.pixels.assign(pixelsPtr, pixelsPtr + static_cast<size_t>(width) * height * 4);
+    image.mipLevels = { { image.width, image.height, 0, image.pixels.size() } };
+    stbi_image_free(pixelsPtr);
+    return true;
+}
+
+bool TextureImage::isGrayscale() const {
+    constexpr int tolerance = 8;
+    size_t size = mipLevels.empty() ? pixels.size() : std::min(pixels.size(), mipLevels[0].size);
+    for (size_t i = 0; i + 4 <= size; i += 4) {
+        if (std::abs(pixels[i] - pixels[i + 1]) > tolerance || std::abs(pixels[i] - pixels[i + 2]) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TextureImage TextureImage::createSolidColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a, TextureFormat format) {
+    TextureImage image{};
+    image.width = 1;
+    image.height = 1;
+    image.format = format;
+    image.pixels = { r, g, b, a };
+    image.mipLevels = { { 1, 1, 0, 4 } };
+    return image;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "TextureFormat.h"
+
+struct TextureMipLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+struct TextureLoadStats {
+    // Whether the image came from an up-to-date cooked KTX2 file rather than its source.
+    bool cooked = false;
+    // Reading the cooked file, or reading and decoding the source PNG or JPEG.
+    double decodeMilliseconds = 0.0;
+    // Building the mip chain and block-compressing it when no cooked file could be used.
+    double encodeMilliseconds = 0.0;
+};
+
+// Decoded pixels or compressed blocks in format, ready to be copied into a staging buffer. Decoding
+// touches no Vulkan state, so it can run on any thread. pixels holds every mip level back to back,
+// largest first.
+struct TextureImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    TextureFormat format = TextureFormat::R8G8B8A8Srgb;
+    std::vector<uint8_t> pixels;
+    std::vector<TextureMipLevel> mipLevels;
+
+    size_t getSizeInBytes() const { return pixels.size(); }
+    uint32_t getMipLevelCount() const { return static_cast<uint32_t>(mipLevels.size()); }
+    // Whether red, green and blue are within a few levels of each other in every texel of the first
+    // level, which allows for the noise of a gray image saved as RGB. Only meaningful for
+    // uncompressed images.
+    bool isGrayscale() const;
+
+    // Loads the cooked KTX2 file for path and role when it is up to date and, if blockCompression
+    // is false, not block-compressed. Otherwise decodes path itself: with
+    // blockCompression the result is given a mip chain, compressed for its role and written back
+    // as the cooked file so the next load is cheap; without it the image is uncompressed with a
+    // single level. Returns false and leaves the image empty if neither can be read.
+    static bool loadFromFile(const std::string& path, TextureRole role, bool blockCompression, TextureImage& image, TextureLoadStats* pStats = nullptr);
+    // Decodes path into a single RGBA8 level in the uncompressed format for role.
+    static bool decodeFile(const std::string& path, TextureImage& image, TextureRole role = TextureRole::Color);
+    // Decodes an encoded PNG or JPEG held in memory, e.g. an image embedded in a GLB.
+    static bool decodeMemory(const void* pData, size_t size, TextureImage& image, TextureRole role = TextureRole::Color);
+    static TextureImage createSolidColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255, TextureFormat format = TextureFormat::R8G8B8A8Srgb);
+};
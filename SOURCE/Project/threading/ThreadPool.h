@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency()));
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename Function>
+    auto enqueue(Function&& function) -> std::future<std::invoke_result_t<std::decay_t<Function>>>;
+
+    // Runs function(begin, end) over [0, count) split into at most one range per worker and blocks
+    // until every range is done. The caller and the workers claim ranges from a shared counter, so
+    // the caller only ever runs this call's ranges and never waits for one nobody has started; that
+    // keeps it safe to call from inside a pool task. If any range throws, the first exception is
+    // rethrown once all ranges have finished.
+    template <typename Function>
+    void parallelFor(size_t count, size_t minRangeSize, Function&& function);
+
+    size_t getThreadCount() const { return m_Workers.size(); }
+
+    static ThreadPool& getShared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_Workers;
+    std::queue<std::function<void()>> m_Tasks;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Stopping = false;
+};
+
+template <typename Function>
+auto ThreadPool::enqueue(Function&& function) -> std::future<std::invoke_result_t<std::decay_t<Function>>> {
+    using Result = std::invoke_result_t<std::decay_t<Function>>;
+
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    std::future<Result> future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tasks.emplace([task]() { (*task)(); });
+    }
+    m_Condition.notify_one();
+    return future;
+}
+
+template <typename Function>
+void ThreadPool::parallelFor(size_t count, size_t minRangeSize, Function&& function) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t rangeCount = std::min(getThreadCount(), (count + std::max<size_t>(minRangeSize, 1) - 1) / std::max<size_t>(minRangeSize, 1));
+    if (rangeCount <= 1) {
+        function(size_t{ 0 }, count);
+        return;
+    }
+    size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+    rangeCount = (count + rangeSize - 1) / rangeSize;
+
+    // Shared with the helper tasks, which may only get to run after this call has returned. By
+    // then every range is claimed, so they leave without touching function.
+    struct Ranges {
+        std::atomic<size_t> next{ 0 };
+        size_t finishedCount = 0;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+    auto pRanges = std::make_shared<Ranges>();
+    auto* pFunction = &function;
+
+    auto runRanges = [pRanges, pFunction, rangeCount, rangeSize, count]() {
+        for (size_t range = pRanges->next++; range < rangeCount; range = pRanges->next++) {
+            std::exception_ptr exception;
+            try {
+                (*pFunction)(range * rangeSize, std::min((range + 1) * rangeSize, count));
+            }
+            catch (...) {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(pRanges->mutex);
+            if (exception && !pRanges->exception) {
+                pRanges->exception = exception;
+            }
+            if (++pRanges->finishedCount == rangeCount) {
+                pRanges->condition.notify_all();
+            }
+        }
+    };
+    auto waitForRanges = [&]() {
+        runRanges();
+        std::unique_lock<std::mutex> lock(pRanges->mutex);
+        pRanges->condition.wait(lock, [&]() { return pRanges->finishedCount == rangeCount; });
+    };
+
+    try {
+        for (size_t helper = 1; helper < rangeCount; ++helper) {
+            enqueue(runRanges);
+        }
+    }
+    catch (...) {
+        waitForRanges();
+        throw;
+    }
+
+    waitForRanges();
+    if (pRanges->exception) {
+        std::rethrow_exception(pRanges->exception);
+    }
+}
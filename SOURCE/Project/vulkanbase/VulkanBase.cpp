@@ -43,7 +43,7 @@ void VulkanBase::initVulkan() {
     m_CommandPool.initialize(m_Device, findQueueFamilies(m_DeviceManager.getPhysicalDevice(), m_Surface));
     m_CommandBuffer = m_CommandPool.createCommandBuffer(m_Device);
 
-    m_MaterialManager.createMaterialPool(m_Device, 4, 4);
+    m_MaterialManager.createMaterialPool(m_Device, 4, 4, Texture::getSampler(m_Device, m_DeviceManager.getPhysicalDevice()));
 
     m_GraphicsPipeline2D.initialize(m_Device, m_DeviceManager.getPhysicalDevice(), m_SwapChain, m_RenderPass, sizeof(UniformBufferObject2D));
     m_MyScene2D.createScene(m_Device, m_DeviceManager.getPhysicalDevice(), m_CommandPool.getCommandPool(), findQueueFamilies(m_DeviceManager.getPhysicalDevice(), m_Surface), m_DeviceManager.getGraphicsQueue(), m_MaterialManager);
@@ -54,8 +54,10 @@ void VulkanBase::initVulkan() {
     m_GraphicsPipeline3D.createGraphicsPipeline<Vertex3D>(m_Device, m_SwapChain, sizeof(PushConstants));
 
     m_GraphicsPipeline3D_PBR.initialize(m_Device, m_DeviceManager.getPhysicalDevice(), m_SwapChain, m_RenderPass, sizeof(UniformBufferObject3D_PBR));
+    auto sceneStartTime = std::chrono::high_resolution_clock::now();
     m_MyScene3D_PBR.createScene(m_Device, m_DeviceManager.getPhysicalDevice(), m_CommandPool.getCommandPool(), findQueueFamilies(m_DeviceManager.getPhysicalDevice(), m_Surface), m_DeviceManager.getGraphicsQueue(), m_MaterialManager);
-    m_GraphicsPipeline3D_PBR.createGraphicsPipeline<Vertex3D_PBR>(m_Device, m_SwapChain, sizeof(PushConstantsPBR), m_MaterialManager.getMaterialSetLayout());
+    std::cout << "Scene3D_PBR created in " << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - sceneStartTime).count() << " ms" << std::endl;
+    m_GraphicsPipeline3D_PBR.createGraphicsPipeline<Vertex3D_PBR_Compact>(m_Device, m_SwapChain, sizeof(PushConstantsPBR), m_MaterialManager.getMaterialSetLayout());
 
     createFrameBuffers();
     createSyncObjects();
@@ -89,6 +91,7 @@ void VulkanBase::cleanup() {
     m_GraphicsPipeline3D_PBR.cleanup(m_Device);
 
     m_MaterialManager.cleanup(m_Device);
+    SamplerCache::getShared().cleanup(m_Device);
 
     if (enableValidationLayers) {
         destroyDebugUtilsMessengerEXT(m_Instance, m_DebugMessenger, nullptr);
@@ -25,6 +25,7 @@
 #include <GraphicsPipeline.h>
 #include <Camera.h>
 #include "texture/MaterialManager.h"
+#include "texture/SamplerCache.h"
 #include "scenes/SceneBase.h"
 #include "scenes/Scene2D.h"
 #include "scenes/Scene3D.h"
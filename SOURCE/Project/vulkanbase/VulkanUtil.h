@@ -61,6 +61,8 @@ struct UniformBufferObject3D_PBR {
 
 struct PushConstantsPBR {
     glm::mat4 model;
+    glm::vec4 positionScale;
+    glm::vec4 positionBias;
     int renderMode;
 };
 
@@ -74,9 +76,9 @@ void destroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT
 std::vector<char> readFile(const std::string& filename);
 
 void createImage(const VkDevice& device, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
-    VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
+    VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, uint32_t mipLevels = 1);
 
-VkImageView createImageView(const VkDevice& device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+VkImageView createImageView(const VkDevice& device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1, VkComponentMapping components = {});
 
 VkFormat findDepthFormat(VkPhysicalDevice physicalDevice);
 VkFormat findSupportedFormat(VkPhysicalDevice physicalDevice, const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);